@@ -540,6 +540,8 @@ int main(int argc, char **argv)
 		cuda_debug_sync = find_arg(argc, argv, "-cuda_debug_sync");
 #endif
 
+		Darknet::configure_thread_placement();
+
 		errno = 0;
 
 		/// @todo V3 look through these and see what we no longer need
@@ -548,6 +550,10 @@ int main(int argc, char **argv)
 		/// @todo V3 "3d" seems to combine 2 images into a single alpha-blended composite.  It works...but does it belong in Darknet?  What is this for?
 		else if (cfg_and_state.command == "3d")				{ Darknet::composite_3d(argv[2], argv[3], argv[4], (argc > 5) ? atof(argv[5]) : 0); }
 		else if (cfg_and_state.command == "average")		{ average			(argc, argv);	}
+		else if (cfg_and_state.command == "benchmarkaugment")	{ Darknet::benchmark_augmentation();	}
+		else if (cfg_and_state.command == "benchmarkgemm")	{ Darknet::benchmark_gemm();		}
+		else if (cfg_and_state.command == "benchmarknms")	{ Darknet::benchmark_nms();			}
+		else if (cfg_and_state.command == "benchmarkyolo")	{ Darknet::benchmark_yolo();		}
 		else if (cfg_and_state.command == "cfglayers")		{ Darknet::cfg_layers();			}
 		else if (cfg_and_state.command == "denormalize")	{ denormalize_net	(argv[2], argv[3], argv[4]); }
 		else if (cfg_and_state.command == "detector")		{ run_detector		(argc, argv);	}
@@ -560,6 +566,8 @@ int main(int argc, char **argv)
 		else if (cfg_and_state.command == "rescale")		{ rescale_net		(argv[2], argv[3], argv[4]); }
 		else if (cfg_and_state.command == "reset")			{ reset_normalize_net(argv[2], argv[3], argv[4]); }
 		else if (cfg_and_state.command == "rgbgr")			{ rgbgr_net			(argv[2], argv[3], argv[4]); }
+		else if (cfg_and_state.command == "serve")			{ Darknet::serve(cfg_and_state.cfg_filename, cfg_and_state.names_filename, cfg_and_state.weights_filename); }
+		else if (cfg_and_state.command == "serveclient")	{ Darknet::serve_client(cfg_and_state.filenames);	}
 		else if (cfg_and_state.command == "speed")			{ speed				(cfg_and_state.cfg_filename.string().c_str(), 0); }
 		else if (cfg_and_state.command == "statistics")		{ statistics_net	(cfg_and_state.cfg_filename.string().c_str(), cfg_and_state.weights_filename.string().c_str()); }
 		else if (cfg_and_state.command == "test")			{ Darknet::test_resize(argv[2]);	} ///< @todo V3 what is this?
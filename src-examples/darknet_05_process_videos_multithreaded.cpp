@@ -5,6 +5,10 @@
 #include "darknet.hpp"
 #include "darknet_image.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <set>
 #include <thread>
 
@@ -49,14 +53,15 @@ struct Frame
 };
 
 
-bool				all_threads_must_exit	= false;	///< if something goes wrong, this flag gets set to @p true
-Darknet::NetworkPtr	net						= nullptr;	///< Darknet/YOLO neural network pointer
+std::atomic<bool>	all_threads_must_exit	= false;	///< if something goes wrong, this flag gets set to @p true
+std::unique_ptr<Darknet::NetworkPool> pool;				///< Darknet/YOLO neural networks, one for each detection thread
 cv::Size			network_dimensions;					///< dimensions of the neural network that was loaded
 std::set<Frame>		frames_waiting_for_resize;			///< once a frame is read from the video, it is stored here
 std::set<Frame>		frames_waiting_for_prediction;		///< once a frame has been resized, it is stored here
 std::set<Frame>		frames_waiting_for_output;			///< once a frame has been predicted, it is stored here
 std::mutex			waiting_for_resize;					///< mutex to protect access to @ref frames_waiting_for_resize
 std::mutex			waiting_for_prediction;				///< mutex to protect access to @ref frames_waiting_for_prediction
+std::condition_variable prediction_available;			///< signals the detection threads when a frame is added to @ref frames_waiting_for_prediction
 std::mutex			waiting_for_output;					///< mutex to protect access to @ref frames_waiting_for_output
 std::chrono::high_resolution_clock::duration wait_threads_duration;	///< amount of time spent waiting for other threads to finish running
 std::chrono::high_resolution_clock::duration reader_work_duration;	///< amount of time spent reading frames
@@ -65,7 +70,7 @@ std::chrono::high_resolution_clock::duration predict_work_duration;	///< amount
 std::chrono::high_resolution_clock::duration output_work_duration;	///< amount of time spent on the output video
 size_t				reader_must_pause		= 0;
 size_t				resize_thread_starved	= 0;
-size_t				predict_thread_starved	= 0;
+std::atomic<size_t>	predict_thread_starved	= 0;	///< atomic since several detection threads are running
 size_t				output_thread_starved	= 0;
 size_t				waiting_for_threads		= 0;
 size_t				expected_next_index		= 0; ///< keep track of which frame has been written to disk
@@ -112,6 +117,7 @@ void resize_thread()
 				std::scoped_lock lock(waiting_for_prediction);
 				frames_waiting_for_prediction.insert(frame);
 			}
+			prediction_available.notify_one();
 
 			const auto timestamp_end = std::chrono::high_resolution_clock::now();
 			resize_work_duration += timestamp_end - timestamp_begin;
@@ -133,34 +139,41 @@ void detection_thread(size_t & total_objects_found)
 	{
 		while (all_threads_must_exit == false)
 		{
-			if (frames_waiting_for_prediction.empty())
-			{
-				predict_thread_starved ++;
-				std::this_thread::sleep_for(std::chrono::milliseconds(1));
-				continue;
-			}
-
-			// if we get here we know we have at least 1 frame where we can call predict()
 			const auto timestamp_begin = std::chrono::high_resolution_clock::now();
 
+			// several detection threads are running, so another thread may have taken the last frame
 			Frame frame;
 			if (true)
 			{
-				std::scoped_lock lock(waiting_for_prediction);
+				std::unique_lock lock(waiting_for_prediction);
+				if (frames_waiting_for_prediction.empty())
+				{
+					predict_thread_starved ++;
+
+					// sleep until the resize thread has a frame for us; the timeout is only to notice when we need to exit
+					prediction_available.wait_for(lock, std::chrono::milliseconds(100), []() { return all_threads_must_exit or not frames_waiting_for_prediction.empty(); });
+					if (frames_waiting_for_prediction.empty())
+					{
+						continue;
+					}
+				}
+
 				auto iter = frames_waiting_for_prediction.begin();
 				frame = *iter;
 				frames_waiting_for_prediction.erase(iter);
 			}
 
+			// each detection thread needs a different network, but they all share the same weights
+			auto net = pool->acquire();
 			frame.predictions = Darknet::predict(net, frame.img, frame.mat.size());
 			Darknet::annotate(net, frame.predictions, frame.mat);
 
-			total_objects_found += frame.predictions.size();
-
-			// in case multiple resize threads are running, we have no idea in which order the frames have been processed,
-			// so pass them to another thread which will ensure the frames are re-ordered before creating the output video
+			// in case multiple resize and detection threads are running, we have no idea in which order the frames have
+			// been processed, so pass them to another thread which will ensure the frames are re-ordered before creating
+			// the output video
 			std::scoped_lock lock(waiting_for_output);
 			frames_waiting_for_output.insert(frame);
+			total_objects_found += frame.predictions.size();
 
 			const auto timestamp_end = std::chrono::high_resolution_clock::now();
 			predict_work_duration += timestamp_end - timestamp_begin;
@@ -237,7 +250,7 @@ int main(int argc, char * argv[])
 	try
 	{
 		Darknet::Parms parms = Darknet::parse_arguments(argc, argv);
-		net = Darknet::load_neural_network(parms);
+		Darknet::NetworkPtr net = Darknet::load_neural_network(parms);
 //		Darknet::set_annotation_line_type(net, cv::LineTypes::LINE_AA);
 
 		int network_width = 0;
@@ -246,6 +259,10 @@ int main(int argc, char * argv[])
 		Darknet::network_dimensions(net, network_width, network_height, network_channels);
 		network_dimensions = cv::Size(network_width, network_height);
 
+		// the other threads don't do much work, so use approximately 1/4 of the CPUs to run detection
+		const size_t detection_threads = std::clamp(std::thread::hardware_concurrency() / 4, 1u, 8u);
+		pool = std::make_unique<Darknet::NetworkPool>(net, detection_threads);
+
 		std::vector<std::thread> threads;
 
 		for (const auto & parm : parms)
@@ -311,7 +328,10 @@ int main(int argc, char * argv[])
 			// start all the threads we'll need -- the "main" thread will take care of task #1 (reading)
 			all_threads_must_exit = false;
 			threads.emplace_back(resize_thread);									// task #2
-			threads.emplace_back(detection_thread, std::ref(total_objects_found));	// task #3
+			for (size_t idx = 0; idx < detection_threads; idx ++)
+			{
+				threads.emplace_back(detection_thread, std::ref(total_objects_found));	// task #3
+			}
 			threads.emplace_back(output_thread, std::ref(out));						// task #4
 
 			std::cout
@@ -378,6 +398,7 @@ int main(int argc, char * argv[])
 			}
 			wait_threads_duration = std::chrono::high_resolution_clock::now() - begin_waiting;
 			all_threads_must_exit = true;
+			prediction_available.notify_all();
 
 			const auto timestamp_when_video_ended = std::chrono::high_resolution_clock::now();
 			const auto processing_duration = timestamp_when_video_ended - timestamp_when_video_started;
@@ -413,7 +434,7 @@ int main(int argc, char * argv[])
 			threads.clear();
 		}
 
-		Darknet::free_neural_network(net);
+		pool.reset();
 	}
 	catch (const std::exception & e)
 	{
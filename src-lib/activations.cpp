@@ -174,17 +174,6 @@ void activate_array_mish(float *x, const int n, float * activation_input, float
 	}
 }
 
-static float hard_mish_yashas(float x)
-{
-	TAT(TATPARMS);
-
-	if (x > 0)
-		return x;
-	if (x > -2)
-		return x * x / 2 + x;
-	return 0;
-}
-
 void activate_array_hard_mish(float *x, const int n, float * activation_input, float * output)
 {
 	TAT(TATPARMS);
@@ -194,7 +183,7 @@ void activate_array_hard_mish(float *x, const int n, float * activation_input, f
 	for (i = 0; i < n; ++i) {
 		float x_val = x[i];
 		activation_input[i] = x_val;    // store value before activation
-		output[i] = hard_mish_yashas(x_val);
+		output[i] = hard_mish_activate(x_val);
 	}
 }
 
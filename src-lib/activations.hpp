@@ -152,6 +152,30 @@ static inline float softplus_activate(float x, float threshold)
 	return std::log(expf(x) + 1.0f);
 }
 
+/// Same as @ref activate_array_swish() for a single value.  @since 2026-10-17
+static inline float swish_activate(float x)
+{
+	TAT(TATPARMS);
+	return x * logistic_activate(x);
+}
+
+/// Same as @ref activate_array_mish() for a single value.  @since 2026-10-17
+static inline float mish_activate(float x)
+{
+	TAT(TATPARMS);
+	return x * tanh_activate(softplus_activate(x, 20.0f));
+}
+
+static inline float hard_mish_activate(float x)
+{
+	TAT(TATPARMS);
+	if (x > 0)
+		return x;
+	if (x > -2)
+		return x * x / 2 + x;
+	return 0;
+}
+
 static inline float plse_activate(float x)
 {
 	TAT(TATPARMS);
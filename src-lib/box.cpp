@@ -1012,6 +1012,249 @@ void diounms_sort(detection *dets, int total, int classes, float thresh, NMS_KIN
 }
 
 
+namespace
+{
+	/// One entry for every non-zero class probability (or objectness) which needs to go through NMS.
+	struct nms_candidate
+	{
+		int class_id;	///< The class index, or @p -1 when doing NMS on objectness.
+		float prob;
+		int index;		///< Index into the array of detections.
+	};
+
+
+	/// Memory used by @ref do_nms_fused().  This is kept between calls to avoid re-allocating on every frame.
+	struct nms_workspace
+	{
+		std::vector<nms_candidate> candidates;
+		std::vector<char> suppressed;
+		Darknet::VInt cell_start;
+		Darknet::VInt cell_next;
+		Darknet::VInt cell_items;
+	};
+
+
+	static inline float nms_overlap(const Darknet::Box & a, const Darknet::Box & b, const NMS_KIND nms_kind, const float beta1)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		if (nms_kind == GREEDY_NMS)
+		{
+			return box_diou(a, b);
+		}
+
+		if (nms_kind == DIOU_NMS)
+		{
+			return box_diounms(a, b, beta1);
+		}
+
+		// DEFAULT_NMS, CORNERS_NMS, and OBJECTNESS_NMS
+		return box_iou(a, b);
+	}
+
+
+	/** Greedy NMS on a group of candidates already sorted from high to low probability.  All the candidates belong to
+	 * the same class.  Boxes which are suppressed are flagged in @p suppressed, which must be zeroed by the caller.
+	 */
+	static inline void nms_group(const Darknet::Detection * dets, const nms_candidate * group, char * suppressed, const int count, const float thresh, const NMS_KIND nms_kind, const float beta1, nms_workspace & workspace)
+	{
+		TAT(TATPARMS);
+
+		// All the overlap measures are <= IoU, so when the threshold is not negative two boxes can only suppress each
+		// other if they intersect.  This lets us skip most of the pairs by placing the box centers in a grid.
+		bool use_grid = (count > 32 and thresh >= 0.0f);
+
+		float min_x = FLT_MAX;
+		float min_y = FLT_MAX;
+		float max_x = -FLT_MAX;
+		float max_y = -FLT_MAX;
+		float max_w = 0.0f;
+		float max_h = 0.0f;
+
+		for (int idx = 0; use_grid and idx < count; ++idx)
+		{
+			const Darknet::Box & b = dets[group[idx].index].bbox;
+			if (not std::isfinite(b.x) or not std::isfinite(b.y) or not std::isfinite(b.w) or not std::isfinite(b.h))
+			{
+				use_grid = false;
+			}
+			min_x = std::min(min_x, b.x);
+			min_y = std::min(min_y, b.y);
+			max_x = std::max(max_x, b.x);
+			max_y = std::max(max_y, b.y);
+			max_w = std::max(max_w, std::fabs(b.w));
+			max_h = std::max(max_h, std::fabs(b.h));
+		}
+
+		if (not use_grid)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				if (suppressed[i])
+				{
+					continue;
+				}
+				const Darknet::Box & a = dets[group[i].index].bbox;
+				for (int j = i + 1; j < count; ++j)
+				{
+					if (suppressed[j] == 0 and nms_overlap(a, dets[group[j].index].bbox, nms_kind, beta1) > thresh)
+					{
+						suppressed[j] = 1;
+					}
+				}
+			}
+
+			return;
+		}
+
+		// cells are at least as large as the largest box, and there are never more than 64x64 cells
+		const float cell_w = std::max({max_w, (max_x - min_x) / 64.0f, 1.0e-6f});
+		const float cell_h = std::max({max_h, (max_y - min_y) / 64.0f, 1.0e-6f});
+		const int grid_w = std::min(64, static_cast<int>((max_x - min_x) / cell_w) + 1);
+		const int grid_h = std::min(64, static_cast<int>((max_y - min_y) / cell_h) + 1);
+
+		const auto cell_x = [&](const float x) { return std::clamp(static_cast<int>(std::floor((x - min_x) / cell_w)), 0, grid_w - 1); };
+		const auto cell_y = [&](const float y) { return std::clamp(static_cast<int>(std::floor((y - min_y) / cell_h)), 0, grid_h - 1); };
+
+		// counting sort of the candidates into the cells; within each cell they remain sorted from high to low probability
+		workspace.cell_start.assign(grid_w * grid_h + 1, 0);
+		workspace.cell_items.resize(count);
+		for (int idx = 0; idx < count; ++idx)
+		{
+			const Darknet::Box & b = dets[group[idx].index].bbox;
+			workspace.cell_start[cell_y(b.y) * grid_w + cell_x(b.x) + 1] ++;
+		}
+		for (int cell = 0; cell < grid_w * grid_h; ++cell)
+		{
+			workspace.cell_start[cell + 1] += workspace.cell_start[cell];
+		}
+		workspace.cell_next.assign(workspace.cell_start.begin(), workspace.cell_start.end() - 1);
+		for (int idx = 0; idx < count; ++idx)
+		{
+			const Darknet::Box & b = dets[group[idx].index].bbox;
+			workspace.cell_items[workspace.cell_next[cell_y(b.y) * grid_w + cell_x(b.x)] ++] = idx;
+		}
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (suppressed[i])
+			{
+				continue;
+			}
+
+			// only look at the cells where the center of an intersecting box could be (with a bit of margin for rounding)
+			const Darknet::Box & a = dets[group[i].index].bbox;
+			const float reach_x = (std::fabs(a.w) + max_w) / 2.0f * 1.001f + 1.0e-6f;
+			const float reach_y = (std::fabs(a.h) + max_h) / 2.0f * 1.001f + 1.0e-6f;
+			const int x1 = cell_x(a.x - reach_x);
+			const int x2 = cell_x(a.x + reach_x);
+			const int y1 = cell_y(a.y - reach_y);
+			const int y2 = cell_y(a.y + reach_y);
+
+			for (int y = y1; y <= y2; ++y)
+			{
+				for (int x = x1; x <= x2; ++x)
+				{
+					const int cell = y * grid_w + x;
+					for (int item = workspace.cell_start[cell]; item < workspace.cell_start[cell + 1]; ++item)
+					{
+						const int j = workspace.cell_items[item];
+						if (j > i and suppressed[j] == 0 and nms_overlap(a, dets[group[j].index].bbox, nms_kind, beta1) > thresh)
+						{
+							suppressed[j] = 1;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+
+void do_nms_fused(Darknet::Detection * dets, int total, int classes, float thresh, NMS_KIND nms_kind, float beta1)
+{
+	TAT(TATPARMS);
+
+	static thread_local nms_workspace workspace;
+	auto & candidates = workspace.candidates;
+	candidates.clear();
+
+	// a single list of everything which needs to be looked at, instead of sorting all the detections once per class
+	for (int i = 0; i < total; ++i)
+	{
+		if (dets[i].objectness > 0.0f)
+		{
+			if (nms_kind == OBJECTNESS_NMS)
+			{
+				candidates.push_back({-1, dets[i].objectness, i});
+				continue;
+			}
+
+			for (int k = 0; k < classes; ++k)
+			{
+				if (dets[i].prob[k] > 0.0f)
+				{
+					candidates.push_back({k, dets[i].prob[k], i});
+				}
+			}
+		}
+	}
+
+	// group by class, and within each class sort from high to low probability (ties are broken by index so results are repeatable)
+	std::sort(candidates.begin(), candidates.end(),
+			[](const nms_candidate & lhs, const nms_candidate & rhs) -> bool
+			{
+				if (lhs.class_id != rhs.class_id)
+				{
+					return lhs.class_id < rhs.class_id;
+				}
+				if (lhs.prob != rhs.prob)
+				{
+					return lhs.prob > rhs.prob;
+				}
+				return lhs.index < rhs.index;
+			});
+
+	workspace.suppressed.assign(candidates.size(), 0);
+
+	size_t first = 0;
+	while (first < candidates.size())
+	{
+		size_t last = first + 1;
+		while (last < candidates.size() and candidates[last].class_id == candidates[first].class_id)
+		{
+			++last;
+		}
+
+		nms_group(dets, candidates.data() + first, workspace.suppressed.data() + first, last - first, thresh, nms_kind, beta1, workspace);
+
+		first = last;
+	}
+
+	for (size_t idx = 0; idx < candidates.size(); ++idx)
+	{
+		if (workspace.suppressed[idx] == 0)
+		{
+			continue;
+		}
+
+		Darknet::Detection & det = dets[candidates[idx].index];
+		if (candidates[idx].class_id >= 0)
+		{
+			det.prob[candidates[idx].class_id] = 0.0f;
+		}
+		else
+		{
+			det.objectness = 0.0f;
+			for (int k = 0; k < classes; ++k)
+			{
+				det.prob[k] = 0.0f;
+			}
+		}
+	}
+}
+
+
 Darknet::Box encode_box(const Darknet::Box & b, const Darknet::Box & anchor)
 {
 	TAT_REVIEWED(TATPARMS, "2024-05-12");
@@ -33,6 +33,18 @@ dbox diou(const Darknet::Box & a, const Darknet::Box & b);
 float box_rmse(const Darknet::Box & a, const Darknet::Box & b);
 void do_nms(Darknet::Box *boxes, float **probs, int total, int classes, float thresh);
 void do_nms_sort_v2(Darknet::Box *boxes, float **probs, int total, int classes, float thresh);
+
+/** Non Maxima Suppression which handles all the classes with a single sort, and uses a grid over the box centers to
+ * skip comparing boxes which cannot possibly overlap.  The results are the same as @ref do_nms_sort() when
+ * @p nms_kind is @p DEFAULT_NMS, @ref diounms_sort() for @p GREEDY_NMS, @p DIOU_NMS, and @p CORNERS_NMS, and
+ * @ref do_nms_obj() for @p OBJECTNESS_NMS.  Unlike those functions, the detections are not re-ordered.
+ *
+ * @see @ref Darknet::benchmark_nms()
+ *
+ * @since 2026-10-17
+ */
+void do_nms_fused(Darknet::Detection * dets, int total, int classes, float thresh, NMS_KIND nms_kind, float beta1);
+
 Darknet::Box decode_box(const Darknet::Box & b, const Darknet::Box & anchor);
 Darknet::Box encode_box(const Darknet::Box & b, const Darknet::Box & anchor);
 
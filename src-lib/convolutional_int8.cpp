@@ -0,0 +1,72 @@
+/** @file
+ * Convolutional layers running with 8-bit integers on the CPU.  See @ref Darknet::quantize_network() for how the scales
+ * are calculated, and @ref gemm_int8() for the matrix multiplication.
+ */
+
+#include "darknet_internal.hpp"
+#include "gemm.hpp"
+#include "im2col.hpp"
+
+
+void quantize_convolutional_weights(Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	if (l.int8_weight_scales == nullptr)
+	{
+		darknet_fatal_error(DARKNET_LOC, "cannot quantize the weights of layer #%d since the scales have not been set", l.index);
+	}
+
+	const int k		= l.size * l.size * l.c;
+	const int lda	= (k + 3) / 4 * 4;
+
+	free(l.int8_weights);
+	free(l.int8_weight_sums);
+	l.int8_weights		= (int8_t*)xcalloc(static_cast<size_t>(l.n) * lda, sizeof(int8_t));
+	l.int8_weight_sums	= (int32_t*)xcalloc(l.n, sizeof(int32_t));
+
+	for (int f = 0; f < l.n; ++f)
+	{
+		const float scale = l.int8_weight_scales[f];
+		if (scale <= 0.0f)
+		{
+			// every weight in this filter is zero
+			continue;
+		}
+
+		const float * src = l.weights + static_cast<size_t>(f) * k;
+		int8_t * dst = l.int8_weights + static_cast<size_t>(f) * lda;
+		int32_t sum = 0;
+		for (int i = 0; i < k; ++i)
+		{
+			const int q = static_cast<int>(std::lrint(std::clamp(src[i] / scale, -127.0f, 127.0f)));
+			dst[i] = static_cast<int8_t>(q);
+			sum += q;
+		}
+		l.int8_weight_sums[f] = sum;
+	}
+
+	return;
+}
+
+
+void forward_convolutional_layer_int8(const Darknet::Layer & l, const float * input, float * output, float * workspace, const GemmEpilogue * epilogue)
+{
+	TAT(TATPARMS);
+
+	const int m		= l.n;
+	const int k		= l.size * l.size * l.c;
+	const int n		= l.out_w * l.out_h;
+	const int lda	= (k + 3) / 4 * 4;
+
+	const float * b = input;
+	if (l.size != 1 or l.stride_x != 1 or l.stride_y != 1 or l.dilation != 1)
+	{
+		im2col_cpu_ext(input, l.c, l.h, l.w, l.size, l.size, l.pad * l.dilation, l.pad * l.dilation, l.stride_y, l.stride_x, l.dilation, l.dilation, workspace);
+		b = workspace;
+	}
+
+	gemm_int8(m, n, k, l.int8_weights, lda, l.int8_weight_sums, l.int8_weight_scales, b, n, l.int8_input_scale, output, n, epilogue);
+
+	return;
+}
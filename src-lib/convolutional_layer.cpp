@@ -279,6 +279,27 @@ size_t get_convolutional_workspace_size(const Darknet::Layer & l)
 {
 	TAT(TATPARMS);
 
+	if (cfg_and_state.gpu_index < 0)
+	{
+		// see select_convolution_algorithms()
+		if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kDirect1x1)
+		{
+			return 0;
+		}
+		if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kInt8 and l.size == 1 and l.stride_x == 1 and l.stride_y == 1 and l.dilation == 1)
+		{
+			return 0;
+		}
+		if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kNHWC)
+		{
+			return nhwc_needs_im2col(l) ? static_cast<size_t>(l.out_h) * l.out_w * l.size * l.size * l.c * sizeof(float) : 0;
+		}
+		if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kWinograd2x2 || l.conv_algorithm == Darknet::EConvolutionAlgorithm::kWinograd4x4)
+		{
+			return get_winograd_workspace_size(l);
+		}
+	}
+
 	size_t workspace_size = get_workspace_size32(l);
 	size_t workspace_size16 = get_workspace_size16(l);
 	if (workspace_size16 > workspace_size)
@@ -1436,6 +1457,21 @@ void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state
 	int k = l.size*l.size*l.c / l.groups;
 	int n = out_h*out_w;
 
+	/* During inference the bias and activation are applied to each tile of the output by the GEMM, instead of making
+	 * separate passes over the output once the multiplication is done.  Batch normalization and Winograd still need the
+	 * separate passes.  NHWC layers always apply them in the GEMM.
+	 */
+	const bool fused_epilogue =
+		l.conv_algorithm == Darknet::EConvolutionAlgorithm::kNHWC ||
+		(	!state.train			&&
+			!l.batch_normalize		&&
+			!l.xnor					&&
+			!l.binary				&&
+			gemm_epilogue_supports(l.activation) &&
+			(	l.conv_algorithm == Darknet::EConvolutionAlgorithm::kIm2col		||
+				l.conv_algorithm == Darknet::EConvolutionAlgorithm::kDirect1x1	||
+				l.conv_algorithm == Darknet::EConvolutionAlgorithm::kInt8		));
+
 	for(i = 0; i < l.batch; ++i)
 	{
 		for (j = 0; j < l.groups; ++j)
@@ -1443,6 +1479,7 @@ void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state
 			float *a = l.weights +j*l.nweights / l.groups;
 			float *b = state.workspace;
 			float *c = l.output +(i*l.groups + j)*n*m;
+			const GemmEpilogue epilogue = {l.biases + j*m, l.activation};
 
 			//gemm(0,0,m,n,k,1,a,k,b,n,1,c,n);
 			//gemm_nn_custom(m, n, k, 1, a, k, b, n, c, n);
@@ -1537,6 +1574,21 @@ void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state
 				return;
 
 			}
+			else if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kWinograd2x2 || l.conv_algorithm == Darknet::EConvolutionAlgorithm::kWinograd4x4)
+			{
+				// 3x3 stride 1 layers selected at load time, which don't need im2col
+				forward_convolutional_layer_winograd(l, state.input + i*l.c*l.h*l.w, c, state.workspace);
+			}
+			else if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kInt8)
+			{
+				// layers quantized with "darknet detector quantize"
+				forward_convolutional_layer_int8(l, state.input + i*l.c*l.h*l.w, c, state.workspace, fused_epilogue ? &epilogue : nullptr);
+			}
+			else if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kNHWC)
+			{
+				// layers converted with --nhwc
+				forward_convolutional_layer_nhwc(l, state.input + i*l.c*l.h*l.w, c, state.workspace);
+			}
 			else
 			{
 				float *im = state.input + (i*l.groups + j)*(l.c / l.groups)*l.h*l.w;
@@ -1557,27 +1609,37 @@ void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state
 
 				}
 
-				gemm(0, 0, m, n, k, 1, a, k, b, n, 1, c, n);
+				if (fused_epilogue)
+				{
+					gemm_cpu_fused(0, 0, m, n, k, 1, a, k, b, n, c, n, epilogue);
+				}
+				else
+				{
+					gemm(0, 0, m, n, k, 1, a, k, b, n, 1, c, n);
+				}
 				// bit-count to float
 			}
 		}
 	}
 
-	if(l.batch_normalize){
-		forward_batchnorm_layer(l, state);
-	}
-	else {
-		add_bias(l.output, l.biases, l.batch, l.n, out_h*out_w);
-	}
+	if (not fused_epilogue)
+	{
+		if(l.batch_normalize){
+			forward_batchnorm_layer(l, state);
+		}
+		else {
+			add_bias(l.output, l.biases, l.batch, l.n, out_h*out_w);
+		}
 
-	//activate_array(l.output, m*n*l.batch, l.activation);
-	if (l.activation == SWISH) activate_array_swish(l.output, l.outputs*l.batch, l.activation_input, l.output);
-	else if (l.activation == MISH) activate_array_mish(l.output, l.outputs*l.batch, l.activation_input, l.output);
-	else if (l.activation == HARD_MISH) activate_array_hard_mish(l.output, l.outputs*l.batch, l.activation_input, l.output);
-	else if (l.activation == NORM_CHAN) activate_array_normalize_channels(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output);
-	else if (l.activation == NORM_CHAN_SOFTMAX) activate_array_normalize_channels_softmax(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output, 0);
-	else if (l.activation == NORM_CHAN_SOFTMAX_MAXVAL) activate_array_normalize_channels_softmax(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output, 1);
-	else activate_array_cpu_custom(l.output, l.outputs*l.batch, l.activation);
+		//activate_array(l.output, m*n*l.batch, l.activation);
+		if (l.activation == SWISH) activate_array_swish(l.output, l.outputs*l.batch, l.activation_input, l.output);
+		else if (l.activation == MISH) activate_array_mish(l.output, l.outputs*l.batch, l.activation_input, l.output);
+		else if (l.activation == HARD_MISH) activate_array_hard_mish(l.output, l.outputs*l.batch, l.activation_input, l.output);
+		else if (l.activation == NORM_CHAN) activate_array_normalize_channels(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output);
+		else if (l.activation == NORM_CHAN_SOFTMAX) activate_array_normalize_channels_softmax(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output, 0);
+		else if (l.activation == NORM_CHAN_SOFTMAX_MAXVAL) activate_array_normalize_channels_softmax(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output, 1);
+		else activate_array_cpu_custom(l.output, l.outputs*l.batch, l.activation);
+	}
 
 	if(l.binary || l.xnor) swap_binary(&l);
 
@@ -2,6 +2,8 @@
 
 #include "darknet_internal.hpp"
 
+struct GemmEpilogue; // see gemm.hpp
+
 #ifdef DARKNET_GPU
 void forward_convolutional_layer_gpu(Darknet::Layer & l, Darknet::NetworkState state);
 void backward_convolutional_layer_gpu(Darknet::Layer & l, Darknet::NetworkState state);
@@ -21,6 +23,60 @@ void cuda_convert_f32_to_f16(float* input_f32, size_t size, float *output_f16);
 void free_convolutional_batchnorm(Darknet::Layer *l);
 
 size_t get_convolutional_workspace_size(const Darknet::Layer & l);
+
+/** Choose the CPU algorithm for each convolutional layer, and shrink the workspace accordingly.  3x3 layers with a
+ * stride of 1 use Winograd F(4x4,3x3) or F(2x2,3x3), and 1x1 layers with a stride of 1 multiply the input directly
+ * without im2col.  When @p --int8 is used, the scales saved by @ref Darknet::quantize_network() are loaded and those
+ * layers run with 8-bit integers instead.  When @p --nhwc is used, @ref Darknet::convert_network_to_nhwc() is called
+ * once the algorithms have been chosen.  This is only for inference, and must be called once the weights have been
+ * loaded and @ref fuse_conv_batchnorm() has folded the batch normalization into the weights.
+ *
+ * @since 2026-10-17
+ */
+void select_convolution_algorithms(Darknet::Network & net);
+
+/// The workspace needed by @ref forward_convolutional_layer_winograd().  @since 2026-10-17
+size_t get_winograd_workspace_size(const Darknet::Layer & l);
+
+/** Convolve a single image from the batch using the Winograd weights calculated by
+ * @ref select_convolution_algorithms().  Bias and activation are not applied.
+ *
+ * @since 2026-10-17
+ */
+void forward_convolutional_layer_winograd(const Darknet::Layer & l, const float * input, float * output, float * workspace);
+
+/** Quantize the fused weights of a layer to 8 bits using the per-filter scales in @p l.int8_weight_scales.  This is
+ * called by @ref select_convolution_algorithms() for layers which use @ref Darknet::EConvolutionAlgorithm::kInt8.
+ *
+ * @since 2026-10-17
+ */
+void quantize_convolutional_weights(Darknet::Layer & l);
+
+/** Convolve a single image from the batch with @ref gemm_int8().  The workspace is only used for @ref im2col_cpu_ext()
+ * when the layer is not 1x1 with a stride of 1.  Bias and activation are only applied when @p epilogue is set.
+ *
+ * @since 2026-10-17
+ */
+void forward_convolutional_layer_int8(const Darknet::Layer & l, const float * input, float * output, float * workspace, const GemmEpilogue * epilogue = nullptr);
+
+/** Re-order the weights of a layer into @p l.nhwc_weights, which is what @ref forward_convolutional_layer_nhwc()
+ * multiplies.  This is called by @ref Darknet::convert_network_to_nhwc().
+ *
+ * @since 2026-10-17
+ */
+void prepare_nhwc_weights(Darknet::Layer & l);
+
+/// Whether @ref forward_convolutional_layer_nhwc() needs the workspace for im2col.  @since 2026-10-17
+bool nhwc_needs_im2col(const Darknet::Layer & l);
+
+/** Convolve a single image from the batch using @ref Darknet::EConvolutionAlgorithm::kNHWC.  The input is read using
+ * @p l.input_layout and the output is written using @p l.output_layout, so the layer also converts between the two
+ * layouts at no extra cost.  Bias and activation are always applied.
+ *
+ * @since 2026-10-17
+ */
+void forward_convolutional_layer_nhwc(const Darknet::Layer & l, const float * input, float * output, float * workspace);
+
 Darknet::Layer make_convolutional_layer(int batch, int steps, int h, int w, int c, int n, int groups, int size, int stride_x, int stride_y, int dilation, int padding, ACTIVATION activation, int batch_normalize, int binary, int xnor, int adam, int use_bin_output, int index, int antialiasing, Darknet::Layer * share_layer, int assisted_excitation, int deform, int train);
 void denormalize_convolutional_layer(Darknet::Layer & l);
 void set_specified_workspace_limit(Darknet::Layer *l, size_t workspace_size_limit);
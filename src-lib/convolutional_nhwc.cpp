@@ -0,0 +1,149 @@
+/** @file
+ * Convolutional layers running with the channels last (NHWC) on the CPU.  See @ref Darknet::convert_network_to_nhwc()
+ * for how the layout of each layer is chosen.
+ *
+ * With the channels last, the @p "size * size" patch read for each output pixel is made of @p size rows of
+ * @p "size * c" contiguous values, so the im2col step is mostly a series of @p memcpy() calls instead of the gather
+ * done by @ref im2col_cpu_ext().  1x1 layers with a stride of 1 don't need im2col at all, regardless of the layout of
+ * the input.
+ */
+
+#include "darknet_internal.hpp"
+#include "gemm.hpp"
+
+
+namespace
+{
+	/** Copy the patch of each output pixel into one row of @p dst, which is @p "out_h * out_w" rows of
+	 * @p "size * size * c" values.  The values in each row are ordered by kernel row, kernel column, and then channel.
+	 */
+	static void im2col_nhwc(const Darknet::Layer & l, const float * input, const bool input_is_nhwc, float * dst)
+	{
+		TAT(TATPARMS);
+
+		const int c			= l.c;
+		const int h			= l.h;
+		const int w			= l.w;
+		const int size		= l.size;
+		const int pad		= l.pad * l.dilation;
+		const int row_size	= size * size * c;
+
+		#pragma omp parallel for
+		for (int y = 0; y < l.out_h; ++y)
+		{
+			for (int x = 0; x < l.out_w; ++x)
+			{
+				float * row = dst + (static_cast<size_t>(y) * l.out_w + x) * row_size;
+
+				for (int ky = 0; ky < size; ++ky)
+				{
+					const int iy = y * l.stride_y - pad + ky * l.dilation;
+					for (int kx = 0; kx < size; ++kx)
+					{
+						const int ix = x * l.stride_x - pad + kx * l.dilation;
+						float * out = row + (ky * size + kx) * c;
+
+						if (iy < 0 or iy >= h or ix < 0 or ix >= w)
+						{
+							std::memset(out, 0, c * sizeof(float));
+						}
+						else if (input_is_nhwc)
+						{
+							std::memcpy(out, input + (static_cast<size_t>(iy) * w + ix) * c, c * sizeof(float));
+						}
+						else
+						{
+							// the first layer reads the original image, which is planar
+							const float * in = input + static_cast<size_t>(iy) * w + ix;
+							for (int ch = 0; ch < c; ++ch)
+							{
+								out[ch] = in[static_cast<size_t>(ch) * h * w];
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return;
+	}
+}
+
+
+void prepare_nhwc_weights(Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	const int size	= l.size;
+	const int c		= l.c;
+	const int k		= size * size * c;
+
+	free(l.nhwc_weights);
+	l.nhwc_weights = (float*)xcalloc(static_cast<size_t>(k) * l.n, sizeof(float));
+
+	for (int f = 0; f < l.n; ++f)
+	{
+		const float * src = l.weights + static_cast<size_t>(f) * k;
+		for (int ch = 0; ch < c; ++ch)
+		{
+			for (int ky = 0; ky < size; ++ky)
+			{
+				for (int kx = 0; kx < size; ++kx)
+				{
+					const int row = (ky * size + kx) * c + ch;
+					l.nhwc_weights[static_cast<size_t>(row) * l.n + f] = src[(ch * size + ky) * size + kx];
+				}
+			}
+		}
+	}
+
+	return;
+}
+
+
+bool nhwc_needs_im2col(const Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	return (l.size != 1 or l.stride_x != 1 or l.stride_y != 1 or l.dilation != 1);
+}
+
+
+void forward_convolutional_layer_nhwc(const Darknet::Layer & l, const float * input, float * output, float * workspace)
+{
+	TAT(TATPARMS);
+
+	const bool input_is_nhwc	= (l.input_layout	== Darknet::ETensorLayout::kNHWC);
+	const bool output_is_nhwc	= (l.output_layout	== Darknet::ETensorLayout::kNHWC);
+	const int k					= l.size * l.size * l.c;
+	const int pixels			= l.out_w * l.out_h;
+
+	/* "patches" is the matrix with one row of k values per output pixel.  1x1 layers use the input as-is, in which case
+	 * a planar input is the transpose of that matrix.
+	 */
+	const float * patches = input;
+	bool transposed = not input_is_nhwc;
+	if (nhwc_needs_im2col(l))
+	{
+		im2col_nhwc(l, input, input_is_nhwc, workspace);
+		patches = workspace;
+		transposed = false;
+	}
+
+	GemmEpilogue epilogue = {l.biases, l.activation};
+	epilogue.bias_per_column = output_is_nhwc;
+
+	float * a = const_cast<float*>(patches);
+	if (output_is_nhwc)
+	{
+		// output[pixels x n] = patches[pixels x k] * nhwc_weights[k x n]
+		gemm_cpu_fused(transposed ? 1 : 0, 0, pixels, l.n, k, 1.0f, a, transposed ? pixels : k, l.nhwc_weights, l.n, output, l.n, epilogue);
+	}
+	else
+	{
+		// output[n x pixels] = transpose(nhwc_weights) * transpose(patches), used by the layers which feed a planar layer
+		gemm_cpu_fused(1, transposed ? 0 : 1, l.n, pixels, k, 1.0f, l.nhwc_weights, l.n, a, transposed ? pixels : k, output, pixels, epilogue);
+	}
+
+	return;
+}
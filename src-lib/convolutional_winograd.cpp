@@ -0,0 +1,598 @@
+/** @file
+ * Convolutions on the CPU which don't go through @ref im2col_cpu_ext().  See @ref select_convolution_algorithms().
+ *
+ * Winograd's minimal filtering algorithm computes an @p MxM tile of output from an @p "(M+2)x(M+2)" tile of input with
+ * @p "(M+2)^2" multiplications per channel instead of @p "9 * M^2".  The input and the filters are first transformed,
+ * then each of the @p "(M+2)^2" positions becomes an independent matrix multiplication across the channels, and
+ * finally the output tiles are transformed back:
+ *
+ * ~~~~.txt
+ *     U = G g G^T        (filters, done once when the network is loaded)
+ *     V = B^T d B        (input tiles)
+ *     M = U * V          (one GEMM per position in the tile, summing over the input channels)
+ *     Y = A^T M A        (output tiles)
+ * ~~~~
+ *
+ * The matrices are those from "Fast Algorithms for Convolutional Neural Networks" by Lavin and Gray.
+ */
+
+#include "darknet_internal.hpp"
+#include "gemm.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/** The number of tiles transformed at once.  This bounds the size of the workspace, while keeping the matrix
+	 * multiplications wide enough to be efficient.
+	 */
+	static const int tiles_per_block = 256;
+
+
+	/// The transformation matrices for F(MxM,3x3).
+	template <int M>
+	struct Winograd;
+
+
+	template <>
+	struct Winograd<2>
+	{
+		static constexpr int alpha = 4;
+
+		static constexpr float BT[4][4] =
+		{
+			{1.0f,  0.0f, -1.0f,  0.0f},
+			{0.0f,  1.0f,  1.0f,  0.0f},
+			{0.0f, -1.0f,  1.0f,  0.0f},
+			{0.0f,  1.0f,  0.0f, -1.0f},
+		};
+
+		static constexpr float G[4][3] =
+		{
+			{1.0f,  0.0f, 0.0f},
+			{0.5f,  0.5f, 0.5f},
+			{0.5f, -0.5f, 0.5f},
+			{0.0f,  0.0f, 1.0f},
+		};
+
+		static constexpr float AT[2][4] =
+		{
+			{1.0f, 1.0f,  1.0f,  0.0f},
+			{0.0f, 1.0f, -1.0f, -1.0f},
+		};
+	};
+
+
+	template <>
+	struct Winograd<4>
+	{
+		static constexpr int alpha = 6;
+
+		static constexpr float BT[6][6] =
+		{
+			{4.0f,  0.0f, -5.0f,  0.0f, 1.0f, 0.0f},
+			{0.0f, -4.0f, -4.0f,  1.0f, 1.0f, 0.0f},
+			{0.0f,  4.0f, -4.0f, -1.0f, 1.0f, 0.0f},
+			{0.0f, -2.0f, -1.0f,  2.0f, 1.0f, 0.0f},
+			{0.0f,  2.0f, -1.0f, -2.0f, 1.0f, 0.0f},
+			{0.0f,  4.0f,  0.0f, -5.0f, 0.0f, 1.0f},
+		};
+
+		static constexpr float G[6][3] =
+		{
+			{ 1.0f /  4.0f,  0.0f,          0.0f        },
+			{-1.0f /  6.0f, -1.0f /  6.0f, -1.0f / 6.0f },
+			{-1.0f /  6.0f,  1.0f /  6.0f, -1.0f / 6.0f },
+			{ 1.0f / 24.0f,  1.0f / 12.0f,  1.0f / 6.0f },
+			{ 1.0f / 24.0f, -1.0f / 12.0f,  1.0f / 6.0f },
+			{ 0.0f,          0.0f,          1.0f        },
+		};
+
+		static constexpr float AT[4][6] =
+		{
+			{1.0f, 1.0f,  1.0f, 1.0f,  1.0f, 0.0f},
+			{0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.0f},
+			{0.0f, 1.0f,  1.0f, 4.0f,  4.0f, 0.0f},
+			{0.0f, 1.0f, -1.0f, 8.0f, -8.0f, 1.0f},
+		};
+	};
+
+
+	static inline bool is_winograd(const Darknet::EConvolutionAlgorithm algorithm)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		return	algorithm == Darknet::EConvolutionAlgorithm::kWinograd2x2 or
+				algorithm == Darknet::EConvolutionAlgorithm::kWinograd4x4;
+	}
+
+
+	static inline int winograd_tile_size(const Darknet::EConvolutionAlgorithm algorithm)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		return (algorithm == Darknet::EConvolutionAlgorithm::kWinograd4x4) ? 4 : 2;
+	}
+
+
+	/** Transform every 3x3 filter into @p "U = G g G^T", stored as @p alpha^2 matrices of size @p "l.c x l.n".  The
+	 * output channels are the columns so the matrix multiplications are wide even when the image is small.
+	 */
+	template <int M>
+	static float * transform_weights(const Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+		using W = Winograd<M>;
+		const int alpha = W::alpha;
+		const size_t matrix_size = static_cast<size_t>(l.n) * l.c;
+
+		float * u = (float*)xcalloc(alpha * alpha * matrix_size, sizeof(float));
+
+		for (int k = 0; k < l.n; ++k)
+		{
+			for (int c = 0; c < l.c; ++c)
+			{
+				const float * g = l.weights + (static_cast<size_t>(k) * l.c + c) * 9;
+
+				// tmp = G g
+				float tmp[alpha][3];
+				for (int i = 0; i < alpha; ++i)
+				{
+					for (int j = 0; j < 3; ++j)
+					{
+						tmp[i][j] = W::G[i][0] * g[0 * 3 + j] + W::G[i][1] * g[1 * 3 + j] + W::G[i][2] * g[2 * 3 + j];
+					}
+				}
+
+				// U = tmp G^T
+				for (int i = 0; i < alpha; ++i)
+				{
+					for (int j = 0; j < alpha; ++j)
+					{
+						u[(i * alpha + j) * matrix_size + static_cast<size_t>(c) * l.n + k] = tmp[i][0] * W::G[j][0] + tmp[i][1] * W::G[j][1] + tmp[i][2] * W::G[j][2];
+					}
+				}
+			}
+		}
+
+		return u;
+	}
+
+
+	/** Transform the input tiles @p "[first_tile, first_tile + tiles)" into @p "V = B^T d B", stored as @p alpha^2
+	 * matrices of size @p "tiles x l.c".  Each value in the small matrices is a vector across all of the channels, so
+	 * the compiler vectorizes the inner loops.
+	 */
+	template <int M>
+	static void transform_input(const Darknet::Layer & l, const float * input, const int tiles_w, const int first_tile, const int tiles, float * v)
+	{
+		TAT(TATPARMS);
+
+		using W = Winograd<M>;
+		const int alpha			= W::alpha;
+		const int channels		= l.c;
+		const size_t plane_size	= static_cast<size_t>(l.h) * l.w;
+
+		#pragma omp parallel
+		{
+			Darknet::VFloat d	(alpha * alpha * channels);
+			Darknet::VFloat tmp	(alpha * alpha * channels);
+
+			#pragma omp for
+			for (int t = 0; t < tiles; ++t)
+			{
+				const int tile = first_tile + t;
+				const int y0 = (tile / tiles_w) * M - l.pad;
+				const int x0 = (tile % tiles_w) * M - l.pad;
+
+				// the input tile, with zeros for anything that falls in the padding
+				for (int i = 0; i < alpha; ++i)
+				{
+					const int y = y0 + i;
+					for (int j = 0; j < alpha; ++j)
+					{
+						const int x = x0 + j;
+						float * dst = d.data() + (i * alpha + j) * channels;
+						if (y >= 0 and y < l.h and x >= 0 and x < l.w)
+						{
+							const float * src = input + y * l.w + x;
+							for (int c = 0; c < channels; ++c)
+							{
+								dst[c] = src[c * plane_size];
+							}
+						}
+						else
+						{
+							std::fill(dst, dst + channels, 0.0f);
+						}
+					}
+				}
+
+				// tmp = B^T d
+				for (int i = 0; i < alpha; ++i)
+				{
+					for (int j = 0; j < alpha; ++j)
+					{
+						float * dst = tmp.data() + (i * alpha + j) * channels;
+						std::fill(dst, dst + channels, 0.0f);
+						for (int p = 0; p < alpha; ++p)
+						{
+							const float coefficient = W::BT[i][p];
+							if (coefficient != 0.0f)
+							{
+								const float * src = d.data() + (p * alpha + j) * channels;
+								for (int c = 0; c < channels; ++c)
+								{
+									dst[c] += coefficient * src[c];
+								}
+							}
+						}
+					}
+				}
+
+				// V = tmp B
+				for (int i = 0; i < alpha; ++i)
+				{
+					for (int j = 0; j < alpha; ++j)
+					{
+						float * dst = v + (static_cast<size_t>(i * alpha + j) * tiles + t) * channels;
+						std::fill(dst, dst + channels, 0.0f);
+						for (int p = 0; p < alpha; ++p)
+						{
+							const float coefficient = W::BT[j][p];
+							if (coefficient != 0.0f)
+							{
+								const float * src = tmp.data() + (i * alpha + p) * channels;
+								for (int c = 0; c < channels; ++c)
+								{
+									dst[c] += coefficient * src[c];
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return;
+	}
+
+
+	/// Transform the products back into @p "Y = A^T M A" and write the output tiles which fall within the image.
+	template <int M>
+	static void transform_output(const Darknet::Layer & l, const float * m, const int tiles_w, const int first_tile, const int tiles, float * output)
+	{
+		TAT(TATPARMS);
+
+		using W = Winograd<M>;
+		const int alpha			= W::alpha;
+		const int channels		= l.n;
+		const size_t plane_size	= static_cast<size_t>(l.out_h) * l.out_w;
+
+		#pragma omp parallel
+		{
+			Darknet::VFloat tmp	(M * alpha * channels);
+			Darknet::VFloat y	(M * M * channels);
+
+			#pragma omp for
+			for (int t = 0; t < tiles; ++t)
+			{
+				const int tile = first_tile + t;
+				const int y0 = (tile / tiles_w) * M;
+				const int x0 = (tile % tiles_w) * M;
+
+				// tmp = A^T M
+				for (int i = 0; i < M; ++i)
+				{
+					for (int j = 0; j < alpha; ++j)
+					{
+						float * dst = tmp.data() + (i * alpha + j) * channels;
+						std::fill(dst, dst + channels, 0.0f);
+						for (int p = 0; p < alpha; ++p)
+						{
+							const float coefficient = W::AT[i][p];
+							if (coefficient != 0.0f)
+							{
+								const float * src = m + (static_cast<size_t>(p * alpha + j) * tiles + t) * channels;
+								for (int k = 0; k < channels; ++k)
+								{
+									dst[k] += coefficient * src[k];
+								}
+							}
+						}
+					}
+				}
+
+				// Y = tmp A
+				for (int i = 0; i < M; ++i)
+				{
+					for (int j = 0; j < M; ++j)
+					{
+						float * dst = y.data() + (i * M + j) * channels;
+						std::fill(dst, dst + channels, 0.0f);
+						for (int p = 0; p < alpha; ++p)
+						{
+							const float coefficient = W::AT[j][p];
+							if (coefficient != 0.0f)
+							{
+								const float * src = tmp.data() + (i * alpha + p) * channels;
+								for (int k = 0; k < channels; ++k)
+								{
+									dst[k] += coefficient * src[k];
+								}
+							}
+						}
+					}
+				}
+
+				// write the part of the tile which falls within the output
+				for (int i = 0; i < M and y0 + i < l.out_h; ++i)
+				{
+					for (int j = 0; j < M and x0 + j < l.out_w; ++j)
+					{
+						const float * src = y.data() + (i * M + j) * channels;
+						float * dst = output + (y0 + i) * l.out_w + x0 + j;
+						for (int k = 0; k < channels; ++k)
+						{
+							dst[k * plane_size] = src[k];
+						}
+					}
+				}
+			}
+		}
+
+		return;
+	}
+
+
+	template <int M>
+	static void forward_winograd(const Darknet::Layer & l, const float * input, float * output, float * workspace)
+	{
+		TAT(TATPARMS);
+
+		const int alpha		= Winograd<M>::alpha;
+		const int tiles_w	= (l.out_w + M - 1) / M;
+		const int tiles_h	= (l.out_h + M - 1) / M;
+		const int tiles		= tiles_w * tiles_h;
+
+		for (int first_tile = 0; first_tile < tiles; first_tile += tiles_per_block)
+		{
+			const int block = std::min(tiles_per_block, tiles - first_tile);
+
+			float * v = workspace;
+			float * m = v + static_cast<size_t>(alpha) * alpha * l.c * block;
+
+			transform_input<M>(l, input, tiles_w, first_tile, block, v);
+
+			std::fill(m, m + static_cast<size_t>(alpha) * alpha * l.n * block, 0.0f);
+			for (int xi = 0; xi < alpha * alpha; ++xi)
+			{
+				gemm(0, 0, block, l.n, l.c, 1.0f,
+					v					+ static_cast<size_t>(xi) * block * l.c, l.c,
+					l.winograd_weights	+ static_cast<size_t>(xi) * l.c * l.n, l.n,
+					1.0f,
+					m					+ static_cast<size_t>(xi) * block * l.n, l.n);
+			}
+
+			transform_output<M>(l, m, tiles_w, first_tile, block, output);
+		}
+
+		return;
+	}
+
+
+	/// Decide which algorithm to use for this layer.  Anything unusual is left with the original im2col + GEMM.
+	static Darknet::EConvolutionAlgorithm choose_algorithm(const Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+		// layers with int8 scales can use any stride or dilation since they go through im2col
+		if (l.type					== Darknet::ELayerType::CONVOLUTIONAL	and
+			l.groups				== 1									and
+			l.int8_input_scale		> 0.0f									and
+			l.int8_weight_scales	!= nullptr								and
+			not l.binary													and
+			not l.xnor														and
+			not l.antialiasing												and
+			not l.deform													and
+			not l.share_layer												and
+			not l.batch_normalize											and
+			not l.train														)
+		{
+			return Darknet::EConvolutionAlgorithm::kInt8;
+		}
+
+		if (l.type		!= Darknet::ELayerType::CONVOLUTIONAL	or
+			l.groups	!= 1									or
+			l.stride_x	!= 1									or
+			l.stride_y	!= 1									or
+			l.dilation	!= 1									or
+			l.binary											or
+			l.xnor												or
+			l.antialiasing										or
+			l.deform											or
+			l.share_layer										or
+			l.batch_normalize									or
+			l.train												)
+		{
+			return Darknet::EConvolutionAlgorithm::kIm2col;
+		}
+
+		if (l.size == 1)
+		{
+			return Darknet::EConvolutionAlgorithm::kDirect1x1;
+		}
+
+		/* With only a few channels the transformations cost more than what is saved in the multiplications, and small
+		 * images don't have enough tiles to keep the matrix multiplications efficient.  Larger tiles save more work, so
+		 * F(2x2,3x3) is only used when there are not enough 4x4 tiles.
+		 */
+		if (l.size == 3 and l.c >= 32 and l.n >= 32)
+		{
+			if (l.out_w >= 32 and l.out_h >= 32)
+			{
+				return Darknet::EConvolutionAlgorithm::kWinograd4x4;
+			}
+			if (l.out_w >= 16 and l.out_h >= 16)
+			{
+				return Darknet::EConvolutionAlgorithm::kWinograd2x2;
+			}
+		}
+
+		return Darknet::EConvolutionAlgorithm::kIm2col;
+	}
+}
+
+
+size_t get_winograd_workspace_size(const Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	if (not is_winograd(l.conv_algorithm))
+	{
+		return 0;
+	}
+
+	const int tile	= winograd_tile_size(l.conv_algorithm);
+	const int alpha	= tile + 2;
+	const int tiles	= ((l.out_w + tile - 1) / tile) * ((l.out_h + tile - 1) / tile);
+	const int block	= std::min(tiles, tiles_per_block);
+
+	return static_cast<size_t>(alpha) * alpha * (l.c + l.n) * block * sizeof(float);
+}
+
+
+void forward_convolutional_layer_winograd(const Darknet::Layer & l, const float * input, float * output, float * workspace)
+{
+	TAT(TATPARMS);
+
+	if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kWinograd4x4)
+	{
+		forward_winograd<4>(l, input, output, workspace);
+	}
+	else
+	{
+		forward_winograd<2>(l, input, output, workspace);
+	}
+
+	return;
+}
+
+
+void select_convolution_algorithms(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (cfg_and_state.gpu_index >= 0)
+	{
+		if (cfg_and_state.is_set("int8"))
+		{
+			Darknet::display_warning_msg("The int8 quantized layers are only used when running on the CPU.\n");
+		}
+		if (cfg_and_state.is_set("nhwc"))
+		{
+			Darknet::display_warning_msg("The NHWC layout is only used when running on the CPU.\n");
+		}
+		return;
+	}
+
+	if (cfg_and_state.is_set("int8") and net.details and not net.details->weights_path.empty())
+	{
+		Darknet::load_int8_scales(net);
+	}
+
+	size_t original_workspace_size	= 0;
+	size_t workspace_size			= 0;
+	int direct_layers				= 0;
+	int winograd_layers				= 0;
+	int int8_layers					= 0;
+	int nhwc_layers					= 0;
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		Darknet::Layer & l = net.layers[i];
+
+		original_workspace_size = std::max(original_workspace_size, l.workspace_size);
+
+		// the layouts are decided again below
+		l.input_layout	= Darknet::ETensorLayout::kNCHW;
+		l.output_layout	= Darknet::ETensorLayout::kNCHW;
+
+		if (l.type == Darknet::ELayerType::CONVOLUTIONAL)
+		{
+			if (l.winograd_weights)
+			{
+				free(l.winograd_weights);
+				l.winograd_weights = nullptr;
+			}
+			if (l.nhwc_weights)
+			{
+				free(l.nhwc_weights);
+				l.nhwc_weights = nullptr;
+			}
+
+			l.conv_algorithm = choose_algorithm(l);
+			if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kWinograd4x4)
+			{
+				l.winograd_weights = transform_weights<4>(l);
+			}
+			else if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kWinograd2x2)
+			{
+				l.winograd_weights = transform_weights<2>(l);
+			}
+			else if (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kInt8)
+			{
+				quantize_convolutional_weights(l);
+			}
+
+			l.workspace_size = get_convolutional_workspace_size(l);
+		}
+	}
+
+	if (cfg_and_state.is_set("nhwc"))
+	{
+		Darknet::convert_network_to_nhwc(net);
+	}
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+
+		if (l.type == Darknet::ELayerType::CONVOLUTIONAL)
+		{
+			direct_layers	+= (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kDirect1x1	? 1 : 0);
+			winograd_layers	+= (is_winograd(l.conv_algorithm)									? 1 : 0);
+			int8_layers		+= (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kInt8		? 1 : 0);
+			nhwc_layers		+= (l.conv_algorithm == Darknet::EConvolutionAlgorithm::kNHWC		? 1 : 0);
+		}
+
+		workspace_size = std::max(workspace_size, l.workspace_size);
+	}
+
+	if (workspace_size != original_workspace_size)
+	{
+		free(net.workspace);
+		net.workspace = nullptr;
+		if (workspace_size)
+		{
+			net.workspace = (float*)xcalloc(1, workspace_size);
+		}
+		if (net.details)
+		{
+			net.details->workspace_size = workspace_size;
+		}
+	}
+
+	if (cfg_and_state.is_verbose)
+	{
+		*cfg_and_state.output
+			<< "Convolutional layers using Winograd: " << winograd_layers << ", direct 1x1: " << direct_layers << ", int8: " << int8_layers << ", NHWC: " << nhwc_layers
+			<< ", workspace reduced from " << size_to_IEC_string(original_workspace_size)
+			<< " to " << size_to_IEC_string(workspace_size) << "." << std::endl;
+	}
+
+	return;
+}
@@ -129,6 +129,172 @@ namespace
 
 		return;
 	}
+
+	/** Resize the BGR (or BGRA) image to the network dimensions and write it to @p output in %Darknet's planar RGB
+	 * format.  The @p output buffer must have room for @p "net->w * net->h * net->c" floats.
+	 */
+	static inline void mat_to_network_input(const Darknet::Network * net, const cv::Mat & mat, float * output)
+	{
+		TAT(TATPARMS);
+
+		// Note that INTER_NEAREST gives us *speed*, not image quality.
+		//
+		// If quality matters, you'll want to resize the image yourself
+		// using INTER_AREA, INTER_CUBIC or INTER_LINEAR prior to calling
+		// predict().  See DarkHelp or OpenCV documentation for details.
+
+		if (net->c == 3 and mat.depth() == CV_8U and (mat.channels() == 3 or mat.channels() == 4))
+		{
+			// resize, swap channels, and normalize in a single pass without any temporary images
+			Darknet::bgr_mat_to_planar_rgb(mat, output, net->w, net->h, cv::INTER_NEAREST);
+			return;
+		}
+
+		// anything else we currently assume is BGR and let OpenCV deal with it
+		const cv::Size network_dimensions(net->w, net->h);
+		cv::Mat bgr;
+		if (mat.size() != network_dimensions)
+		{
+			cv::resize(mat, bgr, network_dimensions, cv::INTER_NEAREST);
+		}
+		else
+		{
+			bgr = mat;
+		}
+
+		Darknet::Image img = Darknet::bgr_mat_to_rgb_image(bgr);
+		if (img.w != net->w or img.h != net->h or img.c != net->c)
+		{
+			Darknet::free_image(img);
+			throw std::invalid_argument("image does not match the network dimensions");
+		}
+		std::memcpy(output, img.data, sizeof(float) * img.w * img.h * img.c);
+		Darknet::free_image(img);
+
+		return;
+	}
+
+	/** Apply non-maximal suppression to the detections returned by %Darknet, and convert the results to the simplified
+	 * @ref Darknet::Prediction structure.
+	 */
+	static inline Darknet::Predictions detections_to_predictions(Darknet::Network * net, Darknet::Detection * darknet_results, const int nboxes, const cv::Size & original_image_size)
+	{
+		TAT(TATPARMS);
+
+		if (net->details->non_maximal_suppression_threshold)
+		{
+			auto & layer = net->layers[net->n - 1];
+			do_nms_fused(darknet_results, nboxes, layer.classes, net->details->non_maximal_suppression_threshold, DEFAULT_NMS, 0.0f);
+		}
+
+		Darknet::Predictions predictions;
+		predictions.reserve(nboxes); // this is likely too many (depends on the detection threshold) but gets us in the ballpark
+
+		for (int detection_idx = 0; detection_idx < nboxes; detection_idx ++)
+		{
+			auto & det = darknet_results[detection_idx];
+
+			/* The "det" object has an array called det.prob[].  That array is large enough for 1 entry per class in the network.
+			 * Each entry will be set to 0.0f, except for the ones that correspond to the class that was detected.  Note that it
+			 * is possible that multiple entries are non-zero!  We need to look at every entry and remember which ones are set.
+			 */
+
+			Darknet::Prediction pred;
+			pred.best_class = -1;
+
+			for (int class_idx = 0; class_idx < det.classes; class_idx ++)
+			{
+				const auto probability = det.prob[class_idx];
+				if (probability >= net->details->detection_threshold)
+				{
+					// remember this probability since it is higher than the user-specified threshold
+					pred.prob[class_idx] = probability;
+					if (pred.best_class == -1 or probability > det.prob[pred.best_class])
+					{
+						pred.best_class = class_idx;
+					}
+				}
+			}
+
+			// most of the output from Darknet/YOLO will have a confidence of 0.0f which we need to completely ignore
+			if (pred.best_class == -1)
+			{
+				continue;
+			}
+
+			// optional:  sometimes there are classes we want to completely ignore
+			if (net->details->classes_to_ignore.count(pred.best_class))
+			{
+				continue;
+			}
+
+			if (net->details->fix_out_of_bound_normalized_coordinates)
+			{
+				fix_out_of_bound_normalized_rect(det.bbox.x, det.bbox.y, det.bbox.w, det.bbox.h);
+			}
+
+			const int w = std::round(det.bbox.w * original_image_size.width				);
+			const int h = std::round(det.bbox.h * original_image_size.height			);
+			const int x = std::round(det.bbox.x * original_image_size.width	- w / 2.0f	);
+			const int y = std::round(det.bbox.y * original_image_size.height- h / 2.0f	);
+
+			pred.rect				= cv::Rect(cv::Point(x, y), cv::Size(w, h));
+			pred.normalized_point	= cv::Point2f(det.bbox.x, det.bbox.y);
+			pred.normalized_size	= cv::Size2f(det.bbox.w, det.bbox.h);
+
+			predictions.push_back(pred);
+		}
+
+		return predictions;
+	}
+
+
+	/// Turns on lazy decoding of the [yolo] output for as long as this object exists, even if an exception is thrown.
+	struct LazyYoloOutput final
+	{
+		Darknet::NetworkDetails & details;
+
+		LazyYoloOutput(Darknet::NetworkDetails & nd) : details(nd)
+		{
+			details.lazy_yolo_output = true;
+		}
+
+		~LazyYoloOutput()
+		{
+			details.lazy_yolo_output = false;
+		}
+	};
+
+
+	/// Run the neural network on a single image which is already in the network input format.
+	static inline Darknet::Predictions predict_network_input(Darknet::Network * net, float * input, const cv::Size & original_image_size)
+	{
+		TAT(TATPARMS);
+
+		// a previous call to the batched predict() may have changed the batch size, but we only have 1 image
+		if (net->batch != 1)
+		{
+			set_batch_network(net, 1);
+		}
+
+		/* The detections are extracted right away by get_yolo_detections_v3(), which decodes the few cells with an object
+		 * directly from the input of each [yolo] layer.  Nothing else may see the incomplete output, so lazy decoding is
+		 * only turned on for the duration of this call.
+		 */
+		int nboxes = 0;
+		Darknet::Detection * darknet_results = nullptr;
+		if (true)
+		{
+			LazyYoloOutput lazy(*net->details);
+			network_predict(*net, input); /// todo pass net by ref or pointer, not copy constructor!
+
+			const float hierarchy_threshold = 0.5f;
+			// the detections belong to the network's detection pool, so there is no need to call free_detections()
+			darknet_results = get_network_boxes_pooled(net, net->w, net->h, net->details->detection_threshold, hierarchy_threshold, 0, 1, &nboxes, 0);
+		}
+
+		return detections_to_predictions(net, darknet_results, nboxes, original_image_size);
+	}
 }
 
 
@@ -1145,6 +1311,9 @@ Darknet::NetworkPtr Darknet::load_neural_network(const std::filesystem::path & c
 
 	NetworkPtr ptr = load_network_custom(cfg_filename.string().c_str(), weights_filename.string().c_str(), 0, 1);
 
+	// this network is only used for inference, so the layer outputs can share memory
+	plan_activation_memory(*reinterpret_cast<Darknet::Network *>(ptr));
+
 	if (not names_filename.empty())
 	{
 		Darknet::load_names(ptr, names_filename);
@@ -1276,40 +1445,12 @@ Darknet::Predictions Darknet::predict(const Darknet::NetworkPtr ptr, const cv::M
 		throw std::invalid_argument("cannot predict without a valid image");
 	}
 
-	const cv::Size network_dimensions(net->w, net->h);
-	const cv::Size original_image_size = mat.size();
-
-	cv::Mat bgr;
-	if (mat.size() != network_dimensions)
-	{
-		// Note that INTER_NEAREST gives us *speed*, not image quality.
-		//
-		// If quality matters, you'll want to resize the image yourself
-		// using INTER_AREA, INTER_CUBIC or INTER_LINEAR prior to calling
-		// predict().  See DarkHelp or OpenCV documentation for details.
-
-		cv::resize(mat, bgr, network_dimensions, cv::INTER_NEAREST);
-	}
-	else
-	{
-		bgr = mat;
-	}
-
-	// OpenCV uses BGR, but Darknet requires RGB
-	Darknet::Image img;
-	if (bgr.channels() == 4)
-	{
-		cv::Mat rgb;
-		cv::cvtColor(bgr, rgb, cv::COLOR_BGRA2RGB);
-		img = rgb_mat_to_rgb_image(rgb);
-	}
-	else
-	{
-		// anything else we currently assume is 3-channel BGR
-		img = bgr_mat_to_rgb_image(bgr);
-	}
+	// the image is converted directly into the network input buffer which is re-used from one call to the next
+	auto & input = net->details->input_buffer;
+	input.resize(static_cast<size_t>(net->w) * net->h * net->c);
+	mat_to_network_input(net, mat, input.data());
 
-	return predict(ptr, img, original_image_size);
+	return predict_network_input(net, input.data(), mat.size());
 }
 
 
@@ -1328,95 +1469,95 @@ Darknet::Predictions Darknet::predict(Darknet::NetworkPtr ptr, Darknet::Image &
 	if (original_image_size.width	< 1) original_image_size.width	= img.w;
 	if (original_image_size.height	< 1) original_image_size.height	= img.h;
 
-	network_predict(*net, img.data); /// todo pass net by ref or pointer, not copy constructor!
+	auto predictions = predict_network_input(net, img.data, original_image_size);
 	Darknet::free_image(img);
 
-	int nboxes = 0;
-	const float hierarchy_threshold = 0.5f;
-	auto darknet_results = get_network_boxes(net, img.w, img.h, net->details->detection_threshold, hierarchy_threshold, 0, 1, &nboxes, 0);
+	return predictions;
+}
+
+
+Darknet::Predictions Darknet::predict(const Darknet::NetworkPtr ptr, const std::filesystem::path & image_filename)
+{
+	TAT(TATPARMS);
 
-	if (net->details->non_maximal_suppression_threshold)
+	if (not std::filesystem::exists(image_filename))
 	{
-		auto & layer = net->layers[net->n - 1];
-		do_nms_sort(darknet_results, nboxes, layer.classes, net->details->non_maximal_suppression_threshold);
+		throw std::invalid_argument("cannot predict due to invalid image filename: \"" + image_filename.string() + "\"");
 	}
 
-	Predictions predictions;
-	predictions.reserve(nboxes); // this is likely too many (depends on the detection threshold) but gets us in the ballpark
+	cv::Mat mat = cv::imread(image_filename.string());
 
-	for (int detection_idx = 0; detection_idx < nboxes; detection_idx ++)
-	{
-		auto & det = darknet_results[detection_idx];
+	return predict(ptr, mat);
+}
 
-		/* The "det" object has an array called det.prob[].  That array is large enough for 1 entry per class in the network.
-		 * Each entry will be set to 0.0f, except for the ones that correspond to the class that was detected.  Note that it
-		 * is possible that multiple entries are non-zero!  We need to look at every entry and remember which ones are set.
-		 */
 
-		Prediction pred;
-		pred.best_class = -1;
+std::vector<Darknet::Predictions> Darknet::predict(const Darknet::NetworkPtr ptr, const std::vector<cv::Mat> & mats)
+{
+	TAT(TATPARMS);
 
-		for (int class_idx = 0; class_idx < det.classes; class_idx ++)
-		{
-			const auto probability = det.prob[class_idx];
-			if (probability >= net->details->detection_threshold)
-			{
-				// remember this probability since it is higher than the user-specified threshold
-				pred.prob[class_idx] = probability;
-				if (pred.best_class == -1 or probability > det.prob[pred.best_class])
-				{
-					pred.best_class = class_idx;
-				}
-			}
-		}
+	Darknet::Network * net = reinterpret_cast<Darknet::Network *>(ptr);
+	if (net == nullptr)
+	{
+		throw std::invalid_argument("cannot predict without a network pointer");
+	}
 
-		// most of the output from Darknet/YOLO will have a confidence of 0.0f which we need to completely ignore
-		if (pred.best_class == -1)
-		{
-			continue;
-		}
+	std::vector<Predictions> results;
+	if (mats.empty())
+	{
+		return results;
+	}
 
-		// optional:  sometimes there are classes we want to completely ignore
-		if (net->details->classes_to_ignore.count(pred.best_class))
+	for (const auto & mat : mats)
+	{
+		if (mat.empty())
 		{
-			continue;
+			throw std::invalid_argument("cannot predict without a valid image");
 		}
+	}
 
-		if (net->details->fix_out_of_bound_normalized_coordinates)
+	const int batch_size = static_cast<int>(mats.size());
+	if (batch_size == 1)
+	{
+		// no need to go through the batch logic if we only have a single image
+		results.push_back(predict(ptr, mats[0]));
+		return results;
+	}
+
+	// the layer outputs were allocated for a specific batch size; a smaller batch can re-use them, but a larger one
+	// means all the layers must be re-allocated
+	if (net->batch != batch_size)
+	{
+		set_batch_network(net, batch_size);
+		if (batch_size > net->details->allocated_batch)
 		{
-			fix_out_of_bound_normalized_rect(det.bbox.x, det.bbox.y, det.bbox.w, det.bbox.h);
+			resize_network(net, net->w, net->h);
 		}
-
-		const int w = std::round(det.bbox.w * original_image_size.width				);
-		const int h = std::round(det.bbox.h * original_image_size.height			);
-		const int x = std::round(det.bbox.x * original_image_size.width	- w / 2.0f	);
-		const int y = std::round(det.bbox.y * original_image_size.height- h / 2.0f	);
-
-		pred.rect				= cv::Rect(cv::Point(x, y), cv::Size(w, h));
-		pred.normalized_point	= cv::Point2f(det.bbox.x, det.bbox.y);
-		pred.normalized_size	= cv::Size2f(det.bbox.w, det.bbox.h);
-
-		predictions.push_back(pred);
 	}
 
-	free_detections(darknet_results, nboxes);
+	// pack all of the images into a single input tensor, one image after the other
+	const size_t image_size = static_cast<size_t>(net->w) * net->h * net->c;
+	auto & input = net->details->input_buffer;
+	input.resize(image_size * batch_size);
 
-	return predictions;
-}
+	for (int idx = 0; idx < batch_size; idx ++)
+	{
+		mat_to_network_input(net, mats[idx], input.data() + idx * image_size);
+	}
 
+	network_predict(*net, input.data());
 
-Darknet::Predictions Darknet::predict(const Darknet::NetworkPtr ptr, const std::filesystem::path & image_filename)
-{
-	TAT(TATPARMS);
+	results.reserve(batch_size);
+	const float hierarchy_threshold = 0.5f;
 
-	if (not std::filesystem::exists(image_filename))
+	for (int idx = 0; idx < batch_size; idx ++)
 	{
-		throw std::invalid_argument("cannot predict due to invalid image filename: \"" + image_filename.string() + "\"");
-	}
+		int nboxes = 0;
+		auto darknet_results = get_network_boxes_batch_pooled(net, net->w, net->h, net->details->detection_threshold, hierarchy_threshold, nullptr, 1, &nboxes, 0, idx);
 
-	cv::Mat mat = cv::imread(image_filename.string());
+		results.push_back(detections_to_predictions(net, darknet_results, nboxes, mats[idx].size()));
+	}
 
-	return predict(ptr, mat);
+	return results;
 }
 
 
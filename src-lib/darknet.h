@@ -184,12 +184,14 @@ typedef struct DarknetImage
 #ifdef DARKNET_INCLUDE_ORIGINAL_API
 
 /// @see @ref diounms_sort()
+/// @see @ref do_nms_fused()
 typedef enum
 {
 	DEFAULT_NMS	,
 	GREEDY_NMS	,
 	DIOU_NMS	,
-	CORNERS_NMS
+	CORNERS_NMS	,
+	OBJECTNESS_NMS	///< Ignore classes and only use objectness.  Same as @ref do_nms_obj().
 } NMS_KIND;
 
 /// Bounding box used with normalized coordinates (between 0.0 and 1.0).
@@ -15,9 +15,11 @@
 
 #include <atomic>
 #include <ciso646>
+#include <condition_variable>
 #include <filesystem>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <set>
@@ -425,6 +427,117 @@ namespace Darknet
 	 */
 	Predictions predict(const Darknet::NetworkPtr ptr, const std::filesystem::path & image_filename);
 
+	/** Get %Darknet to look at several images or video frames at once and return the predictions for each one.  The
+	 * results are returned in the same order as the input images, with exactly one @ref Predictions entry per image.
+	 *
+	 * All of the images are resized to the network dimensions and packed into a single input tensor, which is then sent
+	 * through the neural network in one batched forward pass.  This is typically faster than calling @ref predict() once
+	 * per image, especially on the CPU where the weights can be re-used across all the images in the batch.
+	 *
+	 * Similar to the other @ref Darknet::predict() that takes a single @p cv::Mat, the images are expected to be in the
+	 * usual OpenCV BGR format.
+	 *
+	 * @note The layers in the neural network are re-allocated when the number of images grows past the largest batch
+	 * seen so far.  Smaller batches re-use the existing layers.
+	 *
+	 * @since 2026-10-17
+	 */
+	std::vector<Predictions> predict(const Darknet::NetworkPtr ptr, const std::vector<cv::Mat> & mats);
+
+	/** A set of neural networks which can be used to run predictions concurrently from multiple threads.  A single
+	 * @ref Darknet::NetworkPtr cannot be used by more than one thread at a time, since the layer outputs and other
+	 * buffers are stored within the network.
+	 *
+	 * The weights are only loaded once.  Every replica in the pool shares the read-only weights, biases, and batchnorm
+	 * parameters of the first network, and only owns the memory needed to run predictions.  So a pool of 16 replicas
+	 * does @em not need 16 times the memory for the weights.
+	 *
+	 * Use it like this:
+	 *
+	 * ~~~~
+	 *     Darknet::NetworkPool pool(cfg, names, weights, 8);
+	 *
+	 *     // ...then from any number of threads:
+	 *     const auto results = pool.predict(mat);
+	 *
+	 *     // ...or if more than 1 call is needed with the same network:
+	 *     auto lease = pool.acquire();
+	 *     const auto results = Darknet::predict(lease, mat);
+	 *     Darknet::annotate(lease, results, mat);
+	 * ~~~~
+	 *
+	 * @note Each replica runs on the thread which acquired it.  When using many replicas on the CPU, consider reducing
+	 * the number of OpenMP threads used within each prediction, such as by setting @p OMP_NUM_THREADS.
+	 *
+	 * @since 2026-10-17
+	 */
+	class NetworkPool final
+	{
+		public:
+
+			/** A replica which has been handed out by @ref NetworkPool::acquire().  The replica is automatically returned
+			 * to the pool when the lease goes out of scope.  The lease converts to a @ref Darknet::NetworkPtr so it can be
+			 * passed to the usual functions such as @ref Darknet::predict() and @ref Darknet::annotate().
+			 */
+			class Lease final
+			{
+				public:
+
+					Lease(NetworkPool & pool, Darknet::NetworkPtr ptr);
+					Lease(Lease && rhs);
+					Lease(const Lease &) = delete;
+					Lease & operator=(const Lease &) = delete;
+					~Lease();
+
+					Darknet::NetworkPtr get() const { return ptr; }
+					operator Darknet::NetworkPtr() const { return ptr; }
+
+				private:
+
+					NetworkPool * pool;
+					Darknet::NetworkPtr ptr;
+			};
+
+			/// Load the neural network and create a total of @p replicas networks.
+			NetworkPool(const std::filesystem::path & cfg_filename, const std::filesystem::path & names_filename, const std::filesystem::path & weights_filename, const size_t replicas);
+
+			/** Take ownership of a neural network obtained from @ref Darknet::load_neural_network() and create a total of
+			 * @p replicas networks.  Settings such as the detection threshold and class colours are copied from @p ptr,
+			 * which will be set to @p nullptr since it now belongs to the pool.
+			 */
+			NetworkPool(Darknet::NetworkPtr & ptr, const size_t replicas);
+
+			NetworkPool(const NetworkPool &) = delete;
+			NetworkPool & operator=(const NetworkPool &) = delete;
+
+			/// Wait for all the leases to be returned, and then free all of the networks.
+			~NetworkPool();
+
+			/// The total number of networks in the pool, including those which are currently in use.
+			size_t size() const { return networks.size(); }
+
+			/** All of the networks in the pool.  This can be used to change settings, such as calling
+			 * @ref Darknet::set_detection_threshold() on every network.  Do not use these to make predictions.
+			 */
+			const std::vector<Darknet::NetworkPtr> & all() const { return networks; }
+
+			/// Get a network from the pool.  This will block until one is available.
+			Lease acquire();
+
+			/// Convenience function to call @ref Darknet::predict() with a network from the pool.
+			Predictions predict(const cv::Mat & mat);
+
+		private:
+
+			void create_replicas(const size_t replicas);
+			void release(Darknet::NetworkPtr ptr);
+
+			std::mutex mutex;
+			std::condition_variable trigger;
+			std::vector<Darknet::NetworkPtr> networks;	///< the first network owns the weights, the others are replicas
+			std::vector<Darknet::NetworkPtr> available;	///< networks which are not currently leased
+	};
+
 	/** Annotate the given image using the predictions from @ref Darknet::predict().
 	 *
 	 * @see @ref Darknet::predict_and_annotate()
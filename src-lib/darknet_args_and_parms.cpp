@@ -122,6 +122,10 @@ const Darknet::SArgsAndParms & Darknet::get_all_possible_arguments()
 	{
 		ArgsAndParms("3d"			, ArgsAndParms::EType::kCommand	, "Pass in 2 images as input."),
 		ArgsAndParms("average"		, ArgsAndParms::EType::kCommand	, ""),
+		ArgsAndParms("benchmarkaugment", ArgsAndParms::EType::kCommand	, "Benchmark the training data augmentation using synthetic images."),
+		ArgsAndParms("benchmarkgemm", ArgsAndParms::EType::kCommand	, "Benchmark the CPU matrix multiplication using the convolutional layers from a .cfg file."),
+		ArgsAndParms("benchmarknms"	, ArgsAndParms::EType::kCommand	, "Benchmark non-maximal suppression using synthetic crowded scenes."),
+		ArgsAndParms("benchmarkyolo", ArgsAndParms::EType::kCommand	, "Benchmark the YOLO objectness scan using synthetic YOLOv4-tiny and YOLOv7 output layers."),
 		ArgsAndParms("calcanchors"	, ArgsAndParms::EType::kFunction, "Recalculate YOLO anchors."),
 		ArgsAndParms("cfglayers"	, ArgsAndParms::EType::kCommand, "Display some information on all config files and layers used."),
 		ArgsAndParms("denormalize"	, ArgsAndParms::EType::kCommand	, ""),
@@ -134,11 +138,15 @@ const Darknet::SArgsAndParms & Darknet::get_all_possible_arguments()
 		ArgsAndParms("normalize"	, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("oneoff"		, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("ops"			, ArgsAndParms::EType::kCommand	, ""),
+		ArgsAndParms("pack"			, ArgsAndParms::EType::kFunction, "Pack all training images and annotations into a single file."),
 		ArgsAndParms("partial"		, ArgsAndParms::EType::kCommand	, ""),
+		ArgsAndParms("quantize"		, ArgsAndParms::EType::kFunction, "Calibrate int8 scales for CPU inference using the validation images, and report the change in mAP%."),
 		ArgsAndParms("recall"		, ArgsAndParms::EType::kFunction, ""),
 		ArgsAndParms("rescale"		, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("reset"		, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("rgbgr"		, ArgsAndParms::EType::kCommand	, ""),
+		ArgsAndParms("serve"		, ArgsAndParms::EType::kCommand	, "Load a neural network once and answer detection requests received on a Unix domain socket."),
+		ArgsAndParms("serveclient"	, ArgsAndParms::EType::kCommand	, "Send images to \"darknet serve\" and report throughput and latency."),
 		ArgsAndParms("speed"		, ArgsAndParms::EType::kCommand	, "Perform a quick test to see how fast the specified neural network runs."),
 		ArgsAndParms("statistics"	, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("test"			, ArgsAndParms::EType::kCommand	, ""),
@@ -161,6 +169,8 @@ const Darknet::SArgsAndParms & Darknet::get_all_possible_arguments()
 		ArgsAndParms("dontshow"		, "noshow"							, "Do not open a GUI window.  Especially useful when used on a headless server.  This will cause the output image to be saved to disk."),
 		ArgsAndParms("clear"		, ArgsAndParms::EType::kParameter	, "Used during training to reset the \"image count\" to zero, necessary when pre-existing weights are used."),
 		ArgsAndParms("map"			, ArgsAndParms::EType::kParameter	, "Regularly calculate mAP% score while training."),
+		ArgsAndParms("int8"			, ArgsAndParms::EType::kParameter	, "Run the layers quantized with \"darknet detector quantize\" using 8-bit integers on the CPU."),
+		ArgsAndParms("nhwc"			, ArgsAndParms::EType::kParameter	, "Store the output of the CPU layers with the channels last (NHWC) during inference."),
 
 		ArgsAndParms("camera"	, "c"			, 0		, "The camera (webcam) index, where numbering is typically sequential and begins with zero."),
 		ArgsAndParms("thresh"	, "threshold"	, 0.24f	),
@@ -190,10 +200,20 @@ const Darknet::SArgsAndParms & Darknet::get_all_possible_arguments()
 		ArgsAndParms("numofclusters"		, "", 6		, "The number of YOLO anchors in the configuration. --num_of_clusters 6"	),
 		ArgsAndParms("width"				, "", 416	, "The width of the network.  --width 416"									),
 		ArgsAndParms("height"				, "", 416	, "The height of the network.  --width 416"									),
+		ArgsAndParms("maxbatch"				, "", 8		, "The maximum batch size used by \"darknet serve\".  --max-batch 8"			),
+		ArgsAndParms("maxwait"				, "", 5		, "Milliseconds \"darknet serve\" waits to fill a batch.  --max-wait 5"			),
+		ArgsAndParms("requests"				, "", 100	, "Number of requests sent by \"darknet serve_client\".  --requests 100"		),
+		ArgsAndParms("connections"			, "", 4		, "Concurrent connections used by \"darknet serve_client\".  --connections 4"	),
+		ArgsAndParms("numanode"				, "", -1	, "The NUMA node used with --affinity.  Default is the node where Darknet started."),
+		ArgsAndParms("loadercores"			, "", 0		, "Number of CPUs reserved for image loading with --affinity.  Default is automatic."),
+		ArgsAndParms("seed"					, "", 0		, "Seed used for data augmentation while training, to reproduce the same batches.  Default is a random seed."),
+		ArgsAndParms("calibration"			, "", 200	, "Number of validation images used by \"darknet detector quantize\".  --calibration 200"),
 
 		// hack:  parameters that take a string need a default parameter of <space>; see CfgAndState::process_arguments()
 		ArgsAndParms("skipclasses"			, "", " "	, "Class indexes which Darknet should skip when returning results or annotating images.  --skip-classes=2,5-8"),
 		ArgsAndParms("log"					, "", " "	, "File to which Darknet/YOLO messages are logged.  Default is to use STDOUT."),
+		ArgsAndParms("socket"				, "", " "	, "Unix domain socket used by \"darknet serve\".  Default is /tmp/darknet.sock."),
+		ArgsAndParms("affinity"				, "", " "	, "Place threads on specific CPU cores:  \"none\" (default), \"split\" to keep image loading and compute threads apart, or \"node\" to also stay on one NUMA node."),
 		ArgsAndParms("gpus"					, "", " "	, "The index of the GPU to use. Multiple GPUs can be specified, such as -gpus 0,1"),
 	};
 
@@ -0,0 +1,712 @@
+#include "darknet_internal.hpp"
+#include "darknet_benchmark.hpp"
+#include "gemm.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// The size of a YOLO output layer, such as 13x13 with 3 anchors and 80 classes.
+	struct YoloShape
+	{
+		int w;
+		int h;
+		int n;
+		int classes;
+	};
+
+
+	/// Similar to the structure that used to be stored in @ref Darknet::Output_Object_Cache.
+	struct LegacyObject
+	{
+		int layer_index;
+		int n;
+		int i;
+		int obj_index;
+	};
+
+
+	/// Fake YOLO output where the objectness plane of each anchor is mostly empty, like a typical image.
+	static Darknet::VFloat create_yolo_output(const YoloShape & shape, std::mt19937 & rng)
+	{
+		TAT(TATPARMS);
+
+		const int plane_size = shape.w * shape.h;
+		Darknet::VFloat output(shape.n * plane_size * (4 + 1 + shape.classes), 0.0f);
+
+		std::normal_distribution<float> logit(-7.0f, 2.5f);
+		for (int n = 0; n < shape.n; ++n)
+		{
+			float * plane = output.data() + n * plane_size * (4 + 1 + shape.classes) + 4 * plane_size;
+			for (int i = 0; i < plane_size; ++i)
+			{
+				plane[i] = 1.0f / (1.0f + std::exp(-logit(rng)));
+			}
+		}
+
+		return output;
+	}
+
+
+	/// This is how @ref yolo_num_detections_v3() used to find objects prior to the SIMD compaction.
+	static int legacy_scan(const YoloShape & shape, const float * output, const float thresh, std::list<LegacyObject> & cache)
+	{
+		TAT(TATPARMS);
+
+		const int plane_size = shape.w * shape.h;
+
+		int count = 0;
+		for (int n = 0; n < shape.n; ++n)
+		{
+			for (int i = 0; i < plane_size; ++i)
+			{
+				const int location	= n * plane_size + i;
+				const int obj_index	= (location / plane_size) * plane_size * (4 + shape.classes + 1) + 4 * plane_size + location % plane_size;
+				if (output[obj_index] > thresh)
+				{
+					++count;
+					cache.push_back({0, n, i, obj_index});
+				}
+			}
+		}
+
+		return count;
+	}
+
+
+	/// Scan all the anchors in one layer with the given compaction function.  @returns the number of objects found.
+	template <typename F>
+	static int compact_scan(const YoloShape & shape, const float * output, const float thresh, int * indexes, F compact)
+	{
+		const int plane_size = shape.w * shape.h;
+
+		int count = 0;
+		for (int n = 0; n < shape.n; ++n)
+		{
+			const float * plane = output + n * plane_size * (4 + 1 + shape.classes) + 4 * plane_size;
+			count += compact(plane, plane_size, thresh, indexes + count, n * plane_size);
+		}
+
+		return count;
+	}
+
+
+	/// Detections which own their memory, so the same scene can be given to several NMS functions.
+	struct NmsScene
+	{
+		int classes = 0;
+		std::vector<Darknet::Detection> dets;
+		Darknet::VFloat probs;
+
+		NmsScene() = default;
+
+		NmsScene(const NmsScene & rhs)
+		{
+			*this = rhs;
+		}
+
+		NmsScene & operator=(const NmsScene & rhs)
+		{
+			classes	= rhs.classes;
+			dets	= rhs.dets;
+			probs	= rhs.probs;
+			for (size_t idx = 0; idx < dets.size(); ++idx)
+			{
+				dets[idx].prob = probs.data() + idx * classes;
+			}
+			return *this;
+		}
+	};
+
+
+	/** Create a crowded scene where each object was detected several times with slightly different boxes, like what
+	 * comes out of the YOLO layers prior to NMS.  The @p track_id is used to remember the original index.
+	 */
+	static NmsScene create_nms_scene(const int objects, const int classes, std::mt19937 & rng)
+	{
+		TAT(TATPARMS);
+
+		std::uniform_real_distribution<float> position(0.0f, 1.0f);
+		std::uniform_real_distribution<float> size(0.01f, 0.08f);
+		std::uniform_real_distribution<float> jitter(-0.15f, 0.15f);
+		std::uniform_real_distribution<float> confidence(0.0f, 1.0f);
+		std::uniform_int_distribution<int> duplicates(2, 8);
+		std::uniform_int_distribution<int> class_id(0, 4); // crowded scenes tend to have only a few classes (people, cars, ...)
+
+		struct Entry
+		{
+			Darknet::Box bbox;
+			float objectness;
+			int class_id;
+			float class_prob;
+			int other_class_id;
+			float other_class_prob;
+		};
+		std::vector<Entry> entries;
+
+		for (int obj = 0; obj < objects; ++obj)
+		{
+			const Darknet::Box truth = {position(rng), position(rng), size(rng), size(rng)};
+			const int k = class_id(rng);
+			const int count = duplicates(rng);
+			for (int dup = 0; dup < count; ++dup)
+			{
+				Entry entry;
+				entry.bbox.x			= truth.x + jitter(rng) * truth.w;
+				entry.bbox.y			= truth.y + jitter(rng) * truth.h;
+				entry.bbox.w			= truth.w * (1.0f + jitter(rng));
+				entry.bbox.h			= truth.h * (1.0f + jitter(rng));
+				entry.objectness		= 0.25f + 0.75f * confidence(rng);
+				entry.class_id			= k;
+				entry.class_prob		= 0.5f + 0.5f * confidence(rng);
+				entry.other_class_id	= class_id(rng);
+				entry.other_class_prob	= 0.5f * confidence(rng);
+				entries.push_back(entry);
+			}
+		}
+
+		NmsScene scene;
+		scene.classes = classes;
+		scene.dets.resize(entries.size());
+		scene.probs.assign(entries.size() * classes, 0.0f);
+
+		const float thresh = 0.25f;
+		for (size_t idx = 0; idx < entries.size(); ++idx)
+		{
+			const auto & entry = entries[idx];
+			auto & det = scene.dets[idx];
+			det = Darknet::Detection();
+			det.bbox		= entry.bbox;
+			det.classes		= classes;
+			det.objectness	= entry.objectness;
+			det.track_id	= static_cast<int>(idx);
+
+			// same as get_yolo_detections_v3(), only keep the class probabilities above the threshold
+			float * prob = scene.probs.data() + idx * classes;
+			det.prob = prob;
+			const float p1 = entry.objectness * entry.class_prob;
+			const float p2 = entry.objectness * entry.other_class_prob;
+			prob[entry.class_id]		= (p1 > thresh) ? p1 : 0.0f;
+			prob[entry.other_class_id]	= std::max(prob[entry.other_class_id], (p2 > thresh) ? p2 : 0.0f);
+		}
+
+		return scene;
+	}
+
+
+	/// The original NMS functions re-order the detections, so use the track ID to compare the results.
+	static bool same_nms_results(const NmsScene & original, const NmsScene & fused)
+	{
+		TAT(TATPARMS);
+
+		for (const auto & det : original.dets)
+		{
+			const auto & other = fused.dets[det.track_id];
+			if (det.objectness != other.objectness or std::memcmp(det.prob, other.prob, sizeof(float) * original.classes) != 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+
+	/// The shape of a matrix multiplication:  @p "C[M x N] += A[M x K] * B[K x N]".
+	struct GemmShape
+	{
+		int M;
+		int N;
+		int K;
+
+		bool operator<(const GemmShape & rhs) const
+		{
+			return std::tie(M, N, K) < std::tie(rhs.M, rhs.N, rhs.K);
+		}
+	};
+
+
+	/// Get the matrix shapes from the convolutional layers in the .cfg file, in the order in which they are used.
+	static std::vector<GemmShape> get_gemm_shapes(const std::filesystem::path & cfg_filename)
+	{
+		TAT(TATPARMS);
+
+		std::vector<GemmShape> shapes;
+		std::set<GemmShape> seen;
+
+		Darknet::Network net = parse_network_cfg_custom(cfg_filename.string().c_str(), 1, 1);
+		for (int i = 0; i < net.n; ++i)
+		{
+			const Darknet::Layer & l = net.layers[i];
+			if (l.type == Darknet::ELayerType::CONVOLUTIONAL)
+			{
+				const GemmShape shape = {l.n / l.groups, l.out_w * l.out_h, l.size * l.size * l.c / l.groups};
+				if (seen.insert(shape).second)
+				{
+					shapes.push_back(shape);
+				}
+			}
+		}
+		free_network(net);
+
+		return shapes;
+	}
+
+
+	/// Time @p count calls to @p func and return the GFLOP/s.
+	template <typename F>
+	static double measure_gflops(const GemmShape & shape, const int count, F && func)
+	{
+		TAT(TATPARMS);
+
+		func(); // warm up the caches and the packing buffers
+
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		for (int iteration = 0; iteration < count; ++iteration)
+		{
+			func();
+		}
+		const auto t2 = std::chrono::high_resolution_clock::now();
+
+		const double seconds	= std::chrono::duration<double>(t2 - t1).count();
+		const double flops		= 2.0 * shape.M * shape.N * shape.K * count;
+
+		return flops / seconds / 1.0e9;
+	}
+}
+
+
+void Darknet::benchmark_yolo()
+{
+	TAT(TATPARMS);
+
+	const float thresh		= 0.25f;
+	const int iterations	= 2000;
+
+	const std::map<std::string, std::vector<YoloShape>> networks =
+	{
+		{"YOLOv4-tiny (416x416)", {{13, 13, 3, 80}, {26, 26, 3, 80}}},
+		{"YOLOv7 (640x640)", {{80, 80, 3, 80}, {40, 40, 3, 80}, {20, 20, 3, 80}}},
+	};
+
+	std::mt19937 rng(1234);
+
+	*cfg_and_state.output
+		<< std::endl
+		<< "Benchmarking the YOLO objectness scan with " << iterations << " iterations and a threshold of " << thresh << "." << std::endl;
+
+	for (const auto & [name, shapes] : networks)
+	{
+		std::vector<Darknet::VFloat> outputs;
+		size_t cells = 0;
+		for (const auto & shape : shapes)
+		{
+			outputs.push_back(create_yolo_output(shape, rng));
+			cells += shape.w * shape.h * shape.n;
+		}
+
+		Darknet::VInt scalar_indexes(cells);
+		Darknet::VInt simd_indexes(cells);
+
+		int legacy_count	= 0;
+		int scalar_count	= 0;
+		int simd_count		= 0;
+
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			std::list<LegacyObject> cache;
+			legacy_count = 0;
+			for (size_t idx = 0; idx < shapes.size(); ++idx)
+			{
+				legacy_count += legacy_scan(shapes[idx], outputs[idx].data(), thresh, cache);
+			}
+		}
+
+		const auto t2 = std::chrono::high_resolution_clock::now();
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			scalar_count = 0;
+			for (size_t idx = 0; idx < shapes.size(); ++idx)
+			{
+				scalar_count += compact_scan(shapes[idx], outputs[idx].data(), thresh, scalar_indexes.data() + scalar_count, yolo_compact_objectness_scalar);
+			}
+		}
+
+		const auto t3 = std::chrono::high_resolution_clock::now();
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			simd_count = 0;
+			for (size_t idx = 0; idx < shapes.size(); ++idx)
+			{
+				simd_count += compact_scan(shapes[idx], outputs[idx].data(), thresh, simd_indexes.data() + simd_count, yolo_compact_objectness);
+			}
+		}
+		const auto t4 = std::chrono::high_resolution_clock::now();
+
+		const bool identical =
+			legacy_count == scalar_count and
+			scalar_count == simd_count and
+			std::equal(scalar_indexes.begin(), scalar_indexes.begin() + scalar_count, simd_indexes.begin());
+
+		const double legacy_us	= std::chrono::duration<double, std::micro>(t2 - t1).count() / iterations;
+		const double scalar_us	= std::chrono::duration<double, std::micro>(t3 - t2).count() / iterations;
+		const double simd_us	= std::chrono::duration<double, std::micro>(t4 - t3).count() / iterations;
+
+		*cfg_and_state.output
+			<< std::endl
+			<< Darknet::in_colour(Darknet::EColour::kBrightWhite, name) << ": " << shapes.size() << " YOLO layers, " << cells << " cells, " << simd_count << " objects" << std::endl
+			<< std::fixed << std::setprecision(3)
+			<< "-> list (original): " << legacy_us	<< " microseconds" << std::endl
+			<< "-> scalar compact:  " << scalar_us	<< " microseconds (" << (legacy_us / scalar_us)	<< "x)" << std::endl
+			<< "-> SIMD compact:    " << simd_us	<< " microseconds (" << (legacy_us / simd_us)	<< "x)" << std::endl
+			<< "-> results:         " << (identical ? Darknet::in_colour(Darknet::EColour::kBrightGreen, "identical") : Darknet::in_colour(Darknet::EColour::kBrightRed, "MISMATCH")) << std::endl;
+	}
+}
+
+
+void Darknet::benchmark_nms()
+{
+	TAT(TATPARMS);
+
+	const int classes	= 80;
+	const float thresh	= 0.45f;
+	const float beta1	= 0.6f;
+
+	const std::map<NMS_KIND, std::string> kinds =
+	{
+		{DEFAULT_NMS	, "do_nms_sort()"},
+		{GREEDY_NMS		, "diounms_sort(GREEDY_NMS)"},
+		{DIOU_NMS		, "diounms_sort(DIOU_NMS)"},
+		{OBJECTNESS_NMS	, "do_nms_obj()"},
+	};
+
+	std::mt19937 rng(1234);
+
+	*cfg_and_state.output
+		<< std::endl
+		<< "Benchmarking NMS with " << classes << " classes and a threshold of " << thresh << "." << std::endl;
+
+	for (const int objects : {50, 200, 500})
+	{
+		const NmsScene scene = create_nms_scene(objects, classes, rng);
+
+		*cfg_and_state.output
+			<< std::endl
+			<< Darknet::in_colour(Darknet::EColour::kBrightWhite, std::to_string(objects) + " objects") << ": " << scene.dets.size() << " detections" << std::endl;
+
+		for (const auto & [kind, name] : kinds)
+		{
+			NmsScene original	= scene;
+			NmsScene fused		= scene;
+			const int total		= static_cast<int>(scene.dets.size());
+
+			const auto t1 = std::chrono::high_resolution_clock::now();
+			if (kind == DEFAULT_NMS)
+			{
+				do_nms_sort(original.dets.data(), total, classes, thresh);
+			}
+			else if (kind == OBJECTNESS_NMS)
+			{
+				do_nms_obj(original.dets.data(), total, classes, thresh);
+			}
+			else
+			{
+				diounms_sort(original.dets.data(), total, classes, thresh, kind, beta1);
+			}
+
+			const auto t2 = std::chrono::high_resolution_clock::now();
+			do_nms_fused(fused.dets.data(), total, classes, thresh, kind, beta1);
+			const auto t3 = std::chrono::high_resolution_clock::now();
+
+			const double original_ms	= std::chrono::duration<double, std::milli>(t2 - t1).count();
+			const double fused_ms		= std::chrono::duration<double, std::milli>(t3 - t2).count();
+			const bool identical		= same_nms_results(original, fused);
+
+			*cfg_and_state.output
+				<< std::fixed << std::setprecision(3)
+				<< "-> " << std::setw(26) << std::left << name << std::right
+				<< " original: " << std::setw(10) << original_ms << " ms"
+				<< "   fused: " << std::setw(8) << fused_ms << " ms"
+				<< " (" << (original_ms / fused_ms) << "x)"
+				<< "   results: " << (identical ? Darknet::in_colour(Darknet::EColour::kBrightGreen, "identical") : Darknet::in_colour(Darknet::EColour::kBrightRed, "MISMATCH")) << std::endl;
+		}
+	}
+}
+
+
+void Darknet::benchmark_gemm()
+{
+	TAT(TATPARMS);
+
+	std::vector<GemmShape> shapes;
+	std::string name = "YOLOv4-tiny (416x416)";
+	if (not cfg_and_state.cfg_filename.empty())
+	{
+		name = cfg_and_state.cfg_filename.filename().string();
+		shapes = get_gemm_shapes(cfg_and_state.cfg_filename);
+	}
+	else
+	{
+		shapes =
+		{
+			{ 32, 43264,   27},
+			{ 64, 10816,  288},
+			{ 64, 10816,  576},
+			{ 32, 10816,  288},
+			{ 64, 10816,   64},
+			{128,  2704, 1152},
+			{ 64,  2704,  576},
+			{128,  2704,  128},
+			{256,   676, 2304},
+			{128,   676, 1152},
+			{256,   676,  256},
+			{512,   169, 4608},
+			{256,   169,  512},
+			{512,   169, 2304},
+			{255,   169,  512},
+			{128,   169,  256},
+			{256,   676, 3456},
+			{255,   676,  256},
+		};
+	}
+
+	const bool packed_supported	= gemm_packed_is_supported();
+	const bool avx512_supported	= packed_supported and is_avx512();
+
+	*cfg_and_state.output
+		<< std::endl
+		<< "Benchmarking " << shapes.size() << " matrix multiplications from " << Darknet::in_colour(Darknet::EColour::kBrightWhite, name) << "." << std::endl
+		<< "Packed GEMM is " << (packed_supported ? "" : "not ") << "supported, AVX-512 micro-kernel is " << (avx512_supported ? "" : "not ") << "supported." << std::endl
+		<< std::endl
+		<< "      M       N       K    original      AVX2   AVX-512   max diff" << std::endl;
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+	double total_flops			= 0.0;
+	double total_original_sec	= 0.0;
+	double total_avx2_sec		= 0.0;
+	double total_avx512_sec		= 0.0;
+
+	for (const auto & shape : shapes)
+	{
+		Darknet::VFloat A(static_cast<size_t>(shape.M) * shape.K);
+		Darknet::VFloat B(static_cast<size_t>(shape.K) * shape.N);
+		for (auto & f : A) { f = uniform(rng); }
+		for (auto & f : B) { f = uniform(rng); }
+
+		Darknet::VFloat C_original	(static_cast<size_t>(shape.M) * shape.N);
+		Darknet::VFloat C_avx2		(C_original.size());
+		Darknet::VFloat C_avx512	(C_original.size());
+
+		// aim for roughly 50 milliseconds for each implementation
+		const double flops	= 2.0 * shape.M * shape.N * shape.K;
+		const int count		= std::max(1, static_cast<int>(2.5e9 / flops));
+
+		const double original_gflops = measure_gflops(shape, count, [&]()
+			{
+				std::fill(C_original.begin(), C_original.end(), 0.0f);
+				gemm_cpu_unpacked(0, 0, shape.M, shape.N, shape.K, 1.0f, A.data(), shape.K, B.data(), shape.N, C_original.data(), shape.N);
+			});
+
+		double avx2_gflops		= 0.0;
+		double avx512_gflops	= 0.0;
+		float max_diff			= 0.0f;
+		if (packed_supported)
+		{
+			avx2_gflops = measure_gflops(shape, count, [&]()
+				{
+					std::fill(C_avx2.begin(), C_avx2.end(), 0.0f);
+					gemm_packed(0, 0, shape.M, shape.N, shape.K, 1.0f, A.data(), shape.K, B.data(), shape.N, C_avx2.data(), shape.N, false);
+				});
+
+			for (size_t idx = 0; idx < C_original.size(); idx ++)
+			{
+				max_diff = std::max(max_diff, std::fabs(C_original[idx] - C_avx2[idx]));
+			}
+		}
+		if (avx512_supported)
+		{
+			avx512_gflops = measure_gflops(shape, count, [&]()
+				{
+					std::fill(C_avx512.begin(), C_avx512.end(), 0.0f);
+					gemm_packed(0, 0, shape.M, shape.N, shape.K, 1.0f, A.data(), shape.K, B.data(), shape.N, C_avx512.data(), shape.N, true);
+				});
+
+			for (size_t idx = 0; idx < C_original.size(); idx ++)
+			{
+				max_diff = std::max(max_diff, std::fabs(C_original[idx] - C_avx512[idx]));
+			}
+		}
+
+		total_flops			+= flops;
+		total_original_sec	+= flops / (original_gflops * 1.0e9);
+		total_avx2_sec		+= packed_supported ? flops / (avx2_gflops * 1.0e9) : 0.0;
+		total_avx512_sec	+= avx512_supported ? flops / (avx512_gflops * 1.0e9) : 0.0;
+
+		*cfg_and_state.output
+			<< std::fixed << std::setprecision(1)
+			<< std::setw(7) << shape.M << " " << std::setw(7) << shape.N << " " << std::setw(7) << shape.K
+			<< " " << std::setw(11) << original_gflops
+			<< " " << std::setw(9) << avx2_gflops
+			<< " " << std::setw(9) << avx512_gflops
+			<< " " << std::setw(10) << std::setprecision(6) << max_diff << std::endl;
+	}
+
+	// the totals are weighted by the amount of work, same as a single forward pass through the network
+	*cfg_and_state.output
+		<< std::fixed << std::setprecision(1)
+		<< std::endl
+		<< "-> original: " << (total_flops / total_original_sec / 1.0e9) << " GFLOP/s" << std::endl;
+	if (packed_supported)
+	{
+		*cfg_and_state.output << "-> AVX2:     " << (total_flops / total_avx2_sec / 1.0e9) << " GFLOP/s (" << (total_original_sec / total_avx2_sec) << "x)" << std::endl;
+	}
+	if (avx512_supported)
+	{
+		*cfg_and_state.output << "-> AVX-512:  " << (total_flops / total_avx512_sec / 1.0e9) << " GFLOP/s (" << (total_original_sec / total_avx512_sec) << "x)" << std::endl;
+	}
+}
+
+
+void Darknet::benchmark_augmentation()
+{
+	TAT(TATPARMS);
+
+	const int w				= 416;
+	const int h				= 416;
+	const float jitter		= 0.3f;
+	const float hue			= 0.1f;
+	const float saturation	= 1.5f;
+	const float exposure	= 1.5f;
+	const int samples		= 64;
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+	auto rand_scale = [&](const float s)
+	{
+		// same as rand_scale() in utils.cpp
+		const float scale = 1.0f + (s - 1.0f) * uniform(rng);
+		return (uniform(rng) < 0.5f) ? scale : 1.0f / scale;
+	};
+
+	const size_t number_of_threads = std::max(1U, std::thread::hardware_concurrency());
+
+	*cfg_and_state.output
+		<< std::endl
+		<< "Benchmarking data augmentation to " << w << "x" << h << " with jitter=" << jitter << ", hue=" << hue << ", saturation=" << saturation << ", exposure=" << exposure << "." << std::endl;
+
+	for (const auto & [cols, rows] : std::vector<std::pair<int, int>>{{640, 480}, {1280, 720}, {1920, 1080}})
+	{
+		// smooth gradients with some noise, since real photos are neither flat nor random
+		cv::Mat mat(rows, cols, CV_8UC3);
+		for (int y = 0; y < rows; ++y)
+		{
+			uint8_t * ptr = mat.ptr<uint8_t>(y);
+			for (int x = 0; x < cols; ++x)
+			{
+				ptr[3 * x + 0] = static_cast<uint8_t>((255 * x) / cols);
+				ptr[3 * x + 1] = static_cast<uint8_t>((255 * y) / rows);
+				ptr[3 * x + 2] = static_cast<uint8_t>(std::clamp(128.0f + 64.0f * std::sin(x * 0.05f) + 32.0f * (uniform(rng) - 0.5f), 0.0f, 255.0f));
+			}
+		}
+
+		// same random crop and colour adjustments as load_data_detection()
+		struct Parms
+		{
+			int pleft;
+			int ptop;
+			int swidth;
+			int sheight;
+			int flip;
+			float dhue;
+			float dsat;
+			float dexp;
+		};
+		std::vector<Parms> parms(samples);
+		for (auto & p : parms)
+		{
+			const int dw	= static_cast<int>(cols * jitter);
+			const int dh	= static_cast<int>(rows * jitter);
+			p.pleft			= static_cast<int>((uniform(rng) * 2.0f - 1.0f) * dw);
+			p.ptop			= static_cast<int>((uniform(rng) * 2.0f - 1.0f) * dh);
+			p.swidth		= cols - p.pleft - static_cast<int>((uniform(rng) * 2.0f - 1.0f) * dw);
+			p.sheight		= rows - p.ptop - static_cast<int>((uniform(rng) * 2.0f - 1.0f) * dh);
+			p.flip			= uniform(rng) < 0.5f ? 1 : 0;
+			p.dhue			= (uniform(rng) * 2.0f - 1.0f) * hue;
+			p.dsat			= rand_scale(saturation);
+			p.dexp			= rand_scale(exposure);
+		}
+
+		// compare the results in 8-bit units, since that is the precision of the original implementation
+		double total_diff	= 0.0;
+		float max_diff		= 0.0f;
+		size_t values		= 0;
+		for (const auto & p : parms)
+		{
+			Darknet::Image original	= image_data_augmentation_opencv(mat, w, h, p.pleft, p.ptop, p.swidth, p.sheight, p.flip, p.dhue, p.dsat, p.dexp, 0, 0, 0, 0, nullptr);
+			Darknet::Image fused	= image_data_augmentation		(mat, w, h, p.pleft, p.ptop, p.swidth, p.sheight, p.flip, p.dhue, p.dsat, p.dexp, 0, 0, 0, 0, nullptr);
+			const size_t size = static_cast<size_t>(original.w) * original.h * original.c;
+			for (size_t idx = 0; idx < size; idx ++)
+			{
+				const float diff = 255.0f * std::fabs(original.data[idx] - fused.data[idx]);
+				total_diff	+= diff;
+				max_diff	= std::max(max_diff, diff);
+			}
+			values += size;
+			Darknet::free_image(original);
+			Darknet::free_image(fused);
+		}
+
+		*cfg_and_state.output
+			<< std::endl
+			<< Darknet::in_colour(Darknet::EColour::kBrightWhite, std::to_string(cols) + "x" + std::to_string(rows)) << ": " << samples << " random crops" << std::endl;
+
+		for (const size_t threads : {static_cast<size_t>(1), number_of_threads})
+		{
+			// each thread augments all of the samples, same as the image loading threads during training
+			auto images_per_second = [&](const bool use_fused)
+			{
+				const auto t1 = std::chrono::high_resolution_clock::now();
+				Darknet::VThreads workers;
+				for (size_t idx = 0; idx < threads; idx ++)
+				{
+					workers.emplace_back([&]()
+						{
+							for (const auto & p : parms)
+							{
+								Darknet::Image out = use_fused ?
+									image_data_augmentation			(mat, w, h, p.pleft, p.ptop, p.swidth, p.sheight, p.flip, p.dhue, p.dsat, p.dexp, 0, 0, 0, 0, nullptr) :
+									image_data_augmentation_opencv	(mat, w, h, p.pleft, p.ptop, p.swidth, p.sheight, p.flip, p.dhue, p.dsat, p.dexp, 0, 0, 0, 0, nullptr);
+								Darknet::free_image(out);
+							}
+						});
+				}
+				for (auto & worker : workers)
+				{
+					worker.join();
+				}
+				const auto t2 = std::chrono::high_resolution_clock::now();
+
+				return threads * parms.size() / std::chrono::duration<double>(t2 - t1).count();
+			};
+
+			const double original_ips	= images_per_second(false);
+			const double fused_ips		= images_per_second(true);
+
+			*cfg_and_state.output
+				<< std::fixed << std::setprecision(1)
+				<< "-> " << std::setw(2) << threads << " thread" << (threads == 1 ? " " : "s")
+				<< "   original: " << std::setw(8) << original_ips << " images/sec"
+				<< "   fused: " << std::setw(8) << fused_ips << " images/sec"
+				<< " (" << (fused_ips / original_ips) << "x)" << std::endl;
+		}
+
+		*cfg_and_state.output
+			<< std::fixed << std::setprecision(3)
+			<< "-> difference:  mean " << (total_diff / values) << ", max " << max_diff << " (8-bit units)" << std::endl;
+	}
+}
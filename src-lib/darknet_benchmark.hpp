@@ -0,0 +1,45 @@
+#pragma once
+
+/** @file
+ * Micro-benchmarks for some of the hot code paths within %Darknet.  These are run from the CLI, such as
+ * @p "darknet benchmark_yolo".  They don't need a neural network or any images, and only use synthetic data.  (The
+ * GEMM benchmark can optionally read a @p .cfg file to get the shape of the matrices.)
+ */
+
+
+#include "darknet_internal.hpp"
+
+
+namespace Darknet
+{
+	/** Compare the original YOLO objectness scan (which used to append every object to a @p std::list) against the
+	 * scalar and SIMD compaction used by @ref yolo_num_detections_v3().  The YOLO output layers are sized like
+	 * those from YOLOv4-tiny and YOLOv7.
+	 *
+	 * @since 2026-10-17
+	 */
+	void benchmark_yolo();
+
+	/** Compare the original NMS functions (@ref do_nms_sort(), @ref diounms_sort(), and @ref do_nms_obj()) against
+	 * @ref do_nms_fused() using synthetic crowded scenes with hundreds of overlapping objects.
+	 *
+	 * @since 2026-10-17
+	 */
+	void benchmark_nms();
+
+	/** Compare the original CPU matrix multiplication against @ref gemm_packed() with both the AVX2 and AVX-512
+	 * micro-kernels, and report the GFLOP/s.  If a @p .cfg file is specified on the command-line, the matrix shapes
+	 * are those of the convolutional layers in that network.  Otherwise the shapes from YOLOv4-tiny at 416x416 are used.
+	 *
+	 * @since 2026-10-17
+	 */
+	void benchmark_gemm();
+
+	/** Compare the original data augmentation done with many OpenCV calls (@ref image_data_augmentation_opencv())
+	 * against the single-pass @ref image_data_augmentation(), and report the images/sec when the work is done by one
+	 * thread and by one thread per CPU core, similar to the image loading threads used during training.
+	 *
+	 * @since 2026-10-17
+	 */
+	void benchmark_augmentation();
+}
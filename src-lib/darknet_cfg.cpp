@@ -1176,6 +1176,7 @@ Darknet::Network & Darknet::CfgFile::create_network(int batch, int time_steps)
 		net.workspace = (float*)xcalloc(1, parms.workspace_size);
 	}
 #endif
+	net.details->workspace_size = parms.workspace_size;
 
 	Darknet::ELayerType lt = net.layers[net.n - 1].type;
 	if (lt == Darknet::ELayerType::YOLO || lt == Darknet::ELayerType::REGION)
@@ -1239,6 +1240,10 @@ Darknet::CfgFile & Darknet::CfgFile::parse_net_section()
 	net.use_cuda_graph = s.find_int("use_cuda_graph", 0);
 	net.loss_scale = s.find_float("loss_scale", 1);
 	net.dynamic_minibatch = s.find_int("dynamic_minibatch", 0);
+	net.prefetch = s.find_int("prefetch", 2);
+	net.image_cache_size_limit = (size_t)1024*1024 * s.find_float("image_cache_MB", 0);  // disabled by default
+	net.image_cache_max_side = s.find_float("image_cache_max_side", 0);
+	net.reduced_decoding = s.find_int("reduced_decoding", 1);
 	net.optimized_memory = s.find_int("optimized_memory", 0);
 	net.workspace_size_limit = (size_t)1024*1024 * s.find_float("workspace_size_limit_MB", 1024);  // 1024 MB by default
 
@@ -114,6 +114,10 @@ Darknet::CfgAndState & Darknet::CfgAndState::reset()
 	gpu_index				= -1;
 #endif
 
+	thread_affinity			= "none";
+	numa_node				= -1;
+	loader_cores			= 0;
+
 	argv					.clear();
 	args					.clear();
 	command					.clear();
@@ -408,6 +412,17 @@ Darknet::CfgAndState & Darknet::CfgAndState::process_arguments(const VStr & v, D
 	}
 #endif
 
+	if (args.count("affinity") > 0)
+	{
+		thread_affinity = convert_to_lowercase_alphanum(get("affinity").str);
+		if (thread_affinity.empty())
+		{
+			thread_affinity = "none";
+		}
+	}
+	numa_node		= get("numanode"	, numa_node		);
+	loader_cores	= get("loadercores"	, loader_cores	);
+
 	if (net and args.count("skipclasses"))
 	{
 		const ArgsAndParms & arg = get("skipclasses");
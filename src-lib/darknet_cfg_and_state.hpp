@@ -149,6 +149,17 @@ namespace Darknet
 			/// The index of the GPU to use.  @p -1 means no GPU is selected.
 			int gpu_index;
 
+			/** How the compute and image loading threads are placed on the CPU cores.  This is @p "none", @p "split", or
+			 * @p "node", and can be set with @p --affinity.  Default is @p "none".  @see @ref Darknet::configure_thread_placement()
+			 */
+			std::string thread_affinity;
+
+			/// The NUMA node used for thread placement, set with @p --numa-node.  Default is @p -1 (the node where %Darknet started).
+			int numa_node;
+
+			/// The number of logical CPUs reserved for image loading, set with @p --loader-cores.  Default is @p 0 (automatic).
+			int loader_cores;
+
 			/// @{ Name the threads that we create in case we have to report an error.
 			std::mutex thread_names_mutex;
 			std::map<std::thread::id, std::string> thread_names;
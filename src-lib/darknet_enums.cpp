@@ -257,6 +257,7 @@ const Darknet::NamesAndNMSKind & Darknet::all_names_and_NMS_kind()
 		{"greedynms"	, ENMSKind::GREEDY_NMS	},
 		{"diounms"		, ENMSKind::DIOU_NMS	},
 		{"cornersnms"	, ENMSKind::CORNERS_NMS	},
+		{"objectnessnms", ENMSKind::OBJECTNESS_NMS	},
 	};
 
 	return m;
@@ -156,6 +156,7 @@ namespace Darknet
 		GREEDY_NMS	= NMS_KIND::GREEDY_NMS	,
 		DIOU_NMS	= NMS_KIND::DIOU_NMS	,
 		CORNERS_NMS	= NMS_KIND::CORNERS_NMS	, // gaussian yolo
+		OBJECTNESS_NMS	= NMS_KIND::OBJECTNESS_NMS	,
 	};
 
 	/// @{ Convert between names and NMS kind.
@@ -243,4 +244,28 @@ namespace Darknet
 	EYoloPoint get_yolo_point_types_from_name(const std::string & name);
 	std::string to_string(const EYoloPoint type);
 	/// @}
+
+	/** How the CPU runs the forward pass of a convolutional layer.  This is not set in the @p .cfg file, but is chosen
+	 * for each layer when the network is loaded for inference.
+	 * @see @ref select_convolution_algorithms()
+	 */
+	enum class EConvolutionAlgorithm
+	{
+		kIm2col			= 0,	///< default:  @ref im2col_cpu_ext() into the workspace, followed by GEMM
+		kDirect1x1		,		///< 1x1 with stride 1:  GEMM directly on the input, no workspace
+		kWinograd2x2	,		///< 3x3 with stride 1:  Winograd F(2x2,3x3)
+		kWinograd4x4	,		///< 3x3 with stride 1:  Winograd F(4x4,3x3)
+		kInt8			,		///< quantized with @ref Darknet::quantize_network():  8-bit integer GEMM
+		kNHWC			,		///< im2col and GEMM with the channels last; @see @ref Darknet::convert_network_to_nhwc()
+	};
+
+	/** How the output of a layer is stored in memory.  Everything uses @p kNCHW unless @p --nhwc is used for inference
+	 * on the CPU, in which case some of the layers store their output with the channels last.
+	 * @see @ref Darknet::convert_network_to_nhwc()
+	 */
+	enum class ETensorLayout
+	{
+		kNCHW			= 0,	///< default:  each channel is a complete plane of @p "h * w" values
+		kNHWC			,		///< channels last:  all of the channels for a given pixel are contiguous
+	};
 };
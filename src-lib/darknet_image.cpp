@@ -892,6 +892,137 @@ Darknet::Image Darknet::bgr_mat_to_rgb_image(const cv::Mat & mat)
 }
 
 
+void Darknet::bgr_mat_to_planar_rgb(const cv::Mat & mat, float * output, const int output_width, const int output_height, const cv::InterpolationFlags interpolation)
+{
+	TAT(TATPARMS);
+
+	if (mat.empty() or mat.depth() != CV_8U or (mat.channels() != 3 and mat.channels() != 4))
+	{
+		throw std::invalid_argument("expected a 3-channel BGR or 4-channel BGRA image");
+	}
+	if (output == nullptr or output_width < 1 or output_height < 1)
+	{
+		throw std::invalid_argument("invalid output buffer or dimensions");
+	}
+	if (interpolation != cv::INTER_NEAREST and interpolation != cv::INTER_LINEAR)
+	{
+		throw std::invalid_argument("only INTER_NEAREST and INTER_LINEAR are supported");
+	}
+
+	const int channels		= mat.channels();
+	const int plane_size	= output_width * output_height;
+	const float scale_x		= static_cast<float>(mat.cols) / output_width;
+	const float scale_y		= static_cast<float>(mat.rows) / output_height;
+	const float normalize	= 1.0f / 255.0f;
+
+	float * red		= output + plane_size * 0;
+	float * green	= output + plane_size * 1;
+	float * blue	= output + plane_size * 2;
+
+	// the horizontal coordinates are the same for every row, so they're only calculated once
+	static thread_local VInt x0;
+	static thread_local VInt x1;
+	static thread_local VFloat wx;
+	x0.resize(output_width);
+	x1.resize(output_width);
+	wx.resize(output_width);
+
+	for (int x = 0; x < output_width; ++x)
+	{
+		if (interpolation == cv::INTER_NEAREST)
+		{
+			// same as OpenCV's INTER_NEAREST
+			x0[x] = std::min(static_cast<int>(std::floor(x * scale_x)), mat.cols - 1) * channels;
+			x1[x] = x0[x];
+			wx[x] = 0.0f;
+		}
+		else
+		{
+			// same as OpenCV's INTER_LINEAR, where pixel centers are aligned
+			float fx = (x + 0.5f) * scale_x - 0.5f;
+			int sx = static_cast<int>(std::floor(fx));
+			fx -= sx;
+			if (sx < 0)
+			{
+				sx = 0;
+				fx = 0.0f;
+			}
+			if (sx >= mat.cols - 1)
+			{
+				sx = mat.cols - 1;
+				fx = 0.0f;
+			}
+			x0[x] = sx * channels;
+			x1[x] = std::min(sx + 1, mat.cols - 1) * channels;
+			wx[x] = fx;
+		}
+	}
+
+	const int * const x0_ptr	= x0.data();
+	const int * const x1_ptr	= x1.data();
+	const float * const wx_ptr	= wx.data();
+
+	#pragma omp parallel for
+	for (int y = 0; y < output_height; ++y)
+	{
+		float * r = red		+ y * output_width;
+		float * g = green	+ y * output_width;
+		float * b = blue	+ y * output_width;
+
+		if (interpolation == cv::INTER_NEAREST)
+		{
+			const uint8_t * row = mat.ptr<uint8_t>(std::min(static_cast<int>(std::floor(y * scale_y)), mat.rows - 1));
+			for (int x = 0; x < output_width; ++x)
+			{
+				// OpenCV is BGR (or BGRA) but Darknet needs RGB
+				const uint8_t * pixel = row + x0_ptr[x];
+				r[x] = pixel[2] * normalize;
+				g[x] = pixel[1] * normalize;
+				b[x] = pixel[0] * normalize;
+			}
+			continue;
+		}
+
+		float fy = (y + 0.5f) * scale_y - 0.5f;
+		int sy = static_cast<int>(std::floor(fy));
+		fy -= sy;
+		if (sy < 0)
+		{
+			sy = 0;
+			fy = 0.0f;
+		}
+		if (sy >= mat.rows - 1)
+		{
+			sy = mat.rows - 1;
+			fy = 0.0f;
+		}
+
+		const uint8_t * row0 = mat.ptr<uint8_t>(sy);
+		const uint8_t * row1 = mat.ptr<uint8_t>(std::min(sy + 1, mat.rows - 1));
+
+		for (int x = 0; x < output_width; ++x)
+		{
+			const float fx = wx_ptr[x];
+			const float w00 = (1.0f - fx) * (1.0f - fy) * normalize;
+			const float w01 = fx * (1.0f - fy) * normalize;
+			const float w10 = (1.0f - fx) * fy * normalize;
+			const float w11 = fx * fy * normalize;
+
+			const uint8_t * p00 = row0 + x0_ptr[x];
+			const uint8_t * p01 = row0 + x1_ptr[x];
+			const uint8_t * p10 = row1 + x0_ptr[x];
+			const uint8_t * p11 = row1 + x1_ptr[x];
+
+			r[x] = p00[2] * w00 + p01[2] * w01 + p10[2] * w10 + p11[2] * w11;
+			g[x] = p00[1] * w00 + p01[1] * w01 + p10[1] * w10 + p11[1] * w11;
+			b[x] = p00[0] * w00 + p01[0] * w01 + p10[0] * w10 + p11[0] * w11;
+		}
+	}
+
+	return;
+}
+
+
 cv::Mat Darknet::image_to_mat(const Darknet::Image & img)
 {
 	TAT(TATPARMS);
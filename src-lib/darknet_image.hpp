@@ -82,6 +82,19 @@ namespace Darknet
 	 */
 	Darknet::Image bgr_mat_to_rgb_image(const cv::Mat & mat);
 
+	/** Resize, convert from BGR to RGB, normalize to @p 0.0 - @p 1.0, and convert to planar format all in a single pass,
+	 * writing the results directly into @p output which must have room for @p "3 * output_width * output_height" floats.
+	 * This is what @ref Darknet::predict() uses to avoid the temporary images created by @p cv::resize(),
+	 * @p cv::cvtColor(), and @ref bgr_mat_to_rgb_image().
+	 *
+	 * @param [in] mat Must be @p CV_8UC3 (BGR) or @p CV_8UC4 (BGRA).  The alpha channel is ignored.
+	 * @param [out] output Typically the network input buffer.
+	 * @param [in] interpolation Must be either @p cv::INTER_NEAREST (fastest) or @p cv::INTER_LINEAR.
+	 *
+	 * @since 2026-10-17
+	 */
+	void bgr_mat_to_planar_rgb(const cv::Mat & mat, float * output, const int output_width, const int output_height, const cv::InterpolationFlags interpolation = cv::INTER_NEAREST);
+
 	/** Convert the usual @ref Darknet::Image format to OpenCV @p cv::Mat.  The mat object will be in @p RGB format,
 	 * not @p BGR.
 	 *
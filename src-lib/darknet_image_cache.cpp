@@ -0,0 +1,209 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// Items are kept in order of use.  The front of the list is the most recently used image.
+	typedef std::list<std::string> LRU;
+
+
+	struct CachedImage
+	{
+		cv::Mat mat;
+		size_t bytes;
+		LRU::iterator lru;
+	};
+
+
+	/** The cache is shared by all of the image loading threads.  Images are decoded outside of the lock, so the only
+	 * work done while the lock is held is updating the map and the LRU list.
+	 */
+	struct ImageCache
+	{
+		std::mutex mutex;
+		size_t size_limit;
+		int max_side;
+		int min_width;	///< smallest size at which JPEG images may be decoded, @see @ref Darknet::configure_reduced_decoding()
+		int min_height;
+		size_t bytes;
+		size_t hits;
+		size_t misses;
+		LRU lru;
+		std::map<std::string, CachedImage> images;
+	};
+	static ImageCache cache;
+
+
+	/// Remove the least recently used images until @p bytes more can be added.  The cache must already be locked.
+	static void make_room(const size_t bytes)
+	{
+		TAT(TATPARMS);
+
+		while (not cache.lru.empty() and cache.bytes + bytes > cache.size_limit)
+		{
+			auto iter = cache.images.find(cache.lru.back());
+			cache.bytes -= iter->second.bytes;
+			cache.images.erase(iter);
+			cache.lru.pop_back();
+		}
+
+		return;
+	}
+
+
+	/// Decode the image from the packed training file if there is one, otherwise read it from disk.
+	static cv::Mat read_image(const std::string & filename, const int channels, const int min_width, const int min_height)
+	{
+		TAT(TATPARMS);
+
+		cv::Mat mat;
+		if (not Darknet::load_packed_image(filename, channels, mat, min_width, min_height))
+		{
+			mat = load_rgb_mat_image(filename, channels, min_width, min_height);
+		}
+
+		return mat;
+	}
+}
+
+
+void Darknet::configure_image_cache(const size_t size_limit, const int max_side)
+{
+	TAT(TATPARMS);
+
+	std::lock_guard lock(cache.mutex);
+
+	cache.size_limit	= size_limit;
+	cache.max_side		= std::max(0, max_side);
+	cache.hits			= 0;
+	cache.misses		= 0;
+
+	if (size_limit == 0)
+	{
+		cache.images.clear();
+		cache.lru.clear();
+		cache.bytes = 0;
+	}
+	else
+	{
+		make_room(0);
+
+		*cfg_and_state.output << "Decoded images will be cached using up to " << size_to_IEC_string(size_limit);
+		if (cache.max_side > 0)
+		{
+			*cfg_and_state.output << ", shrinking images to " << cache.max_side << " pixels on the longest side";
+		}
+		*cfg_and_state.output << "." << std::endl;
+	}
+
+	return;
+}
+
+
+void Darknet::configure_reduced_decoding(const int min_width, const int min_height)
+{
+	TAT(TATPARMS);
+
+	std::lock_guard lock(cache.mutex);
+
+	cache.min_width		= std::max(0, min_width);
+	cache.min_height	= std::max(0, min_height);
+
+	if (cache.min_width > 0 and cache.min_height > 0)
+	{
+		*cfg_and_state.output << "Large JPEG images will be decoded at a reduced size, keeping at least " << cache.min_width << "x" << cache.min_height << " pixels." << std::endl;
+	}
+
+	return;
+}
+
+
+cv::Mat Darknet::load_cached_rgb_mat_image(const std::string & filename, const int channels)
+{
+	TAT(TATPARMS);
+
+	int max_side	= 0;
+	int min_width	= 0;
+	int min_height	= 0;
+	bool enabled	= false;
+
+	// only the settings and the lookup happen under the lock; decoding is done outside of it so the image loading
+	// threads don't have to wait on each other
+	if (true)
+	{
+		std::lock_guard lock(cache.mutex);
+
+		min_width	= cache.min_width;
+		min_height	= cache.min_height;
+		enabled		= (cache.size_limit > 0);
+
+		if (enabled)
+		{
+			auto iter = cache.images.find(filename);
+			if (iter != cache.images.end())
+			{
+				cache.hits ++;
+				cache.lru.splice(cache.lru.begin(), cache.lru, iter->second.lru);
+				return iter->second.mat;
+			}
+
+			cache.misses ++;
+			max_side = cache.max_side;
+		}
+	}
+
+	if (not enabled)
+	{
+		return read_image(filename, channels, min_width, min_height);
+	}
+
+	cv::Mat mat = read_image(filename, channels, min_width, min_height);
+
+	const int longest_side = std::max(mat.cols, mat.rows);
+	if (max_side > 0 and longest_side > max_side)
+	{
+		const double factor = static_cast<double>(max_side) / longest_side;
+		cv::Mat shrunk;
+		cv::resize(mat, shrunk, cv::Size(), factor, factor, cv::INTER_AREA);
+		mat = shrunk;
+	}
+
+	const size_t bytes = mat.total() * mat.elemSize();
+
+	std::lock_guard lock(cache.mutex);
+
+	// another thread may have loaded the same image while the lock was released
+	if (bytes <= cache.size_limit and cache.images.count(filename) == 0)
+	{
+		make_room(bytes);
+
+		cache.lru.push_front(filename);
+		cache.images[filename] = {mat, bytes, cache.lru.begin()};
+		cache.bytes += bytes;
+	}
+
+	return mat;
+}
+
+
+Darknet::ImageCacheStats Darknet::get_image_cache_stats()
+{
+	TAT(TATPARMS);
+
+	std::lock_guard lock(cache.mutex);
+
+	ImageCacheStats stats;
+	stats.enabled	= (cache.size_limit > 0);
+	stats.hits		= cache.hits;
+	stats.misses	= cache.misses;
+	stats.images	= cache.images.size();
+	stats.bytes		= cache.bytes;
+
+	cache.hits		= 0;
+	cache.misses	= 0;
+
+	return stats;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+/** @file
+ * Cache of decoded training images.  Without the cache, every image is read from disk and decoded again each time it is
+ * used to build a training batch.
+ */
+
+
+#include "darknet_internal.hpp"
+
+
+namespace Darknet
+{
+	/** Enable or disable the decoded image cache.  This is called at the start of training from the @p "[net]" options
+	 * @p image_cache_MB and @p image_cache_max_side.
+	 *
+	 * @param size_limit Maximum number of bytes used to store decoded images.  Once the limit is reached, the least
+	 * recently used images are removed from the cache.  Set to zero to disable the cache.
+	 *
+	 * @param max_side When greater than zero, images larger than this are shrunk (keeping the aspect ratio) before they
+	 * are stored in the cache, so the cache can hold many more images.  This must be larger than the network dimensions
+	 * since the images are cropped and resized again during augmentation.  When training with @p random=1 the caller
+	 * scales @p image_cache_max_side by the largest network size which can be reached, not the size in the .cfg file.
+	 *
+	 * @since 2026-10-17
+	 */
+	void configure_image_cache(const size_t size_limit, const int max_side);
+
+	/** Allow large JPEG training images to be decoded at 1/2, 1/4, or 1/8 of their size, as long as the decoded image is
+	 * at least @p min_width x @p min_height.  This is called at the start of training from the @p "[net]" option
+	 * @p reduced_decoding.  Set both values to zero to always decode the images at full size.
+	 *
+	 * @see @ref load_rgb_mat_image()
+	 *
+	 * @since 2026-10-17
+	 */
+	void configure_reduced_decoding(const int min_width, const int min_height);
+
+	/** Same as @ref load_rgb_mat_image() but the decoded image is obtained from the cache when possible.  Images which
+	 * are not in the cache are decoded from the packed training file (see @ref load_packed_image()) or read from disk.
+	 *
+	 * @warning The image returned may be shared with the cache and must not be modified.
+	 *
+	 * @since 2026-10-17
+	 */
+	cv::Mat load_cached_rgb_mat_image(const std::string & filename, const int channels);
+
+	/// Statistics on the decoded image cache.  @see @ref Darknet::get_image_cache_stats()
+	struct ImageCacheStats
+	{
+		bool enabled;
+		size_t hits;	///< images found in the cache
+		size_t misses;	///< images which had to be read from disk
+		size_t images;	///< number of images currently in the cache
+		size_t bytes;	///< memory used by the images in the cache
+	};
+
+	/** Get the number of hits and misses since the previous call, and the current size of the cache.  This is called
+	 * once per training iteration.
+	 *
+	 * @since 2026-10-17
+	 */
+	ImageCacheStats get_image_cache_stats();
+}
@@ -27,6 +27,8 @@
 #include <condition_variable>
 #include <deque>
 #include <fstream>
+#include <future>
+#include <limits>
 #include <list>
 #include <mutex>
 #include <optional>
@@ -60,20 +62,43 @@ namespace Darknet
 	 * We use the cache to track objects within the output array, so we don't have to walk over the entire array every
 	 * time we need to find all the objects and bounding boxes.
 	 *
+	 * The cache is made of flat arrays of integers so it can be cleared and re-used between frames without freeing the
+	 * memory, and so the objectness scan can write the locations directly using SIMD compaction.
+	 *
 	 * @since 2024-06-02
 	 *
 	 * @see @ref yolo_num_detections_v3() where the cache is populated (in yolo_layer.cpp)
 	 * @see @ref get_yolo_detections_v3() where the cache is accessed and converted to bounding boxes
 	 * @see @ref make_network_boxes_v3()
+	 * @see @ref Darknet::DetectionPool::cache
 	 */
-	struct Output_Object
+	struct Output_Object_Cache
 	{
-		int layer_index;	///< The layer index where this was found.
-		int n;				///< What is "n"...the mask (anchor?) number?
-		int i;				///< The entry index into the W x H output array for the given YOLO layer.
-		int obj_index;		///< The index into the YOLO output array -- as obtained from @ref yolo_entry_index() -- which is used to get the objectness value.  E.g., a value of @p "l.output[obj_index] == 0.999f" would indicate that there is an object at this location.
+		/// Forget all the objects, but keep the memory so it can be re-used for the next image.
+		void clear()
+		{
+			count = 0;
+			layer_index.clear();
+			layer_end.clear();
+		}
+
+		/** The location of each object within the YOLO output, which is @p "n * l.w * l.h + i" where @p "n" is the
+		 * anchor (mask) number and @p "i" is the entry index into the W x H output array.  This is the value that
+		 * must be passed to @ref yolo_entry_index() as the "location".
+		 *
+		 * @note Only the first @ref count entries are valid.  The vector is grown (never shrunk) so there is room for
+		 * every cell of a YOLO layer, since we don't know ahead of time how many objects will be found.
+		 */
+		VInt locations;
+
+		/// The number of valid entries in @ref locations.
+		size_t count = 0;
+
+		/// @{ For each YOLO layer which contributed objects, the layer index and the end of its range in @ref locations.
+		VInt layer_index;
+		std::vector<size_t> layer_end;
+		/// @}
 	};
-	using Output_Object_Cache = std::list<Output_Object>;
 
 	class CfgLine;
 	class CfgSection;
@@ -291,6 +316,8 @@ typedef struct load_args {
 	Darknet::Image *im;
 	Darknet::Image *resized;
 	data_type type;
+	uint64_t batch_number;	///< training iteration of the batch (or its sequence number when not prefetched), used to seed @ref Darknet::AugmentationRNG
+	int first_sample;		///< index within the batch of the first image loaded by this job
 } load_args;
 
 
@@ -352,6 +379,14 @@ int get_yolo_detections_v3(Darknet::Network * net, int w, int h, int netw, int n
 #include "tree.hpp"
 #include "activations.hpp"
 #include "dump.hpp"
+#include "darknet_benchmark.hpp"
+#include "darknet_serve.hpp"
+#include "darknet_image_cache.hpp"
+#include "darknet_training_pack.hpp"
+#include "darknet_thread_placement.hpp"
+#include "darknet_random.hpp"
+#include "darknet_quantize.hpp"
+#include "darknet_layout.hpp"
 
 #if DARKNET_GPU_ROCM
 #include "amd_rocm.hpp"
@@ -260,9 +260,20 @@ namespace Darknet
 		int new_lda;
 		int bit_align;
 
+		Darknet::EConvolutionAlgorithm conv_algorithm;	///< @see @ref select_convolution_algorithms()
+		float *winograd_weights;						///< weights already transformed for the Winograd algorithms
+		int8_t *int8_weights;							///< quantized weights, each row padded to a multiple of 4; @see @ref Darknet::quantize_network()
+		float *int8_weight_scales;						///< one scale per filter for @p int8_weights
+		int32_t *int8_weight_sums;						///< sum of each row of @p int8_weights
+		float int8_input_scale;							///< scale used to quantize the input of this layer, or zero when not quantized
+		float *nhwc_weights;							///< weights for @ref Darknet::EConvolutionAlgorithm::kNHWC, stored as @p "[size * size * c][n]"
+		Darknet::ETensorLayout input_layout;			///< layout of @p state.input; @see @ref Darknet::convert_network_to_nhwc()
+		Darknet::ETensorLayout output_layout;			///< layout of @p output; @see @ref Darknet::convert_network_to_nhwc()
+
 		float *col_image;
 		float * delta;
 		float * output;
+		const float * lazy_input;	///< [yolo] during inference, the input which has not yet been copied to @p output; @see @ref finish_lazy_yolo_output()
 		float * activation_input;
 		int delta_pinned;
 		int output_pinned;
@@ -502,6 +513,25 @@ namespace Darknet
 		#endif  // CUDNN
 		//#endif  // DARKNET_GPU
 	};
+
+
+	/** Make a layer of a network replica use the read-only parameters of the layer from which it was created.  This
+	 * includes the weights, biases, and batchnorm parameters, as well as the transformed weights and the settings
+	 * chosen by @ref select_convolution_algorithms().  Copies which the replica allocated itself are freed.
+	 *
+	 * @see @ref create_network_replica()
+	 *
+	 * @since 2026-10-17
+	 */
+	void share_layer_parameters(Layer & replica, const Layer & original);
+
+	/** Forget the parameters set by @ref share_layer_parameters() so they are not freed along with the replica.
+	 *
+	 * @see @ref free_network_replica()
+	 *
+	 * @since 2026-10-17
+	 */
+	void unshare_layer_parameters(Layer & replica, const Layer & original);
 }
 
 
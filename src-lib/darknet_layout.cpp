@@ -0,0 +1,217 @@
+#include "darknet_internal.hpp"
+#include "gemm.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/** Layer types for which we know exactly which outputs are read during the forward pass.  If a network contains
+	 * any other type of layer, then the network is not converted.  This is the same list as the one used to plan the
+	 * activation memory.
+	 */
+	static inline bool is_known(const Darknet::Layer & l)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		switch (l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:
+			case Darknet::ELayerType::MAXPOOL:
+			case Darknet::ELayerType::LOCAL_AVGPOOL:
+			case Darknet::ELayerType::AVGPOOL:
+			case Darknet::ELayerType::ROUTE:
+			case Darknet::ELayerType::SHORTCUT:
+			case Darknet::ELayerType::SCALE_CHANNELS:
+			case Darknet::ELayerType::SAM:
+			case Darknet::ELayerType::UPSAMPLE:
+			case Darknet::ELayerType::REORG:
+			case Darknet::ELayerType::DROPOUT:
+			case Darknet::ELayerType::YOLO:
+			case Darknet::ELayerType::GAUSSIAN_YOLO:
+			case Darknet::ELayerType::REGION:
+			{
+				return true;
+			}
+			default:
+			{
+				return false;
+			}
+		}
+	}
+
+
+	/// Convolutional layers which can use @ref Darknet::EConvolutionAlgorithm::kNHWC.  These read either layout.
+	static inline bool is_nhwc_convolution(const Darknet::Layer & l)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		return	l.type				== Darknet::ELayerType::CONVOLUTIONAL	and
+				l.groups			== 1									and
+				l.conv_algorithm	!= Darknet::EConvolutionAlgorithm::kInt8	and
+				not l.binary												and
+				not l.xnor													and
+				not l.antialiasing											and
+				not l.deform												and
+				not l.share_layer											and
+				not l.batch_normalize										and
+				not l.assisted_excitation									and
+				not l.train													and
+				gemm_epilogue_supports(l.activation);
+	}
+
+
+	/// Other layers with an NHWC implementation.  Both the input and the output of these layers must use the same layout.
+	static inline bool is_nhwc_layer(const Darknet::Network & net, const Darknet::Layer & l)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		switch (l.type)
+		{
+			case Darknet::ELayerType::MAXPOOL:
+			{
+				return not l.maxpool_depth and not l.antialiasing and not l.train;
+			}
+			case Darknet::ELayerType::ROUTE:
+			{
+				return true;
+			}
+			case Darknet::ELayerType::SHORTCUT:
+			{
+				// only the simple addition of 2 outputs, which is the same regardless of the layout
+				const Darknet::Layer & from = net.layers[l.index];
+				return l.nweights == 0 and l.n == 1 and from.w == l.w and from.h == l.h and from.c == l.c;
+			}
+			case Darknet::ELayerType::UPSAMPLE:
+			{
+				return not l.reverse;
+			}
+			default:
+			{
+				return false;
+			}
+		}
+	}
+
+
+	/// The layers whose output is read by layer @p idx.  A value of @p -1 is the input image.
+	static Darknet::VInt get_inputs(const Darknet::Network & net, const int idx)
+	{
+		TAT(TATPARMS);
+
+		const Darknet::Layer & l = net.layers[idx];
+
+		Darknet::VInt inputs;
+		if (l.type != Darknet::ELayerType::ROUTE)
+		{
+			// every layer except for "route" reads the output from the previous layer
+			inputs.push_back(idx - 1);
+		}
+
+		if (l.type == Darknet::ELayerType::ROUTE or l.type == Darknet::ELayerType::SHORTCUT)
+		{
+			for (int k = 0; k < l.n; ++k)
+			{
+				inputs.push_back(l.input_layers[k]);
+			}
+		}
+		else if (l.type == Darknet::ELayerType::SAM or l.type == Darknet::ELayerType::SCALE_CHANNELS)
+		{
+			inputs.push_back(l.index);
+		}
+
+		return inputs;
+	}
+}
+
+
+int Darknet::convert_network_to_nhwc(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		if (not is_known(net.layers[i]))
+		{
+			Darknet::display_warning_msg("The layers cannot be converted to NHWC since layer #" + std::to_string(i) + " is of type " + Darknet::to_string(net.layers[i].type) + ".\n");
+			return 0;
+		}
+	}
+
+	std::vector<bool> is_convolution(net.n);
+	std::vector<bool> nhwc(net.n);
+	std::vector<Darknet::VInt> inputs(net.n);
+	for (int i = 0; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+		is_convolution[i]	= is_nhwc_convolution(l);
+		nhwc[i]				= is_convolution[i] or is_nhwc_layer(net, l);
+		inputs[i]			= get_inputs(net, i);
+	}
+
+	// the output of the network is read once the forward pass is done, so it must remain NCHW
+	nhwc[net.n - 1] = false;
+
+	/* Start with every layer which supports NHWC, and remove layers until the layouts agree.  Convolutional layers can
+	 * read either layout, but the other NHWC layers need all of their inputs to be NHWC, and every other layer needs all
+	 * of its inputs to be NCHW.  Layers are only ever removed, so this always ends.
+	 */
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (int i = 0; i < net.n; ++i)
+		{
+			if (is_convolution[i])
+			{
+				continue;
+			}
+
+			for (const int idx : inputs[i])
+			{
+				const bool input_is_nhwc = (idx >= 0 and nhwc[idx]);
+				if (nhwc[i] and not input_is_nhwc)
+				{
+					nhwc[i] = false;
+					changed = true;
+				}
+				else if (input_is_nhwc and not nhwc[i])
+				{
+					nhwc[idx] = false;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	int nhwc_layers			= 0;
+	int converted_layers	= 0;
+	for (int i = 0; i < net.n; ++i)
+	{
+		Darknet::Layer & l = net.layers[i];
+		l.output_layout	= nhwc[i] ? Darknet::ETensorLayout::kNHWC : Darknet::ETensorLayout::kNCHW;
+		l.input_layout	= (i > 0 and nhwc[i - 1]) ? Darknet::ETensorLayout::kNHWC : Darknet::ETensorLayout::kNCHW;
+		nhwc_layers		+= (nhwc[i] ? 1 : 0);
+
+		if (is_convolution[i] and (l.input_layout == Darknet::ETensorLayout::kNHWC or l.output_layout == Darknet::ETensorLayout::kNHWC))
+		{
+			if (l.winograd_weights)
+			{
+				free(l.winograd_weights);
+				l.winograd_weights = nullptr;
+			}
+			l.conv_algorithm = Darknet::EConvolutionAlgorithm::kNHWC;
+			prepare_nhwc_weights(l);
+			l.workspace_size = get_convolutional_workspace_size(l);
+			converted_layers ++;
+		}
+	}
+
+	if (cfg_and_state.is_verbose)
+	{
+		*cfg_and_state.output << "NHWC layout: " << nhwc_layers << " of " << net.n << " layers store their output as NHWC, " << converted_layers << " convolutional layers converted." << std::endl;
+	}
+
+	return nhwc_layers;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+/** @file
+ * Inference on the CPU with the channels last (NHWC).  Darknet normally stores every tensor as NCHW, where each channel
+ * is a complete plane.  When @p --nhwc is used, the network is converted once it has been loaded, and the layers which
+ * have an NHWC implementation then store their output with all of the channels of a pixel next to each other.
+ *
+ * The layers which support NHWC are @p [convolutional], @p [maxpool], @p [route], @p [shortcut], and @p [upsample].
+ * Everything else, including @p [yolo], keeps using NCHW.  A convolutional layer can read and write either layout, so
+ * the conversion between the two layouts happens for free in the convolutional layers at the edges of each NHWC
+ * section of the network.
+ */
+
+
+#include "darknet_internal.hpp"
+
+
+namespace Darknet
+{
+	/** Decide which layers store their output as NHWC, and convert the convolutional layers to
+	 * @ref Darknet::EConvolutionAlgorithm::kNHWC.  This is called by @ref select_convolution_algorithms() when
+	 * @p --nhwc is used, and is only for inference on the CPU.
+	 *
+	 * A layer is converted when it supports NHWC and every layer which reads its output can also read NHWC.  The last
+	 * layer and the output layers always remain NCHW.
+	 *
+	 * @returns The number of layers which store their output as NHWC.
+	 *
+	 * @since 2026-10-17
+	 */
+	int convert_network_to_nhwc(Darknet::Network & net);
+}
@@ -0,0 +1,463 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/** Layer types for which we know exactly which outputs are read during the forward pass.  If a network contains
+	 * any other type of layer, then the memory plan is not applied.
+	 */
+	static inline bool is_supported(const Darknet::Layer & l)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		switch (l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:
+			case Darknet::ELayerType::MAXPOOL:
+			case Darknet::ELayerType::LOCAL_AVGPOOL:
+			case Darknet::ELayerType::AVGPOOL:
+			case Darknet::ELayerType::ROUTE:
+			case Darknet::ELayerType::SHORTCUT:
+			case Darknet::ELayerType::SCALE_CHANNELS:
+			case Darknet::ELayerType::SAM:
+			case Darknet::ELayerType::UPSAMPLE:
+			case Darknet::ELayerType::REORG:
+			case Darknet::ELayerType::DROPOUT:
+			case Darknet::ELayerType::YOLO:
+			case Darknet::ELayerType::GAUSSIAN_YOLO:
+			case Darknet::ELayerType::REGION:
+			{
+				return true;
+			}
+			default:
+			{
+				return false;
+			}
+		}
+	}
+
+
+	/// Output layers are read after the forward pass to build the bounding boxes, so they must stay alive until the end.
+	static inline bool is_output_layer(const Darknet::Layer & l)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		return	l.type == Darknet::ELayerType::YOLO			or
+				l.type == Darknet::ELayerType::GAUSSIAN_YOLO	or
+				l.type == Darknet::ELayerType::REGION;
+	}
+
+
+	/// The temporary buffer some activations need during the forward pass, which is only used again in backpropagation.
+	static inline bool has_activation_input(const Darknet::Layer & l)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		return	l.type == Darknet::ELayerType::CONVOLUTIONAL	and
+				l.activation_input != nullptr				and
+				(l.activation == SWISH or l.activation == MISH or l.activation == HARD_MISH);
+	}
+
+
+	/** A buffer which must be placed into one of the arenas.  The buffer is needed from the forward pass of layer
+	 * @p first until the forward pass of layer @p last has finished.
+	 */
+	struct Tensor
+	{
+		int layer;
+		bool is_output;	///< @p true for @p l.output, @p false for @p l.activation_input
+		size_t size;	///< number of floats
+		int first;
+		int last;
+		int arena;
+	};
+
+
+	/// Shortcut layers keep a copy of the output pointers they read, which must be refreshed when the outputs move.
+	static void update_shortcut_inputs(Darknet::Network & net)
+	{
+		TAT(TATPARMS);
+
+		for (int i = 0; i < net.n; ++i)
+		{
+			Darknet::Layer & l = net.layers[i];
+			if (l.type == Darknet::ELayerType::SHORTCUT and l.layers_output)
+			{
+				for (int k = 0; k < l.n; ++k)
+				{
+					l.layers_output[k] = net.layers[l.input_layers[k]].output;
+				}
+			}
+		}
+
+		return;
+	}
+
+
+	/// Number of floats copied by the route layers during each forward pass.
+	struct RouteCopies
+	{
+		size_t before;	///< without any aliasing
+		size_t after;	///< once the outputs have been placed by @ref find_route_aliases()
+	};
+
+
+	/** Find the route layers which don't need to copy anything.  A route with a single input is a view of that input,
+	 * including the slice of channels selected with @p groups and @p group_id.  A route with several inputs owns the
+	 * output, and each input layer writes directly into its own slice of that output, unless the input layer already
+	 * belongs to another route.  Only NCHW outputs with a batch size of 1 can be placed this way, since otherwise the
+	 * slices are not contiguous.
+	 *
+	 * @ref forward_route_layer() skips any copy where the source and the destination are the same memory.
+	 */
+	static RouteCopies find_route_aliases(const Darknet::Network & net, Darknet::VInt & owner, std::vector<size_t> & offset)
+	{
+		TAT(TATPARMS);
+
+		RouteCopies copies = {0, 0};
+
+		for (int i = 0; i < net.n; ++i)
+		{
+			const Darknet::Layer & l = net.layers[i];
+			if (l.type != Darknet::ELayerType::ROUTE)
+			{
+				continue;
+			}
+
+			size_t route_size = 0;
+			for (int k = 0; k < l.n; ++k)
+			{
+				route_size += static_cast<size_t>(l.input_sizes[k] / l.groups) * l.batch;
+			}
+			copies.before += route_size;
+
+			if (l.output_layout != Darknet::ETensorLayout::kNCHW or (l.batch != 1 and (l.n != 1 or l.groups != 1)))
+			{
+				copies.after += route_size;
+				continue;
+			}
+
+			if (l.n == 1)
+			{
+				const int idx = l.input_layers[0];
+				owner[i]	= idx;
+				offset[i]	= static_cast<size_t>(l.input_sizes[0] / l.groups) * l.group_id;
+				continue;
+			}
+
+			if (l.groups != 1)
+			{
+				copies.after += route_size;
+				continue;
+			}
+
+			size_t position = 0;
+			for (int k = 0; k < l.n; ++k)
+			{
+				const int idx = l.input_layers[k];
+				if (owner[idx] == idx and not is_output_layer(net.layers[idx]))
+				{
+					owner[idx]	= i;
+					offset[idx]	= position;
+				}
+				else
+				{
+					copies.after += l.input_sizes[k];
+				}
+				position += l.input_sizes[k];
+			}
+		}
+
+		return copies;
+	}
+
+
+	static bool is_in_arena(const Darknet::NetworkDetails & details, const float * ptr)
+	{
+		TAT(TATPARMS);
+
+		for (const auto & arena : details.activation_arenas)
+		{
+			if (ptr >= arena.data() and ptr < arena.data() + arena.size())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+
+size_t plan_activation_memory(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (net.details == nullptr or net.n < 1 or cfg_and_state.gpu_index >= 0)
+	{
+		return 0;
+	}
+
+	if (not net.details->activation_arenas.empty())
+	{
+		// the network has already been planned; start again from private allocations
+		clear_activation_memory_plan(net, true);
+	}
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+		if (not is_supported(l))
+		{
+			if (cfg_and_state.is_verbose)
+			{
+				*cfg_and_state.output << "Activation memory is not planned since layer #" << i << " is of type " << Darknet::to_string(l.type) << "." << std::endl;
+			}
+			return 0;
+		}
+	}
+
+	/* Some outputs are placed inside the output of another layer, in which case "owner" is the layer whose output
+	 * contains it, and "offset" is where it starts.  Dropout layers have no output of their own, they re-use the output
+	 * from the previous layer.  Routes are handled by find_route_aliases().
+	 */
+	Darknet::VInt owner(net.n);
+	std::vector<size_t> offset(net.n, 0);
+	for (int i = 0; i < net.n; ++i)
+	{
+		owner[i] = (i > 0 and net.layers[i].type == Darknet::ELayerType::DROPOUT) ? i - 1 : i;
+	}
+	const RouteCopies route_copies = find_route_aliases(net, owner, offset);
+
+	// follow the chain of owners so each output points directly to the layer which owns the memory
+	for (int i = 0; i < net.n; ++i)
+	{
+		while (owner[i] != owner[owner[i]])
+		{
+			offset[i] += offset[owner[i]];
+			owner[i] = owner[owner[i]];
+		}
+	}
+
+	// find the first layer which writes to each output, and the last layer which reads it
+	Darknet::VInt first_use(net.n);
+	Darknet::VInt last_use(net.n);
+	for (int i = 0; i < net.n; ++i)
+	{
+		first_use[i] = i;
+		last_use[i] = i;
+	}
+	for (int i = 0; i < net.n; ++i)
+	{
+		first_use[owner[i]]	= std::min(first_use[owner[i]], i);
+		last_use[owner[i]]	= std::max(last_use[owner[i]], i);
+	}
+	last_use[owner[net.n - 1]] = net.n;
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+
+		if (is_output_layer(l))
+		{
+			last_use[owner[i]] = net.n;
+		}
+
+		// every layer except for "route" reads the output from the previous layer
+		if (i > 0 and l.type != Darknet::ELayerType::ROUTE)
+		{
+			last_use[owner[i - 1]] = std::max(last_use[owner[i - 1]], i);
+		}
+
+		if (l.type == Darknet::ELayerType::ROUTE or l.type == Darknet::ELayerType::SHORTCUT)
+		{
+			for (int k = 0; k < l.n; ++k)
+			{
+				const int idx = owner[l.input_layers[k]];
+				last_use[idx] = std::max(last_use[idx], i);
+			}
+		}
+		else if (l.type == Darknet::ELayerType::SAM or l.type == Darknet::ELayerType::SCALE_CHANNELS)
+		{
+			const int idx = owner[l.index];
+			last_use[idx] = std::max(last_use[idx], i);
+		}
+	}
+
+	/* When the output is decoded lazily, a [yolo] layer keeps a pointer to its input which is only read once the forward
+	 * pass is done, by get_yolo_detections_v3() or finish_lazy_yolo_output().  So the input must stay valid until the
+	 * end, the same as the output.  See Darknet::NetworkDetails::lazy_yolo_output.
+	 */
+	for (int i = 1; i < net.n; ++i)
+	{
+		if (net.layers[i].type == Darknet::ELayerType::YOLO)
+		{
+			last_use[owner[i - 1]] = net.n;
+		}
+	}
+
+	/* "original_size" is what the planned buffers would need on their own.  The outputs placed inside the output of
+	 * another layer by find_route_aliases() are not planned at all, so they are reported separately as "aliased_size".
+	 */
+	std::vector<Tensor> tensors;
+	size_t original_size	= 0;
+	size_t aliased_size		= 0;
+	for (int i = 0; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+		const size_t size = static_cast<size_t>(l.outputs) * l.batch;
+
+		if (owner[i] == i)
+		{
+			tensors.push_back({i, true, size, first_use[i], last_use[i], -1});
+			original_size += size;
+		}
+		else if (l.type != Darknet::ELayerType::DROPOUT)
+		{
+			aliased_size += size;
+		}
+
+		// layers which write into the output of a route still need their own activation input
+		if (has_activation_input(l))
+		{
+			tensors.push_back({i, false, size, i, i, -1});
+			original_size += size;
+		}
+	}
+
+	// the outputs which contain the output of earlier layers are needed before their own layer runs
+	std::stable_sort(tensors.begin(), tensors.end(), [](const Tensor & lhs, const Tensor & rhs) { return lhs.first < rhs.first; });
+
+	/* Greedy assignment in the order in which the layers are executed.  Once the last reader of a tensor has run, the
+	 * arena it was using becomes available for the next tensors.  A free arena which is large enough is preferred,
+	 * otherwise the largest free arena is grown.
+	 */
+	std::vector<size_t> arena_size;
+	std::vector<int> arena_busy_until;
+	for (auto & tensor : tensors)
+	{
+		int best = -1;
+		for (size_t idx = 0; idx < arena_size.size(); idx ++)
+		{
+			if (arena_busy_until[idx] >= tensor.first)
+			{
+				continue;
+			}
+
+			if (best < 0)
+			{
+				best = static_cast<int>(idx);
+				continue;
+			}
+
+			const bool fits			= arena_size[idx]	>= tensor.size;
+			const bool best_fits	= arena_size[best]	>= tensor.size;
+			if ((fits and not best_fits) or
+				(fits and best_fits and arena_size[idx] < arena_size[best]) or
+				(not fits and not best_fits and arena_size[idx] > arena_size[best]))
+			{
+				best = static_cast<int>(idx);
+			}
+		}
+
+		if (best < 0)
+		{
+			best = static_cast<int>(arena_size.size());
+			arena_size.push_back(0);
+			arena_busy_until.push_back(-1);
+		}
+
+		tensor.arena			= best;
+		arena_size[best]		= std::max(arena_size[best], tensor.size);
+		arena_busy_until[best]	= tensor.last;
+	}
+
+	auto & arenas = net.details->activation_arenas;
+	arenas.resize(arena_size.size());
+	size_t planned_size = 0;
+	for (size_t idx = 0; idx < arena_size.size(); idx ++)
+	{
+		arenas[idx].assign(arena_size[idx], 0.0f);
+		planned_size += arena_size[idx];
+	}
+
+	for (const auto & tensor : tensors)
+	{
+		Darknet::Layer & l = net.layers[tensor.layer];
+		float * & ptr = tensor.is_output ? l.output : l.activation_input;
+		free(ptr);
+		ptr = arenas[tensor.arena].data();
+	}
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		Darknet::Layer & l = net.layers[i];
+		if (owner[i] != i)
+		{
+			if (l.type != Darknet::ELayerType::DROPOUT)
+			{
+				free(l.output);
+			}
+			l.output = net.layers[owner[i]].output + offset[i];
+		}
+	}
+	update_shortcut_inputs(net);
+
+	if (cfg_and_state.is_verbose)
+	{
+		*cfg_and_state.output
+			<< "Activation memory reduced from " << size_to_IEC_string(original_size * sizeof(float))
+			<< " to " << size_to_IEC_string(planned_size * sizeof(float))
+			<< " using " << arenas.size() << " shared buffers." << std::endl
+			<< "Route layers copy " << size_to_IEC_string(route_copies.after * sizeof(float))
+			<< " per forward pass instead of " << size_to_IEC_string(route_copies.before * sizeof(float))
+			<< ", and " << size_to_IEC_string(aliased_size * sizeof(float)) << " of outputs are placed inside other outputs." << std::endl;
+	}
+
+	return original_size + aliased_size - planned_size;
+}
+
+
+void clear_activation_memory_plan(Darknet::Network & net, const bool reallocate)
+{
+	TAT(TATPARMS);
+
+	if (net.details == nullptr or net.details->activation_arenas.empty())
+	{
+		return;
+	}
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		Darknet::Layer & l = net.layers[i];
+
+		for (float ** ptr : {&l.output, &l.activation_input})
+		{
+			if (*ptr and is_in_arena(*net.details, *ptr))
+			{
+				*ptr = nullptr;
+				if (reallocate and l.type != Darknet::ELayerType::DROPOUT)
+				{
+					*ptr = (float*)xcalloc(static_cast<size_t>(l.outputs) * l.batch, sizeof(float));
+				}
+			}
+		}
+
+		if (reallocate and l.type == Darknet::ELayerType::DROPOUT and i > 0)
+		{
+			l.output = net.layers[i - 1].output;
+		}
+	}
+
+	if (reallocate)
+	{
+		update_shortcut_inputs(net);
+	}
+
+	net.details->activation_arenas.clear();
+
+	return;
+}
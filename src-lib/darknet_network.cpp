@@ -4,6 +4,29 @@
 namespace
 {
 	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// Find the first output layer, which determines the number of classes and the shape of each detection.
+	static inline const Darknet::Layer & find_output_layer(const Darknet::Network * net)
+	{
+		TAT(TATPARMS);
+
+		for (int i = 0; i < net->n; ++i)
+		{
+			/// @todo Is anything but YOLO still used as an output layer in a modern .cfg file?  Should these be removed?
+
+			const Darknet::Layer & tmp = net->layers[i];
+			if (tmp.type == Darknet::ELayerType::YOLO			or
+				tmp.type == Darknet::ELayerType::GAUSSIAN_YOLO	or
+				tmp.type == Darknet::ELayerType::REGION			)
+			{
+				return tmp;
+			}
+		}
+
+		// if nothing was found we'll use the last layer
+		return net->layers[net->n - 1];
+	}
 }
 
 
@@ -27,6 +50,10 @@ Darknet::NetworkDetails::NetworkDetails()
 	annotate_draw_bb						= true;
 	annotate_draw_label						= true;
 
+	allocated_batch							= 1;
+	workspace_size							= 0;
+	lazy_yolo_output						= false;
+
 	return;
 }
 
@@ -517,7 +544,6 @@ int recalculate_workspace_size(Darknet::Network * net)
 
 #ifdef DARKNET_GPU
 	cuda_set_device(net->gpu_index);
-	if (cfg_and_state.gpu_index >= 0) cuda_free(net->workspace);
 #endif
 
 	size_t workspace_size = 0;
@@ -540,9 +566,16 @@ int recalculate_workspace_size(Darknet::Network * net)
 		}
 	}
 
+	// keep using the existing workspace if it is already large enough, such as when the batch size is made smaller
+	if (net->workspace and net->details and workspace_size <= net->details->workspace_size)
+	{
+		return 0;
+	}
+
 #ifdef DARKNET_GPU
 	if (cfg_and_state.gpu_index >= 0)
 	{
+		cuda_free(net->workspace);
 		const auto workspace_to_allocate = workspace_size / sizeof(float) + 1;
 		*cfg_and_state.output << std::endl << "allocating workspace: " << size_to_IEC_string(workspace_to_allocate) << std::endl;
 		net->workspace = cuda_make_array(0, workspace_to_allocate);
@@ -558,6 +591,11 @@ int recalculate_workspace_size(Darknet::Network * net)
 	net->workspace = (float*)xcalloc(1, workspace_size);
 #endif
 
+	if (net->details)
+	{
+		net->details->workspace_size = workspace_size;
+	}
+
 	return 0;
 }
 
@@ -592,6 +630,10 @@ int resize_network(Darknet::Network * net, int w, int h)
 {
 	TAT(TATPARMS);
 
+	// the layers must own their outputs so they can be re-allocated
+	const bool planned = (net->details and net->details->activation_arenas.empty() == false);
+	clear_activation_memory_plan(*net, true);
+
 #ifdef DARKNET_GPU
 	cuda_set_device(net->gpu_index);
 	if (cfg_and_state.gpu_index >= 0)
@@ -724,6 +766,17 @@ int resize_network(Darknet::Network * net, int w, int h)
 	}
 	*cfg_and_state.output << " begins at " << (void*)net->workspace << std::endl;
 
+	if (net->details)
+	{
+		net->details->allocated_batch	= net->batch;
+		net->details->workspace_size	= workspace_size;
+	}
+
+	if (planned)
+	{
+		plan_activation_memory(*net);
+	}
+
 	return 0;
 }
 
@@ -885,7 +938,7 @@ int num_detections_v3(Darknet::Network * net, float thresh, Darknet::Output_Obje
 		const Darknet::Layer & l = net->layers[i];
 		if (l.type == Darknet::ELayerType::YOLO)
 		{
-			/// @todo V3 JAZZ:  this is where we spend all our time
+			// this used to be where we spent all our time; see yolo_compact_objectness() and "darknet benchmark_yolo"
 			detections += yolo_num_detections_v3(net, i, thresh, cache);
 		}
 
@@ -1002,24 +1055,7 @@ Darknet::Detection * make_network_boxes_v3(Darknet::Network * net, const float t
 	TAT(TATPARMS);
 
 	// find a layer that is one of these types
-	const Darknet::Layer & l = [&net]()
-	{
-		for (int i = 0; i < net->n; ++i)
-		{
-			/// @todo Is anything but YOLO still used as an output layer in a modern .cfg file?  Should these be removed?
-
-			const Darknet::Layer & tmp = net->layers[i];
-			if (tmp.type == Darknet::ELayerType::YOLO			or
-				tmp.type == Darknet::ELayerType::GAUSSIAN_YOLO	or
-				tmp.type == Darknet::ELayerType::REGION			)
-			{
-				return tmp;
-			}
-		}
-
-		// if nothing was found we'll use the last layer
-		return net->layers[net->n - 1];
-	}();
+	const Darknet::Layer & l = find_output_layer(net);
 
 	/// @todo V3 JAZZ:  97% of this function is spent in this next line
 	const int nboxes = num_detections_v3(net, thresh, cache);
@@ -1169,6 +1205,7 @@ void fill_network_boxes(Darknet::Network * net, int w, int h, float thresh, floa
 			case Darknet::ELayerType::YOLO:
 			{
 				/// @todo V3 JAZZ:  most of the time is spent in this function
+				finish_lazy_yolo_output(net->layers[j]);
 				dets += get_yolo_detections(l, w, h, net->w, net->h, thresh, map, relative, dets, letter);
 
 				if (prev_classes < 0)
@@ -1224,6 +1261,7 @@ void fill_network_boxes_batch(Darknet::Network * net, int w, int h, float thresh
 		const Darknet::Layer & l = net->layers[j];
 		if (l.type == Darknet::ELayerType::YOLO)
 		{
+			finish_lazy_yolo_output(net->layers[j]);
 			int count = get_yolo_detections_batch(l, w, h, net->w, net->h, thresh, map, relative, dets, letter, batch);
 			dets += count;
 			if (prev_classes < 0)
@@ -1274,6 +1312,94 @@ detection * get_network_boxes(DarknetNetworkPtr ptr, int w, int h, float thresh,
 }
 
 
+Darknet::Detection * Darknet::DetectionPool::acquire(const Darknet::Layer & l, const int count)
+{
+	TAT(TATPARMS);
+
+	const size_t number_of_detections	= std::max(0, count);
+	const size_t classes				= std::max(0, l.classes);
+	const size_t mask_size				= (l.coords > 4 ? l.coords - 4 : 0);
+	const size_t uc_size				= (l.type == Darknet::ELayerType::GAUSSIAN_YOLO ? 4 : 0);
+	const size_t embedding_size			= (l.embedding_output ? std::max(0, l.embedding_size) : 0);
+
+	// the vectors only ever grow, which is what allows us to skip all the heap allocations once we've "warmed up"
+	const auto grow = [](auto & v, const size_t len)
+	{
+		if (v.size() < len)
+		{
+			v.resize(std::max(len, v.size() * 2));
+		}
+	};
+
+	grow(detections	, number_of_detections);
+	grow(prob		, number_of_detections * classes);
+	grow(mask		, number_of_detections * mask_size);
+	grow(uc			, number_of_detections * uc_size);
+	grow(embeddings	, number_of_detections * embedding_size);
+
+	// this is what xcalloc() used to do for us in make_network_boxes_v3()
+	std::fill_n(prob		.begin(), number_of_detections * classes		, 0.0f);
+	std::fill_n(mask		.begin(), number_of_detections * mask_size		, 0.0f);
+	std::fill_n(uc			.begin(), number_of_detections * uc_size		, 0.0f);
+	std::fill_n(embeddings	.begin(), number_of_detections * embedding_size	, 0.0f);
+
+	for (size_t i = 0; i < number_of_detections; i ++)
+	{
+		Darknet::Detection & det = detections[i];
+		det = Darknet::Detection();
+
+		det.prob			= prob.data() + i * classes;
+		det.mask			= (mask_size		? mask		.data() + i * mask_size			: nullptr);
+		det.uc				= (uc_size			? uc		.data() + i * uc_size			: nullptr);
+		det.embeddings		= (embedding_size	? embeddings.data() + i * embedding_size	: nullptr);
+		det.embedding_size	= l.embedding_size;
+	}
+
+	return detections.data();
+}
+
+
+Darknet::Detection * get_network_boxes_pooled(Darknet::Network * net, int w, int h, float thresh, float hier, int * map, int relative, int * num, int letter)
+{
+	TAT(TATPARMS);
+
+	// this is the same as get_network_boxes(), but both the object cache and the detections are re-used
+
+	auto & pool = net->details->detection_pool;
+	pool.cache.clear();
+
+	const int nboxes = num_detections_v3(net, thresh, pool.cache);
+	if (num)
+	{
+		*num = nboxes;
+	}
+
+	Darknet::Detection * dets = pool.acquire(find_output_layer(net), nboxes);
+	fill_network_boxes_v3(net, w, h, thresh, hier, map, relative, dets, letter, pool.cache);
+
+	return dets;
+}
+
+
+Darknet::Detection * get_network_boxes_batch_pooled(Darknet::Network * net, int w, int h, float thresh, float hier, int * map, int relative, int * num, int letter, int batch)
+{
+	TAT(TATPARMS);
+
+	// this is the same as make_network_boxes_batch() + fill_network_boxes_batch(), but the detections are re-used
+
+	const int nboxes = num_detections_batch(net, thresh, batch);
+	if (num)
+	{
+		*num = nboxes;
+	}
+
+	Darknet::Detection * dets = net->details->detection_pool.acquire(find_output_layer(net), nboxes);
+	fill_network_boxes_batch(net, w, h, thresh, hier, map, relative, dets, letter, batch);
+
+	return dets;
+}
+
+
 void free_detections(detection * dets, int n)
 {
 	TAT(TATPARMS);
@@ -1577,6 +1703,9 @@ void free_network(Darknet::Network & net)
 {
 	TAT(TATPARMS);
 
+	// the shared activation buffers are freed with the details
+	clear_activation_memory_plan(net, false);
+
 	for (int i = 0; i < net.n; ++i)
 	{
 		free_layer(net.layers[i]);
@@ -1646,6 +1775,102 @@ void free_network(Darknet::Network & net)
 }
 
 
+Darknet::Network * create_network_replica(const Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (net.details == nullptr or net.details->cfg_path.empty())
+	{
+		throw std::invalid_argument("cannot create a replica of a neural network which was not loaded from a .cfg file");
+	}
+
+	Darknet::Network parsed = parse_network_cfg_custom(net.details->cfg_path.string().c_str(), 1, 1);
+
+	// if anything goes wrong the replica is freed without touching the parameters of the original network
+	const auto deleter = [&net](Darknet::Network * ptr) { free_network_replica(ptr, net); };
+	std::unique_ptr<Darknet::Network, decltype(deleter)> replica((Darknet::Network*)xcalloc(1, sizeof(Darknet::Network)), deleter);
+	*replica = parsed;
+
+	if (replica->n != net.n)
+	{
+		throw std::runtime_error("replica of \"" + net.details->cfg_path.string() + "\" does not have the same number of layers");
+	}
+
+	/* The replica must end up with the same layer settings as the original network.  Fusing the batchnorm has no use
+	 * here other than resetting the flags and freeing the same arrays which were freed in the original network, since
+	 * all of the parameters are about to be replaced.  The convolution algorithms are not selected, since that would
+	 * transform the random weights of the replica; the transformed weights and algorithms of the original network are
+	 * shared instead.
+	 */
+	fuse_conv_batchnorm(*replica, false);
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		Darknet::share_layer_parameters(replica->layers[i], net.layers[i]);
+	}
+
+	// the shared algorithms usually need less workspace than the im2col workspace allocated when the .cfg was parsed
+	replica->details->workspace_size = 0;
+	recalculate_workspace_size(replica.get());
+
+	// XNOR layers need their bit-aligned weights, which can only be calculated now that the real weights are available
+	calculate_binary_weights(replica.get());
+
+	if (replica->w != net.w or replica->h != net.h)
+	{
+		resize_network(replica.get(), net.w, net.h);
+	}
+
+	plan_activation_memory(*replica);
+
+	// copy everything the user may have configured, but not the buffers used to run predictions
+	Darknet::NetworkDetails & details = *replica->details;
+	const Darknet::NetworkDetails & original = *net.details;
+	details.cfg_path								= original.cfg_path;
+	details.names_path								= original.names_path;
+	details.weights_path							= original.weights_path;
+	details.class_names								= original.class_names;
+	details.class_colours							= original.class_colours;
+	details.text_colours							= original.text_colours;
+	details.detection_threshold						= original.detection_threshold;
+	details.non_maximal_suppression_threshold		= original.non_maximal_suppression_threshold;
+	details.fix_out_of_bound_normalized_coordinates	= original.fix_out_of_bound_normalized_coordinates;
+	details.cv_line_type							= original.cv_line_type;
+	details.cv_font_face							= original.cv_font_face;
+	details.cv_font_thickness						= original.cv_font_thickness;
+	details.cv_font_scale							= original.cv_font_scale;
+	details.bounding_boxes_with_rounded_corners		= original.bounding_boxes_with_rounded_corners;
+	details.bounding_boxes_corner_roundness			= original.bounding_boxes_corner_roundness;
+	details.annotate_draw_bb						= original.annotate_draw_bb;
+	details.annotate_draw_label						= original.annotate_draw_label;
+	details.classes_to_ignore						= original.classes_to_ignore;
+
+	return replica.release();
+}
+
+
+void free_network_replica(Darknet::Network * replica, const Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (replica == nullptr)
+	{
+		return;
+	}
+
+	// forget about the shared parameters so they don't get freed with the rest of the replica
+	for (int i = 0; i < replica->n and i < net.n; ++i)
+	{
+		Darknet::unshare_layer_parameters(replica->layers[i], net.layers[i]);
+	}
+
+	free_network(*replica);
+	free(replica);
+
+	return;
+}
+
+
 static float lrelu(float src)
 {
 	TAT(TATPARMS);
@@ -1660,7 +1885,7 @@ static float lrelu(float src)
 }
 
 
-void fuse_conv_batchnorm(Darknet::Network & net)
+void fuse_conv_batchnorm(Darknet::Network & net, const bool select_algorithms)
 {
 	TAT(TATPARMS);
 
@@ -1761,6 +1986,12 @@ void fuse_conv_batchnorm(Darknet::Network & net)
 #endif
 		}
 	}
+
+	// now that the weights are final, the convolutional layers can use the faster inference-only algorithms
+	if (select_algorithms)
+	{
+		select_convolution_algorithms(net);
+	}
 }
 
 
@@ -9,6 +9,41 @@
 
 namespace Darknet
 {
+	/** Re-usable memory for the detections returned by @ref get_network_boxes_pooled().  The original @ref get_network_boxes()
+	 * would @p xcalloc() the detection array plus several small arrays for every candidate box, only for all of it to be
+	 * freed again by @ref free_detections() once the frame had been processed.  The pool only ever grows, so once it has
+	 * seen the largest number of candidate boxes there are no more heap allocations when processing additional frames.
+	 *
+	 * Detections obtained from the pool belong to the pool.  Do @em not call @ref free_detections() on them, and do not
+	 * keep them past the next call which uses the same pool.
+	 *
+	 * @see @ref Darknet::NetworkDetails::detection_pool
+	 *
+	 * @since 2026-10-17
+	 */
+	struct DetectionPool
+	{
+		public:
+
+			/** Get @p count detections sized for the given output layer.  All of the detections and the arrays they
+			 * point to are reset to zero, similar to what @p xcalloc() used to do.  Previous detections obtained from
+			 * this pool are invalidated.
+			 */
+			Darknet::Detection * acquire(const Darknet::Layer & l, const int count);
+
+			/// The object cache used to find the detections in the YOLO output layers.
+			Output_Object_Cache cache;
+
+			/// @{ The memory backing the detections.  These vectors are never shrunk.
+			std::vector<Darknet::Detection> detections;
+			VFloat prob;
+			VFloat mask;
+			VFloat uc;
+			VFloat embeddings;
+			/// @}
+	};
+
+
 	/** A place to store other details related to the neural network which we cannot easily add to the usual
 	 * @ref Darknet::Network structure.  These are typically C++ objects, or things added post %Darknet V3 (2024-08).
 	 *
@@ -139,6 +174,55 @@ namespace Darknet
 			 * @since 2024-10-07
 			 */
 			SInt classes_to_ignore;
+
+			/** Detections re-used by @ref Darknet::predict() from one call to the next.
+			 *
+			 * @see @ref get_network_boxes_pooled()
+			 *
+			 * @since 2026-10-17
+			 */
+			DetectionPool detection_pool;
+
+			/** The network input re-used by @ref Darknet::predict() from one call to the next.  Images are converted
+			 * directly into this buffer by @ref Darknet::bgr_mat_to_planar_rgb().
+			 *
+			 * @since 2026-10-17
+			 */
+			VFloat input_buffer;
+
+			/** The batch size for which the layer outputs were last allocated by @ref resize_network().  A smaller batch
+			 * can re-use those buffers, so @ref Darknet::predict() only needs to re-allocate when the batch grows.
+			 *
+			 * @since 2026-10-17
+			 */
+			int allocated_batch;
+
+			/** The number of bytes allocated for @ref Darknet::Network::workspace.  @ref recalculate_workspace_size() only
+			 * re-allocates the workspace when it needs to grow, so changing the batch size back and forth does not cause
+			 * the workspace to be re-allocated each time.
+			 *
+			 * @since 2026-10-17
+			 */
+			size_t workspace_size;
+
+			/** When set, the @p [yolo] layers only activate the objectness during inference, and the rest of their
+			 * output is decoded on demand by @ref get_yolo_detections_v3().  This is only turned on by
+			 * @ref Darknet::predict() while it runs a single image, since the detections are extracted right away.  The
+			 * C API and everything else which reads the output of the network needs the output to be complete.
+			 *
+			 * @see @ref finish_lazy_yolo_output()
+			 *
+			 * @since 2026-10-17
+			 */
+			bool lazy_yolo_output;
+
+			/** Shared buffers which hold the layer outputs once the activation memory has been planned for inference.
+			 *
+			 * @see @ref plan_activation_memory()
+			 *
+			 * @since 2026-10-17
+			 */
+			std::vector<VFloat> activation_arenas;
 	};
 
 
@@ -274,6 +358,10 @@ namespace Darknet
 			//#endif  // DARKNET_GPU
 			int optimized_memory;
 			int dynamic_minibatch;
+			int prefetch;	///< number of batches loaded ahead of training, @see @ref Darknet::start_batch_prefetch()
+			size_t image_cache_size_limit;	///< @see @ref Darknet::configure_image_cache()
+			float image_cache_max_side;		///< relative to the largest network dimensions reached with @p random=1, @see @ref Darknet::configure_image_cache()
+			int reduced_decoding;			///< whether large JPEG images may be decoded at a reduced size, @see @ref Darknet::configure_reduced_decoding()
 			size_t workspace_size_limit;
 			Darknet::NetworkDetails * details;
 	};
@@ -321,6 +409,52 @@ Darknet::Network make_network(int n);
  */
 void free_network(Darknet::Network & net);
 
+/** Create a new network from the same @p .cfg file as @p net, sharing the read-only weights, biases, and batchnorm
+ * parameters of @p net instead of allocating and loading new ones.  The replica owns only the memory needed to run
+ * predictions, such as the layer outputs and the workspace.  The batch size of the replica is always @p 1.
+ *
+ * The original network must outlive the replica.  Use @ref free_network_replica() to free it.
+ *
+ * @see @ref Darknet::NetworkPool
+ *
+ * @since 2026-10-17
+ */
+Darknet::Network * create_network_replica(const Darknet::Network & net);
+
+/** Inference-only memory planning.  The lifetime of each layer output is determined by looking at which layers read
+ * it (the next layer, plus the inputs of @p route, @p shortcut, @p sam, and @p scale_channels layers).  Outputs which
+ * are no longer needed have their memory re-used by the layers which follow, so all the outputs are placed into a
+ * small number of shared buffers stored in @ref Darknet::NetworkDetails::activation_arenas.  The outputs of the YOLO
+ * layers and the last layer are kept until the end of the forward pass, as are the inputs of the YOLO layers since
+ * they may be decoded lazily.
+ *
+ * Route layers are also made zero-copy where possible:  a route with a single input becomes a view of that input, and
+ * the layers which feed a route with several inputs write their output directly into the output of the route.
+ *
+ * Does nothing when running on a GPU, or when the network contains a layer type which is not understood.
+ *
+ * @warning The network can no longer be trained or used for backpropagation once the memory has been planned.
+ *
+ * @returns the number of floats saved
+ *
+ * @since 2026-10-17
+ */
+size_t plan_activation_memory(Darknet::Network & net);
+
+/** Undo @ref plan_activation_memory().  When @p reallocate is @p true each layer is given back its own output, which
+ * is needed prior to resizing the network.  Otherwise the outputs are set to @p nullptr, such as when the network is
+ * about to be freed.
+ *
+ * @since 2026-10-17
+ */
+void clear_activation_memory_plan(Darknet::Network & net, const bool reallocate);
+
+/** Free a replica created with @ref create_network_replica().  The parameters shared with @p net are left untouched.
+ *
+ * @since 2026-10-17
+ */
+void free_network_replica(Darknet::Network * replica, const Darknet::Network & net);
+
 float get_current_seq_subdivisions(const Darknet::Network & net);
 int get_sequence_value(const Darknet::Network & net);
 
@@ -363,8 +497,27 @@ void reject_similar_weights(Darknet::Network & net, float sim_threshold);
 
 float *network_predict(Darknet::Network & net, float *input);
 det_num_pair* network_predict_batch(Darknet::Network *net, Darknet::Image im, int batch_size, int w, int h, float thresh, float hier, int *map, int relative, int letter);
+
+/** Similar to @ref get_network_boxes(), but the detections are taken from @ref Darknet::NetworkDetails::detection_pool.
+ * Do @em not call @ref free_detections() on the results; they remain valid until the next call which uses the pool.
+ *
+ * @since 2026-10-17
+ */
+Darknet::Detection * get_network_boxes_pooled(Darknet::Network * net, int w, int h, float thresh, float hier, int * map, int relative, int * num, int letter);
+
+/** The batch equivalent of @ref get_network_boxes_pooled().  Returns the detections for image @p batch within the
+ * most recent batched forward pass.
+ *
+ * @since 2026-10-17
+ */
+Darknet::Detection * get_network_boxes_batch_pooled(Darknet::Network * net, int w, int h, float thresh, float hier, int * map, int relative, int * num, int letter, int batch);
 void free_batch_detections(det_num_pair *det_num_pairs, int n);
-void fuse_conv_batchnorm(Darknet::Network & net);
+
+/** Fold the batch normalization into the convolutional weights.  This then calls @ref select_convolution_algorithms()
+ * unless @p select_algorithms is @p false, such as for a network replica which shares the weights already transformed
+ * in another network.
+ */
+void fuse_conv_batchnorm(Darknet::Network & net, const bool select_algorithms = true);
 
 float validate_detector_map(const char * datacfg, const char * cfgfile, const char * weightfile, float thresh_calc_avg_iou, const float iou_thresh, const int map_points, int letter_box, Darknet::Network *existing_net);
 void train_detector(const char *datacfg, const char *cfgfile, const char *weightfile, int *gpus, int ngpus, int clear, int dont_show, int calc_map, float thresh, float iou_thresh, int show_imgs, int benchmark_layers, const char* chart_path);
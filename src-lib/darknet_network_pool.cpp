@@ -0,0 +1,170 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+}
+
+
+Darknet::NetworkPool::Lease::Lease(Darknet::NetworkPool & p, Darknet::NetworkPtr n) :
+	pool(&p),
+	ptr(n)
+{
+	TAT(TATPARMS);
+
+	return;
+}
+
+
+Darknet::NetworkPool::Lease::Lease(Darknet::NetworkPool::Lease && rhs) :
+	pool(rhs.pool),
+	ptr(rhs.ptr)
+{
+	TAT(TATPARMS);
+
+	rhs.pool	= nullptr;
+	rhs.ptr		= nullptr;
+
+	return;
+}
+
+
+Darknet::NetworkPool::Lease::~Lease()
+{
+	TAT(TATPARMS);
+
+	if (pool and ptr)
+	{
+		pool->release(ptr);
+	}
+
+	return;
+}
+
+
+Darknet::NetworkPool::NetworkPool(const std::filesystem::path & cfg_filename, const std::filesystem::path & names_filename, const std::filesystem::path & weights_filename, const size_t replicas)
+{
+	TAT(TATPARMS);
+
+	networks.push_back(Darknet::load_neural_network(cfg_filename, names_filename, weights_filename));
+	create_replicas(replicas);
+
+	return;
+}
+
+
+Darknet::NetworkPool::NetworkPool(Darknet::NetworkPtr & ptr, const size_t replicas)
+{
+	TAT(TATPARMS);
+
+	if (ptr == nullptr)
+	{
+		throw std::invalid_argument("cannot create a network pool without a network pointer");
+	}
+
+	networks.push_back(ptr);
+	ptr = nullptr;
+	create_replicas(replicas);
+
+	return;
+}
+
+
+Darknet::NetworkPool::~NetworkPool()
+{
+	TAT(TATPARMS);
+
+	std::unique_lock lock(mutex);
+	trigger.wait(lock, [&]() { return available.size() == networks.size(); });
+
+	const Darknet::Network & net = *reinterpret_cast<Darknet::Network *>(networks[0]);
+
+	// the replicas must be freed before the network which owns the weights
+	for (size_t idx = 1; idx < networks.size(); idx ++)
+	{
+		free_network_replica(reinterpret_cast<Darknet::Network *>(networks[idx]), net);
+	}
+	Darknet::free_neural_network(networks[0]);
+
+	networks.clear();
+	available.clear();
+
+	return;
+}
+
+
+void Darknet::NetworkPool::create_replicas(const size_t replicas)
+{
+	TAT(TATPARMS);
+
+	const Darknet::Network & net = *reinterpret_cast<Darknet::Network *>(networks[0]);
+
+	try
+	{
+		for (size_t idx = 1; idx < replicas; idx ++)
+		{
+			networks.push_back(create_network_replica(net));
+		}
+	}
+	catch (...)
+	{
+		for (size_t idx = 1; idx < networks.size(); idx ++)
+		{
+			free_network_replica(reinterpret_cast<Darknet::Network *>(networks[idx]), net);
+		}
+		Darknet::free_neural_network(networks[0]);
+		networks.clear();
+		throw;
+	}
+
+	available = networks;
+
+	if (cfg_and_state.is_verbose)
+	{
+		*cfg_and_state.output << "Network pool created with " << networks.size() << " networks sharing the same weights." << std::endl;
+	}
+
+	return;
+}
+
+
+Darknet::NetworkPool::Lease Darknet::NetworkPool::acquire()
+{
+	TAT(TATPARMS);
+
+	std::unique_lock lock(mutex);
+	trigger.wait(lock, [&]() { return available.empty() == false; });
+
+	Darknet::NetworkPtr ptr = available.back();
+	available.pop_back();
+
+	return Lease(*this, ptr);
+}
+
+
+void Darknet::NetworkPool::release(Darknet::NetworkPtr ptr)
+{
+	TAT(TATPARMS);
+
+	if (true)
+	{
+		std::lock_guard lock(mutex);
+		available.push_back(ptr);
+	}
+
+	// the destructor may also be waiting, so wake up every thread
+	trigger.notify_all();
+
+	return;
+}
+
+
+Darknet::Predictions Darknet::NetworkPool::predict(const cv::Mat & mat)
+{
+	TAT(TATPARMS);
+
+	auto lease = acquire();
+
+	return Darknet::predict(lease, mat);
+}
@@ -0,0 +1,314 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// The int8 scales are stored next to the weights, such as @p cars_best.weights and @p cars_best.int8.
+	static std::filesystem::path get_int8_filename(const std::filesystem::path & weights_path)
+	{
+		TAT(TATPARMS);
+
+		std::filesystem::path filename = weights_path;
+		filename.replace_extension(".int8");
+
+		return filename;
+	}
+
+
+	/// Decide if a layer should be quantized.  These are the same conditions used by @ref select_convolution_algorithms().
+	static bool can_quantize(const Darknet::Network & net, const int idx)
+	{
+		TAT(TATPARMS);
+
+		const Darknet::Layer & l = net.layers[idx];
+
+		if (l.type != Darknet::ELayerType::CONVOLUTIONAL	or
+			l.groups != 1									or
+			l.binary										or
+			l.xnor											or
+			l.antialiasing									or
+			l.deform										or
+			l.share_layer									or
+			l.batch_normalize								)
+		{
+			return false;
+		}
+
+		// the first layer sees the original image and only has a few channels, so there is very little to gain
+		if (l.c < 16)
+		{
+			return false;
+		}
+
+		// the layer in front of a detection layer predicts the coordinates of the boxes, which need to remain precise
+		if (idx + 1 < net.n)
+		{
+			const Darknet::ELayerType next = net.layers[idx + 1].type;
+			if (next == Darknet::ELayerType::YOLO			or
+				next == Darknet::ELayerType::GAUSSIAN_YOLO	or
+				next == Darknet::ELayerType::REGION			)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+
+	/// Run the network on a single image and return the average time in milliseconds.
+	static double time_forward_pass(Darknet::Network & net, float * input, const int count)
+	{
+		TAT(TATPARMS);
+
+		network_predict(net, input); // warm up the caches and the packing buffers
+
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		for (int iteration = 0; iteration < count; ++iteration)
+		{
+			network_predict(net, input);
+		}
+		const auto t2 = std::chrono::high_resolution_clock::now();
+
+		return std::chrono::duration<double, std::milli>(t2 - t1).count() / count;
+	}
+}
+
+
+int Darknet::load_int8_scales(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	const std::filesystem::path filename = get_int8_filename(net.details->weights_path);
+
+	std::ifstream ifs(filename);
+	if (not ifs.good())
+	{
+		Darknet::display_warning_msg("The int8 scales \"" + filename.string() + "\" do not exist.  Run \"darknet detector quantize\" to create them.  The network will not be quantized.\n");
+		return 0;
+	}
+
+	int number_of_layers = 0;
+	std::string line;
+	while (std::getline(ifs, line))
+	{
+		if (line.empty() or line[0] == '#')
+		{
+			continue;
+		}
+
+		std::stringstream ss(line);
+		int idx			= -1;
+		float scale		= 0.0f;
+		int filters		= 0;
+		ss >> idx >> scale >> filters;
+
+		if (idx < 0 or idx >= net.n or net.layers[idx].type != Darknet::ELayerType::CONVOLUTIONAL or net.layers[idx].n != filters)
+		{
+			darknet_fatal_error(DARKNET_LOC, "the int8 scales in \"%s\" do not match this network (layer #%d with %d filters)", filename.string().c_str(), idx, filters);
+		}
+
+		Darknet::Layer & l = net.layers[idx];
+		free(l.int8_weight_scales);
+		l.int8_weight_scales = (float*)xcalloc(l.n, sizeof(float));
+		for (int f = 0; f < l.n; ++f)
+		{
+			ss >> l.int8_weight_scales[f];
+		}
+
+		if (ss.fail())
+		{
+			darknet_fatal_error(DARKNET_LOC, "failed to read the int8 scales for layer #%d in \"%s\"", idx, filename.string().c_str());
+		}
+
+		l.int8_input_scale = scale;
+		number_of_layers ++;
+	}
+
+	*cfg_and_state.output << "Loaded int8 scales for " << number_of_layers << " layer" << (number_of_layers == 1 ? "" : "s") << " from " << filename.string() << "." << std::endl;
+
+	return number_of_layers;
+}
+
+
+void Darknet::quantize_network(const char * datacfg, const char * cfgfile, const char * weightfile, const float thresh, const float iou_thresh)
+{
+	TAT(TATPARMS);
+
+	// Example command that calls this function:
+	//
+	//			darknet detector quantize cars.data cars.cfg cars_best.weights
+
+	if (weightfile == nullptr)
+	{
+		darknet_fatal_error(DARKNET_LOC, "quantization requires a .weights file");
+	}
+
+	if (cfg_and_state.gpu_index >= 0)
+	{
+		Darknet::display_warning_msg("The int8 layers only run on the CPU.  The GPU will not be used.\n");
+		Darknet::set_gpu_index(-1);
+	}
+
+	// the scales are about to be calculated again, so the old ones must not be loaded with the network
+	cfg_and_state.args.erase("int8");
+
+	list *options = read_data_cfg(datacfg);
+	const char *train_images = option_find_str(options, "train", nullptr);
+	const char *valid_images = option_find_str(options, "valid", train_images);
+
+	Darknet::Network net = parse_network_cfg_custom(cfgfile, 1, 1); // set batch=1
+	load_weights(&net, weightfile);
+	fuse_conv_batchnorm(net);
+	calculate_binary_weights(&net);
+	Darknet::load_names(&net, option_find_str(options, "names", "unknown.names"));
+
+	list *plist = get_paths(valid_images);
+	char **paths = (char **)list_to_array(plist);
+	const int number_of_images = plist->size;
+	if (number_of_images == 0)
+	{
+		darknet_fatal_error(DARKNET_LOC, "no validation images available (verify %s)", valid_images);
+	}
+	const int calibration_images = std::clamp(cfg_and_state.get("calibration", 200), 1, number_of_images);
+
+	*cfg_and_state.output << "Calibrating int8 scales using " << calibration_images << " of the " << number_of_images << " images in " << valid_images << "." << std::endl;
+
+	/* Record the largest input of every layer for each image.  The average of these maximums is used instead of the
+	 * overall maximum, so a single unusual image does not waste most of the 8 bits on values which are rarely seen.
+	 * Anything larger is clipped when the input is quantized.
+	 */
+	std::vector<double> sum_of_maximums(net.n, 0.0);
+	Darknet::Image first_image = {0};
+	for (int idx = 0; idx < calibration_images; ++idx)
+	{
+		// the images are spread evenly across the validation set
+		const int image_index = static_cast<int>(static_cast<int64_t>(idx) * number_of_images / calibration_images);
+
+		Darknet::Image im = Darknet::load_image(paths[image_index], 0, 0, net.c);
+		Darknet::Image sized = net.letter_box ? Darknet::letterbox_image(im, net.w, net.h) : Darknet::resize_image(im, net.w, net.h);
+		Darknet::free_image(im);
+
+		Darknet::NetworkState state = {0};
+		state.net		= net;
+		state.input		= sized.data;
+		state.workspace	= net.workspace;
+		state.train		= 0;
+
+		for (int i = 0; i < net.n; ++i)
+		{
+			Darknet::Layer & l = net.layers[i];
+			if (can_quantize(net, i))
+			{
+				float maximum = 0.0f;
+				for (int j = 0; j < l.inputs; ++j)
+				{
+					maximum = std::max(maximum, std::fabs(state.input[j]));
+				}
+				sum_of_maximums[i] += maximum;
+			}
+
+			state.index = i;
+			l.forward(l, state);
+			state.input = l.output;
+		}
+
+		if (idx == 0)
+		{
+			first_image = sized;
+		}
+		else
+		{
+			Darknet::free_image(sized);
+		}
+
+		*cfg_and_state.output << "\rcalibrating #" << (idx + 1) << " (" << std::round(100.0f * (idx + 1) / calibration_images) << "%) " << std::flush;
+	}
+	*cfg_and_state.output << std::endl;
+
+	const std::filesystem::path filename = get_int8_filename(weightfile);
+	std::ofstream ofs(filename, std::ios::trunc);
+	if (not ofs.good())
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to create \"%s\"", filename.string().c_str());
+	}
+	ofs << "# Darknet int8 scales for " << std::filesystem::path(weightfile).filename().string() << " calibrated with " << calibration_images << " images" << std::endl
+		<< "# layer, input scale, number of filters, weight scale of each filter" << std::endl
+		<< std::setprecision(9);
+
+	int quantized_layers		= 0;
+	int convolutional_layers	= 0;
+	for (int i = 0; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+		if (l.type == Darknet::ELayerType::CONVOLUTIONAL)
+		{
+			convolutional_layers ++;
+		}
+
+		const float input_scale = static_cast<float>(sum_of_maximums[i] / calibration_images) / 127.0f;
+		if (not can_quantize(net, i) or input_scale <= 0.0f)
+		{
+			continue;
+		}
+
+		const int k = l.size * l.size * l.c;
+		ofs << i << " " << input_scale << " " << l.n;
+		for (int f = 0; f < l.n; ++f)
+		{
+			const float * w = l.weights + static_cast<size_t>(f) * k;
+			float maximum = 0.0f;
+			for (int j = 0; j < k; ++j)
+			{
+				maximum = std::max(maximum, std::fabs(w[j]));
+			}
+			ofs << " " << maximum / 127.0f;
+		}
+		ofs << std::endl;
+
+		quantized_layers ++;
+	}
+	ofs.close();
+	if (ofs.fail())
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to write \"%s\"", filename.string().c_str());
+	}
+
+	*cfg_and_state.output << "Saved int8 scales for " << quantized_layers << " of " << convolutional_layers << " convolutional layers to " << filename.string() << "." << std::endl;
+
+	// compare the original network with the quantized one
+	const int iterations = 10;
+	const double fp32_time = time_forward_pass(net, first_image.data, iterations);
+	const float fp32_map = validate_detector_map(datacfg, cfgfile, weightfile, thresh, iou_thresh, 0, net.letter_box, &net);
+
+	Darknet::load_int8_scales(net);
+	select_convolution_algorithms(net);
+
+	const double int8_time = time_forward_pass(net, first_image.data, iterations);
+	const float int8_map = validate_detector_map(datacfg, cfgfile, weightfile, thresh, iou_thresh, 0, net.letter_box, &net);
+
+	std::stringstream ss;
+	ss	<< std::fixed << std::setprecision(2)
+		<< "FP32: mAP@" << std::round(iou_thresh * 100.0f) << "=" << Darknet::format_map_accuracy(fp32_map) << ", " << fp32_time << " milliseconds per image" << std::endl
+		<< "int8: mAP@" << std::round(iou_thresh * 100.0f) << "=" << Darknet::format_map_accuracy(int8_map) << ", " << int8_time << " milliseconds per image" << std::endl
+		<< "mAP change: " << std::showpos << (int8_map - fp32_map) * 100.0f << std::noshowpos << "%, "
+		<< "speedup: " << (int8_time > 0.0 ? fp32_time / int8_time : 0.0) << "x" << std::endl;
+
+	*cfg_and_state.output
+		<< std::endl
+		<< ss.str()
+		<< "Use --int8 to run this network with the quantized layers." << std::endl;
+
+	Darknet::free_image(first_image);
+	free_network(net);
+	free(paths);
+	free_list_contents(plist);
+	free_list(plist);
+	free_list_contents_kvp(options);
+	free_list(options);
+
+	return;
+}
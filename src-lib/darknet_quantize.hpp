@@ -0,0 +1,42 @@
+#pragma once
+
+/** @file
+ * Post-training quantization of convolutional layers to 8-bit integers for CPU inference.  The scales are calibrated
+ * with @p "darknet detector quantize" and saved next to the @p .weights file with the extension @p .int8.  The
+ * quantized layers are then used by any command which loads the network on the CPU with @p --int8.
+ *
+ * The @p .int8 file is plain text, with one line per quantized layer:
+ *
+ * ~~~~.txt
+ *     <layer index> <input scale> <number of filters> <weight scale of filter #0> <weight scale of filter #1> ...
+ * ~~~~
+ */
+
+
+#include "darknet_internal.hpp"
+
+
+namespace Darknet
+{
+	/** Calibrate the int8 scales of a network using the @p valid=... images of the given @p .data file, save them to
+	 * the @p .int8 file, and report the mAP% of the network before and after quantization.  The weights of each filter
+	 * get their own scale, while the input of each layer uses a single scale.  This is called from
+	 * @p "darknet detector quantize".
+	 *
+	 * The first layer and the layers which feed a detection layer are not quantized, since those are the ones where the
+	 * loss of precision hurts the most.
+	 *
+	 * @since 2026-10-17
+	 */
+	void quantize_network(const char * datacfg, const char * cfgfile, const char * weightfile, const float thresh, const float iou_thresh);
+
+	/** Load the int8 scales which @ref quantize_network() saved next to the @p .weights file.  This is called by
+	 * @ref select_convolution_algorithms() when @p --int8 is used.  If the file does not exist, a warning is shown and
+	 * the network remains unchanged.
+	 *
+	 * @returns The number of layers for which scales were loaded.
+	 *
+	 * @since 2026-10-17
+	 */
+	int load_int8_scales(Darknet::Network & net);
+}
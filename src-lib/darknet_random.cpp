@@ -0,0 +1,161 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// Multiply two 32-bit values and return the high and low 32 bits of the 64-bit result.
+	static inline uint32_t mulhilo(const uint32_t a, const uint32_t b, uint32_t & hi)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		const uint64_t product = static_cast<uint64_t>(a) * static_cast<uint64_t>(b);
+		hi = static_cast<uint32_t>(product >> 32);
+
+		return static_cast<uint32_t>(product);
+	}
+
+
+	/// Philox4x32-10 as described in "Parallel Random Numbers: As Easy as 1, 2, 3" (Salmon et al., 2011).
+	static inline void philox(const uint32_t key[2], const uint32_t counter[4], uint32_t out[4])
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		uint32_t k0 = key[0];
+		uint32_t k1 = key[1];
+		uint32_t c0 = counter[0];
+		uint32_t c1 = counter[1];
+		uint32_t c2 = counter[2];
+		uint32_t c3 = counter[3];
+
+		for (int round = 0; round < 10; round ++)
+		{
+			uint32_t hi0;
+			uint32_t hi1;
+			const uint32_t lo0 = mulhilo(0xD2511F53, c0, hi0);
+			const uint32_t lo1 = mulhilo(0xCD9E8D57, c2, hi1);
+
+			c0 = hi1 ^ c1 ^ k0;
+			c1 = lo1;
+			c2 = hi0 ^ c3 ^ k1;
+			c3 = lo0;
+
+			k0 += 0x9E3779B9;
+			k1 += 0xBB67AE85;
+		}
+
+		out[0] = c0;
+		out[1] = c1;
+		out[2] = c2;
+		out[3] = c3;
+
+		return;
+	}
+}
+
+
+Darknet::AugmentationRNG::AugmentationRNG(const uint64_t seed, const uint64_t batch, const uint32_t sample)
+{
+	TAT(TATPARMS);
+
+	key[0]		= static_cast<uint32_t>(seed);
+	key[1]		= static_cast<uint32_t>(seed >> 32);
+	counter[0]	= 0; // incremented each time a new block of 4 values is needed
+	counter[1]	= sample;
+	counter[2]	= static_cast<uint32_t>(batch);
+	counter[3]	= static_cast<uint32_t>(batch >> 32);
+	used		= 4;
+
+	return;
+}
+
+
+uint32_t Darknet::AugmentationRNG::next()
+{
+	TAT(TATPARMS);
+
+	if (used >= 4)
+	{
+		philox(key, counter, block);
+		counter[0] ++;
+		used = 0;
+	}
+
+	return block[used ++];
+}
+
+
+int Darknet::AugmentationRNG::integer(int min, int max)
+{
+	TAT(TATPARMS);
+
+	if (max < min)
+	{
+		std::swap(min, max);
+	}
+
+	// multiply-and-shift instead of modulo; the bias is less than 1 in 2^32 / range, which is fine for augmentation
+	const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - static_cast<int64_t>(min)) + 1;
+
+	return static_cast<int>(static_cast<int64_t>(min) + static_cast<int64_t>((next() * range) >> 32));
+}
+
+
+float Darknet::AugmentationRNG::uniform()
+{
+	TAT(TATPARMS);
+
+	// 24 bits is all the precision a float can hold
+	return static_cast<float>(next() >> 8) / 16777215.0f;
+}
+
+
+float Darknet::AugmentationRNG::uniform(float min, float max)
+{
+	TAT(TATPARMS);
+
+	if (max < min)
+	{
+		std::swap(min, max);
+	}
+
+	return uniform() * (max - min) + min;
+}
+
+
+float Darknet::AugmentationRNG::scale(const float s)
+{
+	TAT(TATPARMS);
+
+	const float scale = uniform(1.0f, s);
+	if (next() & 1)
+	{
+		return scale;
+	}
+
+	return 1.0f / scale;
+}
+
+
+uint64_t Darknet::get_augmentation_seed()
+{
+	TAT(TATPARMS);
+
+	static const uint64_t seed = []()
+	{
+		uint64_t value = static_cast<uint64_t>(cfg_and_state.get("seed", 0));
+		if (value == 0)
+		{
+			std::random_device rd;
+			value = (static_cast<uint64_t>(rd()) << 32) | rd();
+		}
+
+		*cfg_and_state.output << "Data augmentation uses seed " << value << " (use --seed to reproduce the same augmentation)." << std::endl;
+
+		return value;
+	}();
+
+	return seed;
+}
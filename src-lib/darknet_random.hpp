@@ -0,0 +1,60 @@
+#pragma once
+
+/** @file
+ * Random numbers used for data augmentation while training.  Each image loading job has a generator of its own, so the
+ * loading threads never share any random number state, and the augmentation of every image in the batch depends only on
+ * the seed, the batch number, and the position of the image within the batch.  This means that a given seed results in
+ * the same augmented batches regardless of the number of loading threads or which thread loads which image.
+ *
+ * The seed can be set on the command-line with @p --seed.
+ */
+
+
+#include "darknet_internal.hpp"
+
+
+namespace Darknet
+{
+	/** Counter-based random number generator (Philox4x32-10) used by @ref load_data_detection().  Unlike
+	 * @p std::mt19937 there is no state to share or advance between threads:  the random numbers are a function of the
+	 * key (the seed) and the counter (batch, sample, and the number of values drawn so far).
+	 *
+	 * @since 2026-10-17
+	 */
+	class AugmentationRNG final
+	{
+		public:
+
+			/// Create the generator for the image at index @p sample within batch number @p batch.
+			AugmentationRNG(const uint64_t seed, const uint64_t batch, const uint32_t sample);
+
+			/// Get the next 32-bit random value.
+			uint32_t next();
+
+			/// Random integer between @p min and @p max.  Both values are inclusive.
+			int integer(int min, int max);
+
+			/// Random float between @p 0.0f and @p 1.0f.
+			float uniform();
+
+			/// Random float between @p min and @p max.
+			float uniform(float min, float max);
+
+			/// Random scale between @p 1/s and @p s.  This is the same as @ref rand_scale().
+			float scale(const float s);
+
+		private:
+
+			uint32_t key[2];
+			uint32_t counter[4];
+			uint32_t block[4];	///< the random values from the last call to Philox
+			size_t used;		///< how many values in @p block have been returned
+	};
+
+	/** Get the seed used for data augmentation.  This is the value of @p --seed, or a random value if @p --seed was not
+	 * specified.  The seed is chosen once and then remains the same for the lifetime of the process.
+	 *
+	 * @since 2026-10-17
+	 */
+	uint64_t get_augmentation_seed();
+}
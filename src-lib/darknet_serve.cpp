@@ -0,0 +1,716 @@
+#include "darknet_internal.hpp"
+#include "darknet_serve.hpp"
+
+#ifndef WIN32
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+	using Clock = std::chrono::high_resolution_clock;
+
+	/// Refuse anything larger than this, since it is more likely to be garbage than an actual image.
+	const uint32_t max_message_size = 64 * 1024 * 1024;
+
+
+	/// A single image waiting to be sent through the neural network.
+	struct ServeRequest
+	{
+		cv::Mat mat;
+		Clock::time_point received;
+		std::promise<std::string> response;
+	};
+	using ServeRequestPtr = std::shared_ptr<ServeRequest>;
+
+
+	/// Requests are added by the connection threads, and removed by the inference thread.
+	struct ServeQueue
+	{
+		std::mutex mutex;
+		std::condition_variable trigger;
+		std::deque<ServeRequestPtr> requests;
+		bool must_stop = false;	///< set when the server shuts down
+	};
+
+
+	/// A client connection and the thread which handles it.  The socket is closed by @ref ServeServer::reap().
+	struct ServeConnection
+	{
+		int fd = -1;
+		std::thread thread;
+		std::atomic<bool> finished{false};
+	};
+
+
+	static std::string socket_path()
+	{
+		TAT(TATPARMS);
+
+		if (cfg_and_state.args.count("socket"))
+		{
+			const std::string str = cfg_and_state.get("socket").str;
+			if (not str.empty() and str != " ")
+			{
+				return str;
+			}
+		}
+
+		return "/tmp/darknet.sock";
+	}
+
+
+	/// @returns the value at the given percentile (0.0 - 1.0).  The vector must already be sorted.
+	static double percentile(const std::vector<double> & sorted_values, const double p)
+	{
+		TAT(TATPARMS);
+
+		if (sorted_values.empty())
+		{
+			return 0.0;
+		}
+
+		const size_t idx = std::min(sorted_values.size() - 1, static_cast<size_t>(p * sorted_values.size()));
+
+		return sorted_values[idx];
+	}
+
+
+	static std::string escape_json(const std::string & str)
+	{
+		TAT(TATPARMS);
+
+		std::string result;
+		result.reserve(str.size());
+		for (const char c : str)
+		{
+			switch (c)
+			{
+				case '"':	result += "\\\"";	break;
+				case '\\':	result += "\\\\";	break;
+				case '\n':	result += "\\n";	break;
+				case '\r':	result += "\\r";	break;
+				case '\t':	result += "\\t";	break;
+				default:
+				{
+					if (static_cast<unsigned char>(c) < 0x20)
+					{
+						// any other control character must be written as a unicode escape sequence
+						char buffer[8];
+						std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+						result += buffer;
+					}
+					else
+					{
+						result += c;
+					}
+					break;
+				}
+			}
+		}
+
+		return result;
+	}
+
+
+	/// Same format as @ref Darknet::detection_to_json(), but using the predictions returned by @ref Darknet::predict().
+	static std::string predictions_to_json(const Darknet::Network * net, const Darknet::Predictions & predictions, const size_t frame_id)
+	{
+		TAT(TATPARMS);
+
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(6) << "{\n \"frame_id\":" << frame_id << ", \n \"objects\": [ \n";
+
+		bool first = true;
+		for (const auto & prediction : predictions)
+		{
+			for (const auto & [class_id, probability] : prediction.prob)
+			{
+				const std::string & name = net->details->class_names.at(class_id);
+				if (name.find("dont_show") == 0)
+				{
+					continue;
+				}
+
+				if (not first)
+				{
+					ss << ", \n";
+				}
+				first = false;
+
+				ss	<< "  {\"class_id\":" << class_id << ", \"name\":\"" << escape_json(name) << "\", \"relative_coordinates\":{"
+					<< "\"center_x\":"	<< prediction.normalized_point.x	<< ", "
+					<< "\"center_y\":"	<< prediction.normalized_point.y	<< ", "
+					<< "\"width\":"		<< prediction.normalized_size.width	<< ", "
+					<< "\"height\":"	<< prediction.normalized_size.height<< "}, "
+					<< "\"confidence\":"<< probability << "}";
+			}
+		}
+
+		ss << "\n ] \n}";
+
+		return ss.str();
+	}
+
+
+	static std::string error_to_json(const std::string & msg)
+	{
+		TAT(TATPARMS);
+
+		return "{\n \"error\":\"" + escape_json(msg) + "\"\n}";
+	}
+
+
+#ifndef WIN32
+	static bool read_all(const int fd, void * buffer, size_t len)
+	{
+		TAT(TATPARMS);
+
+		char * ptr = static_cast<char *>(buffer);
+		while (len > 0)
+		{
+			const ssize_t bytes = recv(fd, ptr, len, 0);
+			if (bytes <= 0)
+			{
+				if (bytes < 0 and errno == EINTR)
+				{
+					continue;
+				}
+				return false;
+			}
+			ptr += bytes;
+			len -= bytes;
+		}
+
+		return true;
+	}
+
+
+	static bool write_all(const int fd, const void * buffer, size_t len)
+	{
+		TAT(TATPARMS);
+
+		#ifdef MSG_NOSIGNAL
+		const int flags = MSG_NOSIGNAL; // don't raise SIGPIPE if the other side has gone away
+		#else
+		const int flags = 0;
+		#endif
+
+		const char * ptr = static_cast<const char *>(buffer);
+		while (len > 0)
+		{
+			const ssize_t bytes = send(fd, ptr, len, flags);
+			if (bytes <= 0)
+			{
+				if (bytes < 0 and errno == EINTR)
+				{
+					continue;
+				}
+				return false;
+			}
+			ptr += bytes;
+			len -= bytes;
+		}
+
+		return true;
+	}
+
+
+	/// Read a single length-prefixed message.  @returns @p false if the connection was closed.
+	static bool read_message(const int fd, std::string & msg)
+	{
+		TAT(TATPARMS);
+
+		uint32_t len = 0;
+		if (not read_all(fd, &len, sizeof(len)))
+		{
+			return false;
+		}
+
+		len = ntohl(len);
+		if (len > max_message_size)
+		{
+			return false;
+		}
+
+		msg.resize(len);
+
+		return read_all(fd, msg.data(), len);
+	}
+
+
+	static bool write_message(const int fd, const std::string & msg)
+	{
+		TAT(TATPARMS);
+
+		const uint32_t len = htonl(static_cast<uint32_t>(msg.size()));
+
+		return write_all(fd, &len, sizeof(len)) and write_all(fd, msg.data(), msg.size());
+	}
+
+
+	static int connect_to_server(const std::string & path)
+	{
+		TAT(TATPARMS);
+
+		const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+		{
+			throw std::runtime_error("failed to create a socket: " + std::string(strerror(errno)));
+		}
+
+		sockaddr_un addr;
+		std::memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+		if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+		{
+			const std::string err = strerror(errno);
+			close(fd);
+			throw std::runtime_error("failed to connect to \"" + path + "\": " + err);
+		}
+
+		return fd;
+	}
+
+
+	/// Each client connection is handled on a different thread.  Requests are decoded here and then queued.
+	static void connection_thread(const int fd, ServeQueue & queue, std::atomic<bool> & finished)
+	{
+		TAT(TATPARMS);
+
+		cfg_and_state.set_thread_name("serve connection");
+
+		std::string msg;
+		while (read_message(fd, msg))
+		{
+			auto request = std::make_shared<ServeRequest>();
+			request->received = Clock::now();
+
+			std::future<std::string> future = request->response.get_future();
+
+			const std::vector<uint8_t> bytes(msg.begin(), msg.end());
+			request->mat = cv::imdecode(bytes, cv::IMREAD_COLOR);
+			if (request->mat.empty())
+			{
+				request->response.set_value(error_to_json("failed to decode the image"));
+			}
+			else
+			{
+				std::lock_guard lock(queue.mutex);
+				if (queue.must_stop)
+				{
+					request->response.set_value(error_to_json("the server is shutting down"));
+				}
+				else
+				{
+					queue.requests.push_back(request);
+					queue.trigger.notify_one();
+				}
+			}
+
+			std::string response;
+			try
+			{
+				response = future.get();
+			}
+			catch (const std::exception & e)
+			{
+				response = error_to_json(e.what());
+			}
+
+			if (not write_message(fd, response))
+			{
+				break;
+			}
+		}
+
+		cfg_and_state.del_thread_name();
+		finished = true;
+
+		return;
+	}
+
+
+	/** The only thread which uses the neural network.  Requests are taken from the queue as soon as either @p max_batch
+	 * requests are waiting, or the oldest request has been waiting for @p max_wait.
+	 */
+	static void inference_thread(Darknet::NetworkPtr ptr, ServeQueue & queue, const size_t max_batch, const std::chrono::milliseconds max_wait)
+	{
+		TAT(TATPARMS);
+
+		cfg_and_state.set_thread_name("serve inference");
+
+		#ifdef DARKNET_GPU
+		if (cfg_and_state.gpu_index >= 0)
+		{
+			cuda_set_device(cfg_and_state.gpu_index);
+		}
+		#endif
+
+		Darknet::Network * net = reinterpret_cast<Darknet::Network *>(ptr);
+
+		size_t frame_id			= 0;
+		size_t batches			= 0;
+		std::vector<double> latencies;
+		auto report_timestamp	= Clock::now();
+
+		while (true)
+		{
+			std::vector<ServeRequestPtr> batch;
+
+			if (true)
+			{
+				std::unique_lock lock(queue.mutex);
+				queue.trigger.wait(lock, [&]() { return queue.must_stop or queue.requests.empty() == false; });
+
+				if (queue.must_stop)
+				{
+					// nothing else will be processed, so answer whatever is still waiting
+					for (auto & request : queue.requests)
+					{
+						request->response.set_value(error_to_json("the server is shutting down"));
+					}
+					queue.requests.clear();
+					break;
+				}
+
+				// give other requests a chance to arrive so they can be processed in the same batch
+				const auto deadline = queue.requests.front()->received + max_wait;
+				queue.trigger.wait_until(lock, deadline, [&]() { return queue.must_stop or queue.requests.size() >= max_batch; });
+
+				while (batch.size() < max_batch and queue.requests.empty() == false)
+				{
+					batch.push_back(queue.requests.front());
+					queue.requests.pop_front();
+				}
+			}
+
+			std::vector<cv::Mat> mats;
+			mats.reserve(batch.size());
+			for (const auto & request : batch)
+			{
+				mats.push_back(request->mat);
+			}
+
+			// a promise can only be satisfied once, so remember how many requests have already been answered
+			size_t answered = 0;
+			try
+			{
+				const auto results = Darknet::predict(ptr, mats);
+				while (answered < batch.size())
+				{
+					const std::string json = predictions_to_json(net, results[answered], frame_id ++);
+					batch[answered]->response.set_value(json);
+					answered ++;
+				}
+			}
+			catch (...)
+			{
+				for (size_t idx = answered; idx < batch.size(); idx ++)
+				{
+					batch[idx]->response.set_exception(std::current_exception());
+				}
+			}
+
+			const auto now = Clock::now();
+			for (const auto & request : batch)
+			{
+				latencies.push_back(std::chrono::duration<double, std::milli>(now - request->received).count());
+			}
+			batches ++;
+
+			const double seconds = std::chrono::duration<double>(now - report_timestamp).count();
+			if (seconds >= 5.0)
+			{
+				std::sort(latencies.begin(), latencies.end());
+
+				*cfg_and_state.output
+					<< std::fixed << std::setprecision(1)
+					<< "served " << latencies.size() << " requests in " << batches << " batches"
+					<< " (average batch size " << (static_cast<double>(latencies.size()) / batches) << ")"
+					<< ", throughput " << (latencies.size() / seconds) << " requests/second"
+					<< ", latency p50 " << percentile(latencies, 0.50) << " ms"
+					<< ", p99 " << percentile(latencies, 0.99) << " ms" << std::endl;
+
+				latencies.clear();
+				batches = 0;
+				report_timestamp = now;
+			}
+		}
+
+		cfg_and_state.del_thread_name();
+
+		return;
+	}
+
+
+	/** Everything owned by @p "darknet serve".  The destructor stops and joins every thread before the socket, the
+	 * socket file, and the neural network are released, so nothing is left running or leaked regardless of how
+	 * @ref Darknet::serve() exits.
+	 */
+	struct ServeServer
+	{
+		Darknet::NetworkPtr ptr = nullptr;
+		std::string path;
+		int fd = -1;
+		ServeQueue queue;
+		std::thread inference;
+		std::list<ServeConnection> connections;
+
+		~ServeServer()
+		{
+			TAT(TATPARMS);
+
+			if (true)
+			{
+				std::lock_guard lock(queue.mutex);
+				queue.must_stop = true;
+			}
+			queue.trigger.notify_all();
+
+			if (inference.joinable())
+			{
+				inference.join();
+			}
+
+			// wake up the connection threads blocked in recv() so they can be joined
+			for (auto & connection : connections)
+			{
+				shutdown(connection.fd, SHUT_RDWR);
+			}
+			reap(true);
+
+			if (fd >= 0)
+			{
+				close(fd);
+				unlink(path.c_str());
+			}
+
+			if (ptr)
+			{
+				Darknet::free_neural_network(ptr);
+			}
+		}
+
+		/// Join the connection threads which have finished (or all of them when @p all is set) and close their sockets.
+		void reap(const bool all)
+		{
+			TAT(TATPARMS);
+
+			for (auto iter = connections.begin(); iter != connections.end(); )
+			{
+				if (all or iter->finished)
+				{
+					iter->thread.join();
+					close(iter->fd);
+					iter = connections.erase(iter);
+				}
+				else
+				{
+					++ iter;
+				}
+			}
+
+			return;
+		}
+	};
+#endif
+}
+
+
+void Darknet::serve(const std::filesystem::path & cfg_filename, const std::filesystem::path & names_filename, const std::filesystem::path & weights_filename)
+{
+	TAT(TATPARMS);
+
+	#ifdef WIN32
+	throw std::runtime_error("\"darknet serve\" requires Unix domain sockets and is not supported on Windows");
+	#else
+
+	const std::string path	= socket_path();
+	const int max_batch		= std::max(1, cfg_and_state.get("maxbatch", 8));
+	const int max_wait		= std::max(0, cfg_and_state.get("maxwait", 5));
+
+	// check the path before anything is created so nothing needs to be released if it is rejected
+	sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path))
+	{
+		throw std::invalid_argument("socket path is too long: \"" + path + "\"");
+	}
+	std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+	ServeServer server;
+	server.path	= path;
+	server.ptr	= Darknet::load_neural_network(cfg_filename, names_filename, weights_filename);
+	if (cfg_and_state.args.count("thresh"))
+	{
+		Darknet::set_detection_threshold(server.ptr, cfg_and_state.get("thresh", 0.24f));
+	}
+
+	/* Allocate the layer outputs and the workspace once for the largest batch.  Darknet::predict() can then switch
+	 * between smaller batch sizes without re-allocating anything.
+	 */
+	Darknet::Network * net = reinterpret_cast<Darknet::Network *>(server.ptr);
+	if (max_batch > net->details->allocated_batch)
+	{
+		set_batch_network(net, max_batch);
+		resize_network(net, net->w, net->h);
+	}
+
+	server.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server.fd < 0)
+	{
+		throw std::runtime_error("failed to create a socket: " + std::string(strerror(errno)));
+	}
+
+	// remove a socket left behind by a previous run
+	unlink(path.c_str());
+
+	if (bind(server.fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 or listen(server.fd, 64) != 0)
+	{
+		throw std::runtime_error("failed to listen on \"" + path + "\": " + strerror(errno));
+	}
+
+	*cfg_and_state.output
+		<< "Listening on " << Darknet::in_colour(Darknet::EColour::kBrightWhite, path)
+		<< " with max batch size " << max_batch << " and max wait time " << max_wait << " milliseconds." << std::endl;
+
+	server.inference = std::thread(inference_thread, server.ptr, std::ref(server.queue), static_cast<size_t>(max_batch), std::chrono::milliseconds(max_wait));
+
+	while (cfg_and_state.must_immediately_exit == false)
+	{
+		const int client = accept(server.fd, nullptr, nullptr);
+		if (client < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			throw std::runtime_error("failed to accept a connection: " + std::string(strerror(errno)));
+		}
+
+		server.reap(false);
+
+		ServeConnection & connection = server.connections.emplace_back();
+		connection.fd		= client;
+		connection.thread	= std::thread(connection_thread, client, std::ref(server.queue), std::ref(connection.finished));
+	}
+	#endif
+}
+
+
+void Darknet::serve_client(const VStr & image_filenames)
+{
+	TAT(TATPARMS);
+
+	#ifdef WIN32
+	throw std::runtime_error("\"darknet serve_client\" requires Unix domain sockets and is not supported on Windows");
+	#else
+
+	VStr images;
+	for (const auto & filename : image_filenames)
+	{
+		std::ifstream ifs(filename, std::ios::binary);
+		if (not ifs.is_open())
+		{
+			throw std::invalid_argument("failed to open image \"" + filename + "\"");
+		}
+		images.push_back(std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()));
+		if (images.back().empty())
+		{
+			throw std::invalid_argument("image \"" + filename + "\" is empty");
+		}
+	}
+	if (images.empty())
+	{
+		throw std::invalid_argument("at least 1 image is needed to send to the server");
+	}
+
+	const std::string path	= socket_path();
+	const int requests		= std::max(1, cfg_and_state.get("requests", 100));
+	const int connections	= std::max(1, cfg_and_state.get("connections", 4));
+
+	*cfg_and_state.output
+		<< "Sending " << requests << " requests over " << connections << " connections to "
+		<< Darknet::in_colour(Darknet::EColour::kBrightWhite, path) << "." << std::endl;
+
+	std::atomic<int> next_request(0);
+	std::mutex mutex;
+	std::vector<double> latencies;
+	std::string first_response;
+	std::exception_ptr error;
+
+	const auto start = Clock::now();
+
+	Darknet::VThreads threads;
+	for (int idx = 0; idx < connections; idx ++)
+	{
+		threads.emplace_back([&]()
+		{
+			try
+			{
+				const int fd = connect_to_server(path);
+
+				std::string response;
+				for (int request = next_request ++; request < requests; request = next_request ++)
+				{
+					const auto t1 = Clock::now();
+					if (not write_message(fd, images[request % images.size()]) or not read_message(fd, response))
+					{
+						close(fd);
+						throw std::runtime_error("connection to the server was lost");
+					}
+					const auto t2 = Clock::now();
+
+					std::lock_guard lock(mutex);
+					latencies.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+					if (first_response.empty())
+					{
+						first_response = response;
+					}
+				}
+
+				close(fd);
+			}
+			catch (...)
+			{
+				std::lock_guard lock(mutex);
+				error = std::current_exception();
+			}
+		});
+	}
+
+	for (auto & t : threads)
+	{
+		t.join();
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	std::sort(latencies.begin(), latencies.end());
+
+	if (cfg_and_state.is_verbose)
+	{
+		*cfg_and_state.output << first_response << std::endl;
+	}
+
+	*cfg_and_state.output
+		<< std::fixed << std::setprecision(2)
+		<< "requests:    " << latencies.size()									<< std::endl
+		<< "throughput:  " << (latencies.size() / seconds) << " requests/second"	<< std::endl
+		<< "latency p50: " << percentile(latencies, 0.50) << " ms"				<< std::endl
+		<< "latency p99: " << percentile(latencies, 0.99) << " ms"				<< std::endl;
+	#endif
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+/** @file
+ * Long-running inference server.  The neural network is loaded once, and requests are received on a local Unix domain
+ * socket.  Concurrent requests are batched together before being sent through the neural network.
+ *
+ * Each request and response on the socket is a 32-bit length in network byte order, followed by that many bytes.  The
+ * request contains an encoded image (such as @p JPG or @p PNG, anything supported by @p cv::imdecode()), and the
+ * response is the JSON text describing the objects found.  A single connection may send many requests, one after the
+ * other.
+ */
+
+
+#include "darknet_internal.hpp"
+
+
+namespace Darknet
+{
+	/** Run the inference server until the process is terminated.  This is called from @p "darknet serve".
+	 *
+	 * @li @p -socket is the path of the Unix domain socket (default is @p /tmp/darknet.sock)
+	 * @li @p -max_batch is the maximum number of images sent through the network at once (default is @p 8)
+	 * @li @p -max_wait is how many milliseconds to wait for more requests before running a partial batch (default is @p 5)
+	 *
+	 * Throughput and latency statistics are logged every few seconds while requests are being processed.
+	 *
+	 * @since 2026-10-17
+	 */
+	void serve(const std::filesystem::path & cfg_filename, const std::filesystem::path & names_filename, const std::filesystem::path & weights_filename);
+
+	/** Simple client for @ref Darknet::serve() which sends the given images over and over and reports the throughput
+	 * as well as the p50 and p99 latency.  This is called from @p "darknet serve_client".
+	 *
+	 * @li @p -socket is the path of the Unix domain socket (default is @p /tmp/darknet.sock)
+	 * @li @p -requests is the total number of requests to send (default is @p 100)
+	 * @li @p -connections is the number of concurrent connections (default is @p 4)
+	 *
+	 * @since 2026-10-17
+	 */
+	void serve_client(const VStr & image_filenames);
+}
@@ -0,0 +1,361 @@
+#include "darknet_internal.hpp"
+
+#ifndef WIN32
+#include <sched.h>
+#endif
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// One logical CPU (a hardware thread) as described by @p /sys/devices/system/.
+	struct LogicalCpu
+	{
+		int cpu;
+		int node;
+		int package;
+		int core;
+	};
+
+
+	/// The CPUs chosen by @ref Darknet::configure_thread_placement().  These don't change once they have been set.
+	struct Placement
+	{
+		bool enabled = false;
+		Darknet::VInt compute;	///< CPUs used by OpenMP
+		Darknet::VInt loading;	///< CPUs used by the image loading threads
+	};
+	static Placement placement;
+
+
+	/// Format a list of CPUs the same way as the Linux @p cpulist files, such as @p "0-7,16-23".
+	static std::string format_cpu_list(Darknet::VInt cpus)
+	{
+		TAT(TATPARMS);
+
+		std::sort(cpus.begin(), cpus.end());
+
+		std::string str;
+		for (size_t idx = 0; idx < cpus.size(); idx ++)
+		{
+			size_t last = idx;
+			while (last + 1 < cpus.size() and cpus[last + 1] == cpus[last] + 1)
+			{
+				last ++;
+			}
+
+			if (not str.empty())
+			{
+				str += ",";
+			}
+			str += std::to_string(cpus[idx]);
+			if (last > idx)
+			{
+				str += "-" + std::to_string(cpus[last]);
+			}
+			idx = last;
+		}
+
+		return str;
+	}
+
+
+#ifndef WIN32
+	/// Parse a Linux @p cpulist file such as @p /sys/devices/system/node/node0/cpulist.
+	static Darknet::VInt read_cpu_list(const std::filesystem::path & filename)
+	{
+		TAT(TATPARMS);
+
+		Darknet::VInt cpus;
+
+		std::ifstream ifs(filename);
+		std::string line;
+		std::getline(ifs, line);
+
+		std::stringstream ss(line);
+		std::string range;
+		while (std::getline(ss, range, ','))
+		{
+			if (range.empty())
+			{
+				continue;
+			}
+
+			const size_t pos = range.find('-');
+			const int first	= std::stoi(range.substr(0, pos));
+			const int last	= (pos == std::string::npos) ? first : std::stoi(range.substr(pos + 1));
+			for (int cpu = first; cpu <= last; cpu ++)
+			{
+				cpus.push_back(cpu);
+			}
+		}
+
+		return cpus;
+	}
+
+
+	/// Read a single integer from a file in @p /sys/, or return @p default_value if the file cannot be read.
+	static int read_int(const std::filesystem::path & filename, const int default_value)
+	{
+		TAT(TATPARMS);
+
+		int value = default_value;
+
+		std::ifstream ifs(filename);
+		if (not (ifs >> value))
+		{
+			value = default_value;
+		}
+
+		return value;
+	}
+
+
+	/// Get the CPUs which this process is allowed to use, with the NUMA node, socket, and core of each one.
+	static std::vector<LogicalCpu> get_topology()
+	{
+		TAT(TATPARMS);
+
+		cpu_set_t allowed;
+		CPU_ZERO(&allowed);
+		if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		{
+			return {};
+		}
+
+		std::map<int, int> node_of_cpu;
+		const std::filesystem::path nodes = "/sys/devices/system/node";
+		std::error_code ec;
+		for (const auto & entry : std::filesystem::directory_iterator(nodes, ec))
+		{
+			const std::string name = entry.path().filename().string();
+			if (name.size() > 4 and name.compare(0, 4, "node") == 0 and std::isdigit(name[4]))
+			{
+				const int node = std::stoi(name.substr(4));
+				for (const int cpu : read_cpu_list(entry.path() / "cpulist"))
+				{
+					node_of_cpu[cpu] = node;
+				}
+			}
+		}
+
+		std::vector<LogicalCpu> cpus;
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu ++)
+		{
+			if (CPU_ISSET(cpu, &allowed))
+			{
+				const std::filesystem::path topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology";
+
+				LogicalCpu logical;
+				logical.cpu		= cpu;
+				logical.node	= node_of_cpu.count(cpu) ? node_of_cpu[cpu] : 0;
+				logical.package	= read_int(topology / "physical_package_id", 0);
+				logical.core	= read_int(topology / "core_id", cpu);
+				cpus.push_back(logical);
+			}
+		}
+
+		return cpus;
+	}
+
+
+	static void pin_current_thread(const Darknet::VInt & cpus)
+	{
+		TAT(TATPARMS);
+
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (const int cpu : cpus)
+		{
+			CPU_SET(cpu, &set);
+		}
+
+		if (sched_setaffinity(0, sizeof(set), &set) != 0 and cfg_and_state.is_verbose)
+		{
+			*cfg_and_state.output << "Failed to set the CPU affinity of " << cfg_and_state.get_thread_name() << " to " << format_cpu_list(cpus) << "." << std::endl;
+		}
+
+		return;
+	}
+#endif
+}
+
+
+void Darknet::configure_thread_placement()
+{
+	TAT(TATPARMS);
+
+	const std::string mode = cfg_and_state.thread_affinity;
+	if (mode != "none" and mode != "split" and mode != "node")
+	{
+		darknet_fatal_error(DARKNET_LOC, "unknown thread affinity \"%s\" (expected \"none\", \"split\", or \"node\")", mode.c_str());
+	}
+
+#ifdef WIN32
+	if (mode != "none")
+	{
+		Darknet::display_warning_msg("Thread placement with --affinity is not supported on Windows.\n");
+	}
+#else
+	if (mode == "none" and not cfg_and_state.is_verbose)
+	{
+		return;
+	}
+
+	const std::vector<LogicalCpu> cpus = get_topology();
+	if (cpus.empty())
+	{
+		Darknet::display_warning_msg("Failed to read the CPU topology.  Threads will not be placed on specific cores.\n");
+		return;
+	}
+
+	std::map<int, Darknet::VInt> cpus_on_node;
+	std::set<int> packages;
+	std::set<std::pair<int, int>> cores;
+	for (const auto & logical : cpus)
+	{
+		cpus_on_node[logical.node].push_back(logical.cpu);
+		packages.insert(logical.package);
+		cores.insert({logical.package, logical.core});
+	}
+
+	*cfg_and_state.output
+		<< "CPU topology: "
+		<< packages.size()		<< " socket"		<< (packages.size()		== 1 ? "" : "s") << ", "
+		<< cpus_on_node.size()	<< " NUMA node"		<< (cpus_on_node.size()	== 1 ? "" : "s") << ", "
+		<< cores.size()			<< " physical core"	<< (cores.size()		== 1 ? "" : "s") << ", "
+		<< cpus.size()			<< " logical CPU"	<< (cpus.size()			== 1 ? "" : "s") << "." << std::endl;
+	for (const auto & [node, list] : cpus_on_node)
+	{
+		*cfg_and_state.output << "-> node #" << node << ": CPUs " << format_cpu_list(list) << std::endl;
+	}
+
+	if (mode == "none")
+	{
+		return;
+	}
+
+	// the consuming node is where the batches are used, which unless told otherwise is where Darknet was started
+	int node = cfg_and_state.numa_node;
+	if (node < 0)
+	{
+		const int current = sched_getcpu();
+		node = cpus.front().node;
+		for (const auto & logical : cpus)
+		{
+			if (logical.cpu == current)
+			{
+				node = logical.node;
+			}
+		}
+	}
+	if (cpus_on_node.count(node) == 0)
+	{
+		darknet_fatal_error(DARKNET_LOC, "NUMA node #%d does not exist or cannot be used by this process", node);
+	}
+
+	const Darknet::VInt & local = cpus_on_node[node];
+
+	int number_of_loading_cpus = cfg_and_state.loader_cores;
+	if (number_of_loading_cpus <= 0)
+	{
+		number_of_loading_cpus = std::clamp(static_cast<int>(local.size()) / 4, 1, 8);
+	}
+
+	if (number_of_loading_cpus >= static_cast<int>(local.size()))
+	{
+		Darknet::display_warning_msg("NUMA node #" + std::to_string(node) + " does not have enough CPUs to reserve " + std::to_string(number_of_loading_cpus) + " of them for image loading.  Threads will not be placed on specific cores.\n");
+		return;
+	}
+
+	/* Image loading uses the last cores of the consuming node.  Both hardware threads of a physical core are taken
+	 * together so the compute threads never share a core with the image loading threads.
+	 */
+	std::set<std::pair<int, int>> loading_cores;
+	for (auto iter = local.rbegin(); iter != local.rend() and static_cast<int>(placement.loading.size()) < number_of_loading_cpus; ++iter)
+	{
+		const LogicalCpu & logical = *std::find_if(cpus.begin(), cpus.end(), [&](const LogicalCpu & c) { return c.cpu == *iter; });
+		if (loading_cores.insert({logical.package, logical.core}).second)
+		{
+			for (const auto & sibling : cpus)
+			{
+				if (sibling.node == node and sibling.package == logical.package and sibling.core == logical.core)
+				{
+					placement.loading.push_back(sibling.cpu);
+				}
+			}
+		}
+	}
+
+	// compute threads use everything else, starting with the consuming node
+	for (const bool on_consuming_node : {true, false})
+	{
+		if (not on_consuming_node and mode == "node")
+		{
+			break;
+		}
+
+		for (const auto & logical : cpus)
+		{
+			if ((logical.node == node) == on_consuming_node and loading_cores.count({logical.package, logical.core}) == 0)
+			{
+				placement.compute.push_back(logical.cpu);
+			}
+		}
+	}
+
+	if (placement.compute.empty())
+	{
+		Darknet::display_warning_msg("No CPUs are left for the compute threads.  Threads will not be placed on specific cores.\n");
+		placement.loading.clear();
+		return;
+	}
+
+	placement.enabled = true;
+
+#ifdef DARKNET_OPENMP
+	// OpenMP re-uses the same threads, so each one only needs to be pinned once
+	const int number_of_threads = static_cast<int>(placement.compute.size());
+	omp_set_num_threads(number_of_threads);
+	#pragma omp parallel num_threads(number_of_threads)
+	{
+		const int idx = omp_get_thread_num();
+		if (idx == 0)
+		{
+			// this is the main thread, which also runs everything outside of OpenMP
+			pin_current_thread(placement.compute);
+		}
+		else
+		{
+			pin_current_thread({placement.compute[idx % placement.compute.size()]});
+		}
+	}
+#else
+	pin_current_thread(placement.compute);
+#endif
+
+	*cfg_and_state.output
+		<< "Thread placement \"" << mode << "\" using NUMA node #" << node << ":" << std::endl
+		<< "-> compute threads:       " << placement.compute.size() << " CPUs (" << format_cpu_list(placement.compute) << ")" << std::endl
+		<< "-> image loading threads: " << placement.loading.size() << " CPUs (" << format_cpu_list(placement.loading) << ")" << std::endl;
+#endif
+
+	return;
+}
+
+
+void Darknet::place_image_loading_thread()
+{
+	TAT(TATPARMS);
+
+#ifndef WIN32
+	if (placement.enabled)
+	{
+		pin_current_thread(placement.loading);
+	}
+#endif
+
+	return;
+}
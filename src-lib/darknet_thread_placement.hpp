@@ -0,0 +1,41 @@
+#pragma once
+
+/** @file
+ * Placement of the compute threads (OpenMP) and the image loading threads on specific CPU cores.  Without this, the
+ * image loading threads and the OpenMP threads compete for the same cores, and on machines with several NUMA nodes the
+ * memory used by a thread is often on a different node than the one where the thread runs.
+ *
+ * Placement is selected on the command-line with @p --affinity:
+ *
+ * @li @p none is the default, where the operating system decides where each thread runs.
+ * @li @p split reserves some cores on the "consuming" NUMA node for image loading, and pins the OpenMP threads to all
+ * of the remaining cores.
+ * @li @p node is the same as @p split, but the OpenMP threads only use the remaining cores of the consuming node.
+ *
+ * The consuming node is the NUMA node where %Darknet was started, or the one given with @p --numa-node.  The number of
+ * cores reserved for image loading can be set with @p --loader-cores.  This is only supported on Linux.
+ */
+
+
+#include "darknet_internal.hpp"
+
+
+namespace Darknet
+{
+	/** Read the CPU topology, decide which cores are used by the compute and image loading threads, pin the OpenMP
+	 * threads, and report the topology.  This is called once from @p main() after the command-line has been processed.
+	 *
+	 * @since 2026-10-17
+	 */
+	void configure_thread_placement();
+
+	/** Pin the calling thread to the cores reserved for image loading.  This is called at the start of the image
+	 * loading threads and the batch prefetch thread.  Does nothing if thread placement is disabled.
+	 *
+	 * Since the batch buffers are allocated by the prefetch thread and first written by the image loading threads,
+	 * the memory pages are placed on the same NUMA node as the compute threads which consume the batches.
+	 *
+	 * @since 2026-10-17
+	 */
+	void place_image_loading_thread();
+}
@@ -0,0 +1,398 @@
+#include "darknet_internal.hpp"
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	static const char pack_magic[8] = {'D', 'N', 'P', 'A', 'C', 'K', '0', '1'};
+
+
+	struct PackHeader
+	{
+		char		magic[8];
+		uint64_t	number_of_images;
+		uint64_t	index_offset;	///< where the array of @ref PackIndex starts
+		uint64_t	strings_offset;	///< where the image filenames start
+	};
+
+
+	struct PackIndex
+	{
+		uint64_t	image_offset;	///< original encoded bytes of the image (JPG, PNG, ...)
+		uint64_t	image_size;
+		uint64_t	boxes_offset;	///< array of @ref PackBox
+		uint32_t	number_of_boxes;
+		uint32_t	path_offset;	///< relative to @ref PackHeader::strings_offset
+	};
+
+
+	/// What @ref read_boxes() parses from the annotation file.
+	struct PackBox
+	{
+		int32_t	id;
+		int32_t	track_id;
+		float	x;
+		float	y;
+		float	w;
+		float	h;
+	};
+
+
+	struct TrainingPack
+	{
+		std::filesystem::path filename;
+		const uint8_t * data;
+		size_t size;
+		const PackIndex * index;
+		std::map<std::string, size_t> lookup; ///< image filename to index
+		#ifdef WIN32
+		HANDLE file;
+		HANDLE mapping;
+		#endif
+	};
+	static TrainingPack pack;
+
+
+	/// Pad the output so the next item is 8-byte aligned.
+	static void align(std::ofstream & ofs)
+	{
+		TAT(TATPARMS);
+
+		const char zeros[8] = {0};
+		const size_t remainder = static_cast<size_t>(ofs.tellp()) % 8;
+		if (remainder)
+		{
+			ofs.write(zeros, 8 - remainder);
+		}
+
+		return;
+	}
+
+
+	static const PackIndex * find_in_pack(const std::string & filename)
+	{
+		TAT(TATPARMS);
+
+		if (pack.data == nullptr)
+		{
+			return nullptr;
+		}
+
+		const auto iter = pack.lookup.find(filename);
+		if (iter == pack.lookup.end())
+		{
+			return nullptr;
+		}
+
+		return pack.index + iter->second;
+	}
+}
+
+
+void Darknet::pack_training_images(const char * datacfg)
+{
+	TAT(TATPARMS);
+
+	list *options = read_data_cfg(datacfg);
+	const char *train_images = option_find_str(options, "train", "data/train.txt");
+
+	std::filesystem::path output_filename = option_find_str_quiet(options, "train_pack", "");
+	if (output_filename.empty())
+	{
+		output_filename = train_images;
+		output_filename.replace_extension(".pack");
+	}
+
+	list *plist = get_paths(train_images);
+	char **paths = (char **)list_to_array(plist);
+	const size_t number_of_images = plist->size;
+
+	*cfg_and_state.output << "Packing " << number_of_images << " training images and annotations from " << train_images << " into " << output_filename.string() << "." << std::endl;
+
+	std::ofstream ofs(output_filename, std::ios::binary | std::ios::trunc);
+	if (not ofs.good())
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to create \"%s\"", output_filename.string().c_str());
+	}
+
+	PackHeader header = {};
+	memcpy(header.magic, pack_magic, sizeof(pack_magic));
+	header.number_of_images = number_of_images;
+	ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	std::vector<PackIndex> index(number_of_images);
+	std::string strings;
+	std::vector<char> bytes;
+	size_t total_boxes = 0;
+
+	for (size_t idx = 0; idx < number_of_images; idx ++)
+	{
+		const char * filename = paths[idx];
+
+		std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+		if (not ifs.good())
+		{
+			darknet_fatal_error(DARKNET_LOC, "failed to open image file \"%s\"", filename);
+		}
+		bytes.resize(ifs.tellg());
+		ifs.seekg(0);
+		ifs.read(bytes.data(), bytes.size());
+
+		char labelpath[4096];
+		replace_image_to_label(filename, labelpath);
+		int count = 0;
+		box_label *boxes = read_boxes(labelpath, &count);
+
+		PackIndex & entry = index[idx];
+
+		align(ofs);
+		entry.image_offset	= ofs.tellp();
+		entry.image_size	= bytes.size();
+		ofs.write(bytes.data(), bytes.size());
+
+		align(ofs);
+		entry.boxes_offset		= ofs.tellp();
+		entry.number_of_boxes	= count;
+		for (int i = 0; i < count; ++i)
+		{
+			const PackBox b = {boxes[i].id, boxes[i].track_id, boxes[i].x, boxes[i].y, boxes[i].w, boxes[i].h};
+			ofs.write(reinterpret_cast<const char*>(&b), sizeof(b));
+		}
+		free(boxes);
+		total_boxes += count;
+
+		entry.path_offset = strings.size();
+		strings += filename;
+		strings += '\0';
+
+		if (idx % 1000 == 999)
+		{
+			*cfg_and_state.output << "\r" << (idx + 1) << "/" << number_of_images << std::flush;
+		}
+	}
+
+	align(ofs);
+	header.index_offset = ofs.tellp();
+	ofs.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(PackIndex));
+
+	header.strings_offset = ofs.tellp();
+	ofs.write(strings.data(), strings.size());
+
+	const size_t file_size = ofs.tellp();
+	ofs.seekp(0);
+	ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	ofs.close();
+
+	if (ofs.fail())
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to write \"%s\"", output_filename.string().c_str());
+	}
+
+	*cfg_and_state.output
+		<< "\r" << "Packed " << number_of_images << " images and " << total_boxes << " annotations into " << output_filename.string()
+		<< " (" << size_to_IEC_string(file_size) << ")." << std::endl
+		<< "To train from this file, add \"train_pack=" << output_filename.string() << "\" to " << datacfg << "." << std::endl;
+
+	free(paths);
+	free_list_contents(plist);
+	free_list(plist);
+	free_list_contents_kvp(options);
+	free_list(options);
+
+	return;
+}
+
+
+size_t Darknet::open_training_pack(const std::filesystem::path & filename)
+{
+	TAT(TATPARMS);
+
+	close_training_pack();
+
+	const std::string fn = filename.string();
+
+	#ifdef WIN32
+	pack.file = CreateFileA(fn.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (pack.file == INVALID_HANDLE_VALUE)
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to open packed training file \"%s\"", fn.c_str());
+	}
+	LARGE_INTEGER file_size;
+	GetFileSizeEx(pack.file, &file_size);
+	pack.size = file_size.QuadPart;
+	pack.mapping = CreateFileMappingA(pack.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void * ptr = pack.mapping ? MapViewOfFile(pack.mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	#else
+	const int fd = open(fn.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to open packed training file \"%s\"", fn.c_str());
+	}
+	struct stat st;
+	fstat(fd, &st);
+	pack.size = st.st_size;
+	void * ptr = mmap(nullptr, pack.size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); // the mapping remains valid after the file descriptor is closed
+	if (ptr == MAP_FAILED)
+	{
+		ptr = nullptr;
+	}
+	#endif
+
+	if (ptr == nullptr)
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to memory-map packed training file \"%s\"", fn.c_str());
+	}
+
+	pack.filename	= filename;
+	pack.data		= static_cast<const uint8_t*>(ptr);
+
+	// the sizes are compared as "count <= (size - offset) / sizeof" so a corrupt file cannot cause an overflow
+	const PackHeader * header = reinterpret_cast<const PackHeader*>(pack.data);
+	if (pack.size < sizeof(PackHeader)													or
+		memcmp(header->magic, pack_magic, sizeof(pack_magic)) != 0						or
+		header->index_offset > pack.size												or
+		header->number_of_images > (pack.size - header->index_offset) / sizeof(PackIndex)	or
+		header->strings_offset > pack.size)
+	{
+		darknet_fatal_error(DARKNET_LOC, "\"%s\" is not a valid packed training file (use \"darknet detector pack\" to create it)", fn.c_str());
+	}
+
+	pack.index = reinterpret_cast<const PackIndex*>(pack.data + header->index_offset);
+	const char * strings = reinterpret_cast<const char*>(pack.data + header->strings_offset);
+	const size_t strings_size = pack.size - header->strings_offset;
+
+	// validate every entry now, so the images and boxes can later be read without any further checks
+	for (size_t idx = 0; idx < header->number_of_images; idx ++)
+	{
+		const PackIndex & entry = pack.index[idx];
+
+		if (entry.image_offset > pack.size or entry.image_size > pack.size - entry.image_offset)
+		{
+			darknet_fatal_error(DARKNET_LOC, "entry #%zu in packed training file \"%s\" has an image outside of the file", idx, fn.c_str());
+		}
+
+		if (entry.boxes_offset > pack.size or entry.number_of_boxes > (pack.size - entry.boxes_offset) / sizeof(PackBox))
+		{
+			darknet_fatal_error(DARKNET_LOC, "entry #%zu in packed training file \"%s\" has annotations outside of the file", idx, fn.c_str());
+		}
+
+		if (entry.path_offset >= strings_size or memchr(strings + entry.path_offset, '\0', strings_size - entry.path_offset) == nullptr)
+		{
+			darknet_fatal_error(DARKNET_LOC, "entry #%zu in packed training file \"%s\" has an invalid filename", idx, fn.c_str());
+		}
+
+		pack.lookup[strings + entry.path_offset] = idx;
+	}
+
+	*cfg_and_state.output << "Using " << header->number_of_images << " packed training images from " << fn << " (" << size_to_IEC_string(pack.size) << ")." << std::endl;
+
+	return header->number_of_images;
+}
+
+
+void Darknet::close_training_pack()
+{
+	TAT(TATPARMS);
+
+	if (pack.data)
+	{
+		#ifdef WIN32
+		UnmapViewOfFile(pack.data);
+		CloseHandle(pack.mapping);
+		CloseHandle(pack.file);
+		#else
+		munmap(const_cast<uint8_t*>(pack.data), pack.size);
+		#endif
+	}
+
+	pack.filename.clear();
+	pack.data	= nullptr;
+	pack.size	= 0;
+	pack.index	= nullptr;
+	pack.lookup.clear();
+
+	return;
+}
+
+
+list * Darknet::get_training_pack_paths()
+{
+	TAT(TATPARMS);
+
+	list * lines = make_list();
+
+	if (pack.data)
+	{
+		const PackHeader * header = reinterpret_cast<const PackHeader*>(pack.data);
+		const char * strings = reinterpret_cast<const char*>(pack.data + header->strings_offset);
+
+		for (size_t idx = 0; idx < header->number_of_images; idx ++)
+		{
+			list_insert(lines, copy_string(const_cast<char*>(strings + pack.index[idx].path_offset)));
+		}
+	}
+
+	return lines;
+}
+
+
+bool Darknet::load_packed_image(const std::string & filename, const int channels, cv::Mat & mat, const int min_width, const int min_height)
+{
+	TAT(TATPARMS);
+
+	const PackIndex * entry = find_in_pack(filename);
+	if (entry == nullptr)
+	{
+		return false;
+	}
+
+	mat = decode_rgb_mat_image(pack.data + entry->image_offset, entry->image_size, filename, channels, min_width, min_height);
+
+	return true;
+}
+
+
+box_label * Darknet::load_packed_boxes(const std::string & filename, int & count)
+{
+	TAT(TATPARMS);
+
+	const PackIndex * entry = find_in_pack(filename);
+	if (entry == nullptr)
+	{
+		return nullptr;
+	}
+
+	count = entry->number_of_boxes;
+	box_label * boxes = (box_label*)xcalloc(std::max(1, count), sizeof(box_label));
+
+	const PackBox * packed = reinterpret_cast<const PackBox*>(pack.data + entry->boxes_offset);
+	for (int i = 0; i < count; ++i)
+	{
+		const PackBox & b = packed[i];
+		boxes[i].id			= b.id;
+		boxes[i].track_id	= b.track_id;
+		boxes[i].x			= b.x;
+		boxes[i].y			= b.y;
+		boxes[i].w			= b.w;
+		boxes[i].h			= b.h;
+		boxes[i].left		= b.x - b.w / 2.0f;
+		boxes[i].right		= b.x + b.w / 2.0f;
+		boxes[i].top		= b.y - b.h / 2.0f;
+		boxes[i].bottom		= b.y + b.h / 2.0f;
+	}
+
+	return boxes;
+}
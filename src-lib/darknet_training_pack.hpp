@@ -0,0 +1,62 @@
+#pragma once
+
+/** @file
+ * Training images and annotations packed into a single file.  Normally each training image requires opening the image
+ * file and the matching @p .txt annotation file, which is slow when the images are stored on a network share.  Once the
+ * images are packed with @p "darknet detector pack", training reads everything from a single memory-mapped file.
+ *
+ * The file starts with a header, followed by the original encoded bytes of every image and the bounding boxes parsed
+ * from the annotations.  The index and the image filenames are stored at the end of the file.
+ */
+
+
+#include "darknet_internal.hpp"
+
+
+namespace Darknet
+{
+	/** Pack all of the training images and annotations listed in the @p train=... file of the given @p .data file.  The
+	 * packed file is written to @p train_pack=... if that option exists in the @p .data file, otherwise it is written
+	 * next to the @p train=... file with the extension @p .pack.  This is called from @p "darknet detector pack".
+	 *
+	 * @since 2026-10-17
+	 */
+	void pack_training_images(const char * datacfg);
+
+	/** Memory-map the given packed training file.  Once opened, @ref load_packed_image() and @ref load_packed_boxes()
+	 * are used by the image loading threads instead of reading individual files.
+	 *
+	 * @returns The number of images in the packed file.
+	 *
+	 * @since 2026-10-17
+	 */
+	size_t open_training_pack(const std::filesystem::path & filename);
+
+	/// Unmap the file opened with @ref open_training_pack().  @since 2026-10-17
+	void close_training_pack();
+
+	/** Get a new list of all the image filenames stored in the packed training file.  This is used instead of
+	 * @ref get_paths() and must be freed the same way.
+	 *
+	 * @since 2026-10-17
+	 */
+	list * get_training_pack_paths();
+
+	/** Decode the given image from the packed training file.  See @ref load_rgb_mat_image() for @p min_width and
+	 * @p min_height.
+	 *
+	 * @returns @p false if no packed file is open, or if the image is not in the packed file.
+	 *
+	 * @since 2026-10-17
+	 */
+	bool load_packed_image(const std::string & filename, const int channels, cv::Mat & mat, const int min_width = 0, const int min_height = 0);
+
+	/** Get a copy of the bounding boxes for the given image from the packed training file.  The boxes are the same as
+	 * what @ref read_boxes() would have returned, and must be freed by the caller.
+	 *
+	 * @returns @p nullptr if no packed file is open, or if the image is not in the packed file.
+	 *
+	 * @since 2026-10-17
+	 */
+	box_label * load_packed_boxes(const std::string & filename, int & count);
+}
@@ -1,5 +1,6 @@
 #include "data.hpp"
 #include "darknet_internal.hpp"
+#include <unordered_map>
 
 #define NUMCHARS 37
 
@@ -22,21 +23,41 @@ namespace
 	static std::atomic<bool> image_data_loading_threads_must_exit = false;
 
 
-	/** Flags to indicate to individual data loading threads what they should do.  @p 0 is stop, and @p 1 is go.
-	 * These flags are normally @p 0 and then are set to @p 1 by @ref run_image_loading_control_thread().
+	/** The image loading jobs shared between @ref Darknet::run_image_loading_control_thread() and the permanent
+	 * loading threads.  The control thread splits each batch into small jobs and queues them.  Whichever loading thread
+	 * is available takes the next job, so a slow image no longer holds back all the other images given to the same
+	 * thread.
 	 *
-	 * (Was @p std::vector<bool> but that individual bit handling, and we only have a few threads.)
-	 *
-	 * @since 2024-04-10
+	 * @since 2026-10-17
+	 */
+	struct ImageLoadingQueue
+	{
+		std::mutex mutex;
+		std::condition_variable job_available;	///< signals the loading threads
+		std::condition_variable job_finished;	///< signals the control thread
+		std::deque<load_args> jobs;
+		size_t jobs_outstanding;				///< jobs queued or being loaded, but not yet finished
+
+		std::chrono::high_resolution_clock::duration idle_time;	///< time the loading threads waited for work
+		std::chrono::high_resolution_clock::duration busy_time;	///< time the loading threads spent loading images
+		size_t images_loaded;
+		uint64_t batches_queued;								///< numbers the batches of @ref Darknet::run_image_loading_control_thread()
+	};
+	static ImageLoadingQueue loading_queue;
+
+
+	/** Waiting threads are woken up as soon as a job is queued or finished.  This timeout is only used to notice
+	 * @ref Darknet::CfgAndState::must_immediately_exit, which is set from a signal handler.
 	 */
-	static std::vector<int> data_loading_per_thread_flag;
+	static const std::chrono::milliseconds exit_check_interval(250);
 
 
-	/// @{ @todo: delete these once the code is cleaned up
-	static const std::chrono::milliseconds thread_wait_ms(5); ///< @todo DELETE THIS! :(
-	static load_args * args_swap = NULL; ///< @todo I wish I better understood how/why this exists...
-	static std::mutex args_swap_mutex; // used to protect access to args_swap
-	/// @}
+	static inline bool loading_threads_must_exit()
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		return image_data_loading_threads_must_exit or cfg_and_state.must_immediately_exit;
+	}
 
 
 	static inline data concat_datas(data *d, int n)
@@ -53,6 +74,264 @@ namespace
 
 		return out;
 	}
+
+
+	/** Parse a YOLO annotation file.  This is what @ref read_boxes() used to do, but without calling
+	 * @ref darknet_fatal_error() so it can run on many threads at once.
+	 *
+	 * @returns @p false if the file cannot be opened.
+	 */
+	static bool parse_annotation_file(const char * filename, std::vector<box_label> & boxes)
+	{
+		TAT(TATPARMS);
+
+		boxes.clear();
+
+		FILE *file = fopen(filename, "r");
+		if (!file)
+		{
+			return false;
+		}
+
+		const int max_obj_img = 4000;// 30000;
+		const int img_hash = (custom_hash(const_cast<char*>(filename)) % max_obj_img)*max_obj_img;
+		float x, y, h, w;
+		int id;
+		while(fscanf(file, "%d %f %f %f %f", &id, &x, &y, &w, &h) == 5)
+		{
+			box_label b;
+			b.track_id = boxes.size() + img_hash;
+			b.id = id;
+			b.x = x;
+			b.y = y;
+			b.h = h;
+			b.w = w;
+			b.left   = x - w / 2.0f;
+			b.right  = x + w / 2.0f;
+			b.top    = y - h / 2.0f;
+			b.bottom = y + h / 2.0f;
+			boxes.push_back(b);
+		}
+
+		fclose(file);
+
+		return true;
+	}
+
+
+	/** All of the annotations used during training, parsed once by @ref Darknet::load_annotations() and then shared
+	 * (read-only) by the image loading threads.  The boxes for every image are stored one after the other in a single
+	 * vector.
+	 *
+	 * @since 2026-10-17
+	 */
+	struct AnnotationTable
+	{
+		std::unordered_map<std::string, size_t> lookup;	///< image filename to image index
+		std::vector<size_t> offsets;			///< the boxes for image @p idx are from @p offsets[idx] to @p offsets[idx+1]
+		std::vector<box_label> boxes;
+	};
+	static AnnotationTable annotations;
+
+
+	/** Batches which are loaded ahead of time by @ref Darknet::start_batch_prefetch().  The batch buffers are allocated
+	 * once and then re-used, so the image rows of each batch are always written to the same memory.
+	 *
+	 * @since 2026-10-17
+	 */
+	struct BatchPrefetcher
+	{
+		std::mutex mutex;
+		std::condition_variable batch_ready;		///< signals the training thread
+		std::condition_variable buffer_available;	///< signals the prefetch thread
+		std::thread thread;
+		bool must_stop;
+		int depth;					///< number of batches to load ahead of training, a.k.a. @p "[net] prefetch"
+		load_args args;				///< how the batches are loaded
+		std::deque<data> ready;		///< batches which have been loaded and are waiting to be used for training
+		std::vector<data> available;///< empty batch buffers
+		uint64_t next_batch_number;	///< training iteration which uses the next batch, seeds @ref Darknet::AugmentationRNG
+	};
+	static BatchPrefetcher prefetcher;
+
+
+	/// Number of jobs given to the loading threads for each batch.
+	static inline int get_number_of_jobs(const load_args & args)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		/* Normally each image is a job of its own.  Contrastive learning needs the images in pairs, and tracking needs
+		 * each thread to load consecutive frames, so in that case we keep the original split of one job per thread.
+		 */
+		if (args.track)
+		{
+			return std::max(1, args.threads);
+		}
+
+		if (args.contrastive)
+		{
+			return std::max(1, args.n / 2);
+		}
+
+		return args.n;
+	}
+
+
+	/// Create the permanent image loading threads (this should only happen once).
+	static void start_loading_threads(const load_args & args)
+	{
+		TAT(TATPARMS);
+
+		if (data_loading_threads.empty())
+		{
+			const int number_of_threads = std::max(1, args.threads); // typically will be 6
+
+			*cfg_and_state.output << "Creating " << number_of_threads << " permanent CPU threads to load images and bounding boxes." << std::endl;
+
+			data_loading_threads.reserve(number_of_threads);
+
+			for (int idx = 0; idx < number_of_threads; ++idx)
+			{
+				data_loading_threads.emplace_back(Darknet::image_loading_loop, idx, args);
+			}
+		}
+
+		return;
+	}
+
+
+	/** Split the batch described by @p args into jobs, queue them, and wait for the loading threads to finish.  Each
+	 * job stores the images it loads in @p destinations.
+	 */
+	static void load_batch(load_args args, data * destinations, const int number_of_jobs)
+	{
+		TAT(TATPARMS);
+
+		const int number_of_images = args.n; // typically will be 64 (batch size)
+
+		if (true)
+		{
+			std::lock_guard lock(loading_queue.mutex);
+
+			for (int idx = 0; idx < number_of_jobs; ++idx)
+			{
+				args.d = destinations + idx;
+				args.n = (idx + 1) * number_of_images / number_of_jobs - idx * number_of_images / number_of_jobs;
+				args.first_sample = idx * number_of_images / number_of_jobs;
+
+				loading_queue.jobs.push_back(args);
+				loading_queue.jobs_outstanding ++;
+			}
+		}
+		loading_queue.job_available.notify_all();
+
+		if (true)
+		{
+			std::unique_lock lock(loading_queue.mutex);
+			while (not loading_queue.job_finished.wait_for(lock, exit_check_interval, []() { return loading_queue.jobs_outstanding == 0; }))
+			{
+				if (loading_threads_must_exit())
+				{
+					// jobs not yet started will never be loaded, but we still need to wait for the ones in progress
+					loading_queue.jobs_outstanding -= loading_queue.jobs.size();
+					loading_queue.jobs.clear();
+				}
+			}
+		}
+
+		return;
+	}
+
+
+	static data make_batch_buffer(const load_args & args)
+	{
+		TAT(TATPARMS);
+
+		const int c = args.c ? args.c : 3;
+
+		/* The rows are allocated with calloc(), so the memory pages are only placed once they are first written.  When
+		 * thread placement is used, this happens on the image loading cores of the node which consumes the batches.
+		 */
+		data d = {0};
+		d.shallow = 0;
+		d.X = make_matrix(args.n, args.w * args.h * c);
+		d.y = make_matrix(args.n, args.truth_size * args.num_boxes);
+
+		return d;
+	}
+
+
+	static inline bool batch_buffer_fits(const data & d, const load_args & args)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		const int c = args.c ? args.c : 3;
+
+		return	d.X.rows == args.n						and
+				d.X.cols == args.w * args.h * c			and
+				d.y.cols == args.truth_size * args.num_boxes;
+	}
+
+
+	/// This runs on a secondary thread started by @ref Darknet::start_batch_prefetch().
+	static void batch_prefetch_loop()
+	{
+		TAT(TATPARMS);
+
+		cfg_and_state.set_thread_name("batch prefetch thread");
+		Darknet::place_image_loading_thread();
+
+		while (true)
+		{
+			data batch;
+			load_args args;
+
+			if (true)
+			{
+				std::unique_lock lock(prefetcher.mutex);
+				while (not prefetcher.buffer_available.wait_for(lock, exit_check_interval, []() { return prefetcher.must_stop or loading_threads_must_exit() or not prefetcher.available.empty(); }))
+				{
+				}
+
+				if (prefetcher.must_stop or loading_threads_must_exit())
+				{
+					break;
+				}
+
+				batch = prefetcher.available.back();
+				prefetcher.available.pop_back();
+				args = prefetcher.args;
+				args.batch_number = prefetcher.next_batch_number ++;
+			}
+
+			// each job writes directly to its own range of rows in the batch buffer
+			const int number_of_jobs = get_number_of_jobs(args);
+			std::vector<data> views(number_of_jobs);
+			for (int idx = 0; idx < number_of_jobs; ++idx)
+			{
+				const int first = idx * args.n / number_of_jobs;
+				views[idx]			= batch;
+				views[idx].shallow	= 1;
+				views[idx].X.vals	= batch.X.vals + first;
+				views[idx].y.vals	= batch.y.vals + first;
+				views[idx].X.rows	= (idx + 1) * args.n / number_of_jobs - first;
+				views[idx].y.rows	= views[idx].X.rows;
+			}
+
+			load_batch(args, views.data(), number_of_jobs);
+
+			if (true)
+			{
+				std::lock_guard lock(prefetcher.mutex);
+				prefetcher.ready.push_back(batch);
+			}
+			prefetcher.batch_ready.notify_all();
+		}
+
+		cfg_and_state.del_thread_name();
+
+		return;
+	}
 }
 
 
@@ -82,11 +361,11 @@ list *get_paths(const char *filename)
 	return lines;
 }
 
-char **get_sequential_paths(char **paths, int n, int m, int mini_batch, int augment_speed, int contrastive)
+char **get_sequential_paths(char **paths, int n, int m, int mini_batch, int augment_speed, int contrastive, Darknet::AugmentationRNG & rng)
 {
 	TAT(TATPARMS);
 
-	int speed = rand_int(1, augment_speed);
+	int speed = rng.integer(1, augment_speed);
 	if (speed < 1)
 	{
 		speed = 1;
@@ -103,7 +382,7 @@ char **get_sequential_paths(char **paths, int n, int m, int mini_batch, int augm
 		}
 		else
 		{
-			start_time_indexes[i] = random_gen(0, m - 1);
+			start_time_indexes[i] = rng.integer(0, m - 1);
 		}
 	}
 
@@ -121,7 +400,7 @@ char **get_sequential_paths(char **paths, int n, int m, int mini_batch, int augm
 }
 
 
-char **get_random_paths_custom(char **paths, int n, int m, int contrastive)
+char **get_random_paths_custom(char **paths, int n, int m, int contrastive, Darknet::AugmentationRNG & rng)
 {
 	TAT(TATPARMS);
 
@@ -132,7 +411,7 @@ char **get_random_paths_custom(char **paths, int n, int m, int contrastive)
 	// "n" is the total number of filenames to be returned at once
 	for (int i = 0; i < n; ++i)
 	{
-		int index = random_gen(0, m - 1);
+		int index = rng.integer(0, m - 1);
 		if (contrastive && (i % 2 == 1))
 		{
 			index = old_index;
@@ -148,63 +427,32 @@ char **get_random_paths_custom(char **paths, int n, int m, int contrastive)
 }
 
 
-char **get_random_paths(char **paths, int n, int m)
-{
-	TAT(TATPARMS);
-
-	return get_random_paths_custom(paths, n, m, 0);
-}
-
-
 box_label *read_boxes(char *filename, int *n)
 {
 	TAT(TATPARMS);
 
-	box_label* boxes = (box_label*)xcalloc(1, sizeof(box_label));
-	FILE *file = fopen(filename, "r");
-	if (!file)
+	std::vector<box_label> v;
+	if (not parse_annotation_file(filename, v))
 	{
 		darknet_fatal_error(DARKNET_LOC, "failed to open annotation file \"%s\"", filename);
 	}
 
-	const int max_obj_img = 4000;// 30000;
-	const int img_hash = (custom_hash(filename) % max_obj_img)*max_obj_img;
-	float x, y, h, w;
-	int id;
-	int count = 0;
-	while(fscanf(file, "%d %f %f %f %f", &id, &x, &y, &w, &h) == 5)
-	{
-//		*cfg_and_state.output << "x=" << x << " y=" << y << " w=" << w << " h=" << h << std::endl;
-
-		boxes = (box_label*)xrealloc(boxes, (count + 1) * sizeof(box_label));
-		boxes[count].track_id = count + img_hash;
-		boxes[count].id = id;
-		boxes[count].x = x;
-		boxes[count].y = y;
-		boxes[count].h = h;
-		boxes[count].w = w;
-		boxes[count].left   = x - w / 2.0f;
-		boxes[count].right  = x + w / 2.0f;
-		boxes[count].top    = y - h / 2.0f;
-		boxes[count].bottom = y + h / 2.0f;
-		++count;
-	}
-
-	fclose(file);
-	*n = count;
+	box_label* boxes = (box_label*)xcalloc(std::max<size_t>(1, v.size()), sizeof(box_label));
+	std::copy(v.begin(), v.end(), boxes);
+	*n = v.size();
 
 	return boxes;
 }
 
 
-void randomize_boxes(box_label *b, int n)
+void randomize_boxes(box_label *b, int n, Darknet::AugmentationRNG & rng)
 {
 	TAT(TATPARMS);
 
 	int i;
 	for(i = 0; i < n; ++i)
 	{
-		const auto index = random_gen(0, n - 1);
+		const auto index = rng.integer(0, n - 1);
 		std::swap(b[i], b[index]);
 	}
 }
@@ -262,7 +510,7 @@ void correct_boxes(box_label *boxes, int n, float dx, float dy, float sx, float
 }
 
 
-int fill_truth_detection(const char *path, int num_boxes, int truth_size, float *truth, int classes, int flip, float dx, float dy, float sx, float sy, int net_w, int net_h)
+int fill_truth_detection(const char *path, int num_boxes, int truth_size, float *truth, int classes, int flip, float dx, float dy, float sx, float sy, int net_w, int net_h, Darknet::AugmentationRNG & rng)
 {
 	TAT(TATPARMS);
 
@@ -273,11 +521,15 @@ int fill_truth_detection(const char *path, int num_boxes, int truth_size, float
 
 	int count = 0;
 	int i;
-	box_label *boxes = read_boxes(labelpath, &count);
+	box_label *boxes = Darknet::get_annotations(path, count);
+	if (boxes == nullptr)
+	{
+		boxes = read_boxes(labelpath, &count);
+	}
 	int min_w_h = 0;
 	float lowest_w = 1.F / net_w;
 	float lowest_h = 1.F / net_h;
-	randomize_boxes(boxes, count);
+	randomize_boxes(boxes, count, rng);
 	correct_boxes(boxes, count, dx, dy, sx, sy, flip);
 	if (count > num_boxes)
 	{
@@ -619,11 +871,14 @@ void blend_truth_mosaic(float *new_truth, int boxes, int truth_size, float *old_
 
 
 data load_data_detection(int n, char **paths, int m, int w, int h, int c, int boxes, int truth_size, int classes, int use_flip, int use_gaussian_noise, int use_blur, int use_mixup,
-	float jitter, float resize, float hue, float saturation, float exposure, int mini_batch, int track, int augment_speed, int letter_box, int mosaic_bound, int contrastive, int contrastive_jit_flip, int contrastive_color, int show_imgs)
+	float jitter, float resize, float hue, float saturation, float exposure, int mini_batch, int track, int augment_speed, int letter_box, int mosaic_bound, int contrastive, int contrastive_jit_flip, int contrastive_color, int show_imgs,
+	data * destination, Darknet::AugmentationRNG & rng)
 {
 	TAT(TATPARMS);
 
 	// This is the method that gets called to load the "n" images for each loading thread while training a network.
+	// If "destination" is set, then the images and annotations are written directly into those rows of the batch.
+	// All random values come from "rng", which is specific to this job (see Darknet::AugmentationRNG).
 
 	c = c ? c : 3;
 
@@ -637,7 +892,7 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 		darknet_fatal_error(DARKNET_LOC, "letterbox and mosaic cannot be combined");
 	}
 
-	if (random_gen() % 2 == 0)
+	if (rng.integer(0, 1) == 0)
 	{
 		use_mixup = 0;
 	}
@@ -653,8 +908,8 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 
 		for (int i = 0; i < n; ++i)
 		{
-			cut_x[i] = rand_int(w*min_offset, w*(1 - min_offset));
-			cut_y[i] = rand_int(h*min_offset, h*(1 - min_offset));
+			cut_x[i] = rng.integer(w*min_offset, w*(1 - min_offset));
+			cut_y[i] = rng.integer(h*min_offset, h*(1 - min_offset));
 		}
 	}
 
@@ -665,6 +920,28 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 	d.X.vals = (float**)xcalloc(d.X.rows, sizeof(float*));
 	d.X.cols = h*w*c;
 
+	if (destination)
+	{
+		d.shallow = 1;
+		d.y.rows = n;
+		d.y.cols = truth_size * boxes;
+		d.y.vals = (float**)xcalloc(d.y.rows, sizeof(float*));
+		for (int i = 0; i < n; ++i)
+		{
+			d.X.vals[i] = destination->X.vals[i];
+			d.y.vals[i] = destination->y.vals[i];
+			memset(d.y.vals[i], 0, d.y.cols * sizeof(float));
+		}
+	}
+	else
+	{
+		d.y = make_matrix(n, truth_size * boxes);
+		for (int i = 0; i < n; ++i)
+		{
+			d.X.vals[i] = (float*)xcalloc(d.X.cols, sizeof(float));
+		}
+	}
+
 	float r1 = 0.0f;
 	float r2 = 0.0f;
 	float r3 = 0.0f;
@@ -679,8 +956,6 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 	int augmentation_calculated = 0;
 	int gaussian_noise = 0;
 
-	d.y = make_matrix(n, truth_size * boxes);
-
 	for (int i_mixup = 0; i_mixup <= use_mixup; i_mixup++)
 	{
 		if (i_mixup)
@@ -691,11 +966,11 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 		char **random_paths;
 		if (track)
 		{
-			random_paths = get_sequential_paths(paths, n, m, mini_batch, augment_speed, contrastive);
+			random_paths = get_sequential_paths(paths, n, m, mini_batch, augment_speed, contrastive, rng);
 		}
 		else
 		{
-			random_paths = get_random_paths_custom(paths, n, m, contrastive);
+			random_paths = get_random_paths_custom(paths, n, m, contrastive, rng);
 		}
 
 		// about to load multiple images ("n"), usually batch size divided by the number of loading threads
@@ -704,7 +979,7 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 			float *truth = (float*)xcalloc(truth_size * boxes, sizeof(float));
 			const char *filename = random_paths[i];
 
-			cv::Mat src = load_rgb_mat_image(filename, c);
+			cv::Mat src = Darknet::load_cached_rgb_mat_image(filename, c);
 
 			const int oh = src.rows;	// original height
 			const int ow = src.cols;	// original width
@@ -732,29 +1007,29 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 			if (!augmentation_calculated || !track)
 			{
 				augmentation_calculated = 1;
-				resize_r1 = random_float();
-				resize_r2 = random_float();
+				resize_r1 = rng.uniform();
+				resize_r2 = rng.uniform();
 
 				if (!contrastive || contrastive_jit_flip || i % 2 == 0)
 				{
-					r1 = random_float();
-					r2 = random_float();
-					r3 = random_float();
-					r4 = random_float();
+					r1 = rng.uniform();
+					r2 = rng.uniform();
+					r3 = rng.uniform();
+					r4 = rng.uniform();
 
-					flip = use_flip ? random_gen() % 2 : 0;
+					flip = use_flip ? rng.integer(0, 1) : 0;
 				}
 
 				if (!contrastive || contrastive_color || i % 2 == 0)
 				{
-					dhue = rand_uniform_strong(-hue, hue);
-					dsat = rand_scale(saturation);
-					dexp = rand_scale(exposure);
+					dhue = rng.uniform(-hue, hue);
+					dsat = rng.scale(saturation);
+					dexp = rng.scale(exposure);
 				}
 
 				if (use_blur)
 				{
-					int tmp_blur = rand_int(0, 2);  // 0 - disable, 1 - blur background, 2 - blur the whole image
+					int tmp_blur = rng.integer(0, 2);  // 0 - disable, 1 - blur background, 2 - blur the whole image
 					if (tmp_blur == 0)
 					{
 						blur = 0;
@@ -769,7 +1044,7 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 					}
 				}
 
-				if (use_gaussian_noise && rand_int(0, 1) == 1)
+				if (use_gaussian_noise && rng.integer(0, 1) == 1)
 				{
 					gaussian_noise = use_gaussian_noise;
 				}
@@ -822,7 +1097,7 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 			}
 
 			// move each 2nd image to the corner - so that most of it was visible
-			if (use_mixup == 3 && random_gen() % 2 == 0)
+			if (use_mixup == 3 && rng.integer(0, 1) == 0)
 			{
 				if (flip)
 				{
@@ -850,92 +1125,60 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 			const float dy = ((float)ptop / oh) / sy;
 
 			// This is where we get the annotations for this image.
-			const int min_w_h = fill_truth_detection(filename, boxes, truth_size, truth, classes, flip, dx, dy, 1. / sx, 1. / sy, w, h);
+			const int min_w_h = fill_truth_detection(filename, boxes, truth_size, truth, classes, flip, dx, dy, 1. / sx, 1. / sy, w, h, rng);
 
 			if ((min_w_h / 8) < blur && blur > 1)
 			{
 				blur = min_w_h / 8;   // disable blur if one of the objects is too small
 			}
 
-			Darknet::Image ai = image_data_augmentation(src, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, gaussian_noise, blur, boxes, truth_size, truth);
+			if (gaussian_noise)
+			{
+				// the noise is added with cv::randn(), which uses the per-thread OpenCV generator
+				cv::theRNG() = cv::RNG((static_cast<uint64_t>(rng.next()) << 32) | rng.next());
+			}
+
+			// the augmented image is written directly to the output row, which is also what is shown when show_imgs=1
+			Darknet::Image ai = make_empty_image(w, h, c);
+			ai.data = d.X.vals[i];
 
-			if (use_mixup == 0)
+			if (use_mixup == 0 or (use_mixup == 1 and i_mixup == 0))
 			{
-				d.X.vals[i] = ai.data;
+				image_data_augmentation_into(src, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, gaussian_noise, blur, boxes, truth_size, truth,
+					cv::Rect(0, 0, w, h), d.X.vals[i], w, h, 0, 0);
 				memcpy(d.y.vals[i], truth, truth_size * boxes * sizeof(float));
 			}
 			else if (use_mixup == 1)
 			{
-				if (i_mixup == 0)
-				{
-					d.X.vals[i] = ai.data;
-					memcpy(d.y.vals[i], truth, truth_size * boxes * sizeof(float));
-				}
-				else if (i_mixup == 1)
-				{
-					Darknet::Image old_img = make_empty_image(w, h, c);
-					old_img.data = d.X.vals[i];
-					blend_images_cv(ai, 0.5, old_img, 0.5);
-					blend_truth(d.y.vals[i], boxes, truth_size, truth);
-					Darknet::free_image(old_img);
-					d.X.vals[i] = ai.data;
-				}
+				Darknet::Image tmp_img = image_data_augmentation(src, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, gaussian_noise, blur, boxes, truth_size, truth);
+				blend_images_cv(ai, 0.5, tmp_img, 0.5);
+				blend_truth(d.y.vals[i], boxes, truth_size, truth);
+				Darknet::free_image(tmp_img);
 			}
 			else if (use_mixup == 3)
 			{
-				if (i_mixup == 0)
-				{
-					Darknet::Image tmp_img = make_image(w, h, c);
-					d.X.vals[i] = tmp_img.data;
-				}
-
-				if (flip)
-				{
-					int tmp = pleft;
-					pleft = pright;
-					pright = tmp;
-				}
+				// the shifts are calculated from the crop of the flipped image
+				const int crop_left		= flip ? pright : pleft;
+				const int crop_right	= flip ? pleft : pright;
 
-				const int left_shift = min_val_cmp(cut_x[i], max_val_cmp(0, (-pleft*w / ow)));
+				const int left_shift = min_val_cmp(cut_x[i], max_val_cmp(0, (-crop_left*w / ow)));
 				const int top_shift = min_val_cmp(cut_y[i], max_val_cmp(0, (-ptop*h / oh)));
 
-				const int right_shift = min_val_cmp((w - cut_x[i]), max_val_cmp(0, (-pright*w / ow)));
+				const int right_shift = min_val_cmp((w - cut_x[i]), max_val_cmp(0, (-crop_right*w / ow)));
 				const int bot_shift = min_val_cmp(h - cut_y[i], max_val_cmp(0, (-pbot*h / oh)));
 
+				// each of the 4 images only needs to calculate the part which ends up in its quadrant of the mosaic
+				const int x_src	= (i_mixup == 0 or i_mixup == 2) ? (w - cut_x[i] - right_shift)	: left_shift;
+				const int y_src	= (i_mixup == 0 or i_mixup == 1) ? (h - cut_y[i] - bot_shift)	: top_shift;
+				const int x_dst	= (i_mixup == 0 or i_mixup == 2) ? 0							: cut_x[i];
+				const int y_dst	= (i_mixup == 0 or i_mixup == 1) ? 0							: cut_y[i];
+				const int width	= (i_mixup == 0 or i_mixup == 2) ? cut_x[i]						: w - cut_x[i];
+				const int height= (i_mixup == 0 or i_mixup == 1) ? cut_y[i]						: h - cut_y[i];
 
-				//int k, x, y;
-				for (int k = 0; k < c; ++k)
-				{
-					for (int y = 0; y < h; ++y)
-					{
-						int j = y*w + k*w*h;
-						if (i_mixup == 0 && y < cut_y[i])
-						{
-							int j_src = (w - cut_x[i] - right_shift) + (y + h - cut_y[i] - bot_shift)*w + k*w*h;
-							memcpy(&d.X.vals[i][j + 0], &ai.data[j_src], cut_x[i] * sizeof(float));
-						}
-						if (i_mixup == 1 && y < cut_y[i])
-						{
-							int j_src = left_shift + (y + h - cut_y[i] - bot_shift)*w + k*w*h;
-							memcpy(&d.X.vals[i][j + cut_x[i]], &ai.data[j_src], (w-cut_x[i]) * sizeof(float));
-						}
-						if (i_mixup == 2 && y >= cut_y[i])
-						{
-							int j_src = (w - cut_x[i] - right_shift) + (top_shift + y - cut_y[i])*w + k*w*h;
-							memcpy(&d.X.vals[i][j + 0], &ai.data[j_src], cut_x[i] * sizeof(float));
-						}
-						if (i_mixup == 3 && y >= cut_y[i])
-						{
-							int j_src = left_shift + (top_shift + y - cut_y[i])*w + k*w*h;
-							memcpy(&d.X.vals[i][j + cut_x[i]], &ai.data[j_src], (w - cut_x[i]) * sizeof(float));
-						}
-					}
-				}
+				image_data_augmentation_into(src, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, gaussian_noise, blur, boxes, truth_size, truth,
+					cv::Rect(x_src, y_src, width, height), d.X.vals[i], w, h, x_dst, y_dst);
 
 				blend_truth_mosaic(d.y.vals[i], boxes, truth_size, truth, w, h, cut_x[i], cut_y[i], i_mixup, left_shift, right_shift, top_shift, bot_shift, w, h, mosaic_bound);
-
-				Darknet::free_image(ai);
-				ai.data = d.X.vals[i];
 			}
 
 			if (show_imgs && i_mixup == use_mixup)   // delete i_mixup
@@ -1009,8 +1252,39 @@ void Darknet::load_single_image_data(load_args args)
 		case DETECTION_DATA:
 		{
 			// 2024:  used in detector.cpp (when training a neural network)
-			*args.d = load_data_detection(args.n, args.paths, args.m, args.w, args.h, args.c, args.num_boxes, args.truth_size, args.classes, args.flip, args.gaussian_noise, args.blur, args.mixup, args.jitter, args.resize,
-					args.hue, args.saturation, args.exposure, args.mini_batch, args.track, args.augment_speed, args.letter_box, args.mosaic_bound, args.contrastive, args.contrastive_jit_flip, args.contrastive_color, args.show_imgs);
+			// the destination rows may have been allocated ahead of time (see Darknet::start_batch_prefetch())
+			const int c = args.c ? args.c : 3;
+			const bool preallocated =
+				args.d->X.vals != nullptr						and
+				args.d->X.rows >= args.n						and
+				args.d->X.cols == args.w * args.h * c			and
+				args.d->y.cols == args.truth_size * args.num_boxes;
+
+			// the random values depend only on the seed and the position of the images in the batch, not on the thread
+			Darknet::AugmentationRNG rng(Darknet::get_augmentation_seed(), args.batch_number, args.first_sample);
+
+			data loaded = load_data_detection(args.n, args.paths, args.m, args.w, args.h, args.c, args.num_boxes, args.truth_size, args.classes, args.flip, args.gaussian_noise, args.blur, args.mixup, args.jitter, args.resize,
+					args.hue, args.saturation, args.exposure, args.mini_batch, args.track, args.augment_speed, args.letter_box, args.mosaic_bound, args.contrastive, args.contrastive_jit_flip, args.contrastive_color, args.show_imgs,
+					preallocated ? args.d : nullptr, rng);
+
+			if (preallocated)
+			{
+				// the images were written directly to the destination rows, so only the row pointers need to be freed
+				Darknet::free_data(loaded);
+			}
+			else if (args.d->X.vals == nullptr)
+			{
+				*args.d = loaded;
+			}
+			else
+			{
+				for (int i = 0; i < loaded.X.rows and i < args.d->X.rows; ++i)
+				{
+					memcpy(args.d->X.vals[i], loaded.X.vals[i], std::min(loaded.X.cols, args.d->X.cols) * sizeof(float));
+					memcpy(args.d->y.vals[i], loaded.y.vals[i], std::min(loaded.y.cols, args.d->y.cols) * sizeof(float));
+				}
+				Darknet::free_data(loaded);
+			}
 			break;
 		}
 	}
@@ -1027,36 +1301,44 @@ void Darknet::image_loading_loop(const int idx, load_args args)
 
 	const std::string name = "image loading loop #" + std::to_string(idx);
 	cfg_and_state.set_thread_name(name);
+	Darknet::place_image_loading_thread();
 
-	const int number_of_threads	= args.threads;	// typically will be 6
-	const int number_of_images	= args.n;		// typically will be 64 (batch size)
-
-	// calculate the number of images this thread needs to load at once
-	// e.g., 64 batch size / 6 threads = 10 or 11 images per thread
-	args.n = (idx + 1) * number_of_images / number_of_threads - idx * number_of_images / number_of_threads;
-
-	while (image_data_loading_threads_must_exit == false and
-			cfg_and_state.must_immediately_exit == false)
+	while (true)
 	{
-		/// @todo get rid of this busy-loop
+		load_args job;
 
-		// wait until the control thread tells us we can load the next set of images
-		if (data_loading_per_thread_flag[idx] == 0)
+		if (true)
 		{
-			Darknet::TimingAndTracking tat2(name, false, "SLEEPING!");
-			std::this_thread::sleep_for(thread_wait_ms);
-			continue;
-		}
+			std::unique_lock lock(loading_queue.mutex);
+
+			// wait until the control thread gives us images to load
+			const auto t1 = std::chrono::high_resolution_clock::now();
+			while (not loading_queue.job_available.wait_for(lock, exit_check_interval, []() { return loading_threads_must_exit() or not loading_queue.jobs.empty(); }))
+			{
+			}
+			loading_queue.idle_time += std::chrono::high_resolution_clock::now() - t1;
 
-		// if we get here, then the control thread has told us to load the next image
+			if (loading_threads_must_exit())
+			{
+				break;
+			}
 
-		args_swap_mutex.lock();
-		load_args args_local = args_swap[idx];
-		args_swap_mutex.unlock();
+			job = loading_queue.jobs.front();
+			loading_queue.jobs.pop_front();
+		}
 
-		Darknet::load_single_image_data(args_local);
+		const auto t2 = std::chrono::high_resolution_clock::now();
+		Darknet::load_single_image_data(job);
+		const auto t3 = std::chrono::high_resolution_clock::now();
 
-		data_loading_per_thread_flag[idx] = 0;
+		if (true)
+		{
+			std::lock_guard lock(loading_queue.mutex);
+			loading_queue.busy_time += t3 - t2;
+			loading_queue.images_loaded += job.n;
+			loading_queue.jobs_outstanding --;
+		}
+		loading_queue.job_finished.notify_one();
 	}
 
 	cfg_and_state.del_thread_name();
@@ -1076,64 +1358,34 @@ void Darknet::run_image_loading_control_thread(load_args args)
 
 	const std::string name = "image loading control thread";
 	cfg_and_state.set_thread_name(name);
+	Darknet::place_image_loading_thread();
 
 	if (args.threads == 0)
 	{
 		args.threads = 1;
 	}
-	const int number_of_threads	= args.threads;	// typically will be 6
-	const int number_of_images	= args.n;		// typically will be 64 (batch size)
-
-	data * out = args.d;
-	data * buffers = (data*)xcalloc(number_of_threads, sizeof(data));
 
-	// create the secondary threads (this should only happen once)
-	if (data_loading_threads.empty())
-	{
-		*cfg_and_state.output << "Creating " << number_of_threads << " permanent CPU threads to load images and bounding boxes." << std::endl;
+	const int number_of_jobs = get_number_of_jobs(args);
 
-		data_loading_threads			.reserve(number_of_threads);
-		data_loading_per_thread_flag	.reserve(number_of_threads);
+	data * out = args.d;
+	data * buffers = (data*)xcalloc(number_of_jobs, sizeof(data));
 
-		args_swap = (load_args *)xcalloc(number_of_threads, sizeof(load_args));
+	start_loading_threads(args);
 
-		for (int idx = 0; idx < number_of_threads; ++idx)
-		{
-			data_loading_per_thread_flag.push_back(0);
-			data_loading_threads.emplace_back(image_loading_loop, idx, args);
-		}
-	}
-
-	// tell each thread that we want more images, and where they can be stored
-	for (int idx = 0; idx < number_of_threads; ++idx)
+	if (true)
 	{
-		args.d = buffers + idx;
-		args.n = (idx + 1) * number_of_images / number_of_threads - idx * number_of_images / number_of_threads;
-
-		args_swap_mutex.lock();
-		args_swap[idx] = args;
-		args_swap_mutex.unlock();
-
-		data_loading_per_thread_flag[idx] = 1;
+		// only a single control thread runs at a time, so the numbering is the same from one run to the next
+		std::lock_guard lock(loading_queue.mutex);
+		args.batch_number = loading_queue.batches_queued ++;
 	}
 
-	// wait for the loading threads to be done
-	for (int idx = 0; idx < number_of_threads; ++idx)
-	{
-		while (image_data_loading_threads_must_exit == false and
-				cfg_and_state.must_immediately_exit == false and
-				data_loading_per_thread_flag[idx] != 0) // the loading thread will reset this flag to zero once it is ready
-		{
-			Darknet::TimingAndTracking tat2(name, false, "SLEEPING!");
-			std::this_thread::sleep_for(thread_wait_ms);
-		}
-	}
+	load_batch(args, buffers, number_of_jobs);
 
 	// process the results
-	*out = concat_datas(buffers, number_of_threads);
+	*out = concat_datas(buffers, number_of_jobs);
 	out->shallow = 0;
 
-	for (int idx = 0; idx < number_of_threads; ++idx)
+	for (int idx = 0; idx < number_of_jobs; ++idx)
 	{
 		buffers[idx].shallow = 1;
 		Darknet::free_data(buffers[idx]);
@@ -1152,7 +1404,12 @@ void Darknet::stop_image_loading_threads()
 
 	if (not data_loading_threads.empty())
 	{
-		image_data_loading_threads_must_exit = true;
+		if (true)
+		{
+			std::lock_guard lock(loading_queue.mutex);
+			image_data_loading_threads_must_exit = true;
+		}
+		loading_queue.job_available.notify_all();
 
 		for (auto & t : data_loading_threads)
 		{
@@ -1161,9 +1418,11 @@ void Darknet::stop_image_loading_threads()
 				t.join();
 			}
 		}
-		free(args_swap);
 		data_loading_threads.clear();
 
+		loading_queue.jobs.clear();
+		loading_queue.jobs_outstanding = 0;
+
 		image_data_loading_threads_must_exit = false;
 	}
 
@@ -1171,6 +1430,310 @@ void Darknet::stop_image_loading_threads()
 }
 
 
+Darknet::ImageLoadingStats Darknet::get_image_loading_stats()
+{
+	TAT(TATPARMS);
+
+	std::lock_guard lock(loading_queue.mutex);
+
+	ImageLoadingStats stats;
+	stats.threads		= data_loading_threads.size();
+	stats.images		= loading_queue.images_loaded;
+	stats.idle_seconds	= std::chrono::duration<double>(loading_queue.idle_time).count();
+	stats.busy_seconds	= std::chrono::duration<double>(loading_queue.busy_time).count();
+
+	loading_queue.images_loaded	= 0;
+	loading_queue.idle_time		= {};
+	loading_queue.busy_time		= {};
+
+	return stats;
+}
+
+
+void Darknet::start_batch_prefetch(load_args args, const int depth, const uint64_t first_batch_number)
+{
+	TAT(TATPARMS);
+
+	if (args.threads == 0)
+	{
+		args.threads = 1;
+	}
+
+	if (prefetcher.thread.joinable())
+	{
+		const load_args & old = prefetcher.args;
+		if (depth		== prefetcher.depth	and
+			args.n		== old.n			and
+			args.w		== old.w			and
+			args.h		== old.h			and
+			args.c		== old.c			and
+			args.threads== old.threads)
+		{
+			// nothing has changed, keep using the batches which have already been loaded
+			return;
+		}
+
+		// the batches already loaded no longer match what the network needs, so start again
+		stop_batch_prefetch();
+	}
+
+	start_loading_threads(args);
+
+	prefetcher.must_stop			= false;
+	prefetcher.depth				= std::max(1, depth);
+	prefetcher.args					= args;
+	prefetcher.args.d				= nullptr;
+	prefetcher.next_batch_number	= first_batch_number;
+
+	// one more buffer than the depth, since the batch used for training is not available to be re-loaded
+	for (int idx = 0; idx <= prefetcher.depth; ++idx)
+	{
+		prefetcher.available.push_back(make_batch_buffer(prefetcher.args));
+	}
+
+	if (cfg_and_state.is_verbose)
+	{
+		const size_t bytes = (prefetcher.depth + 1) * (static_cast<size_t>(prefetcher.available[0].X.cols) + prefetcher.available[0].y.cols) * args.n * sizeof(float);
+		*cfg_and_state.output << "Loading up to " << prefetcher.depth << " batch" << (prefetcher.depth == 1 ? "" : "es") << " ahead of training using " << size_to_IEC_string(bytes) << "." << std::endl;
+	}
+
+	prefetcher.thread = std::thread(batch_prefetch_loop);
+
+	return;
+}
+
+
+data Darknet::get_prefetched_batch()
+{
+	TAT(TATPARMS);
+
+	data d = {0};
+
+	std::unique_lock lock(prefetcher.mutex);
+	while (true)
+	{
+		if (prefetcher.batch_ready.wait_for(lock, exit_check_interval, []() { return not prefetcher.ready.empty(); }))
+		{
+			d = prefetcher.ready.front();
+			prefetcher.ready.pop_front();
+			break;
+		}
+
+		if (loading_threads_must_exit() and not prefetcher.available.empty())
+		{
+			// we're exiting and nothing more will be loaded, so return an unused buffer instead
+			d = prefetcher.available.back();
+			prefetcher.available.pop_back();
+			break;
+		}
+	}
+
+	return d;
+}
+
+
+void Darknet::release_prefetched_batch(data & d)
+{
+	TAT(TATPARMS);
+
+	if (true)
+	{
+		std::lock_guard lock(prefetcher.mutex);
+		if (prefetcher.thread.joinable() and batch_buffer_fits(d, prefetcher.args))
+		{
+			prefetcher.available.push_back(d);
+			d = {0};
+		}
+	}
+
+	if (d.X.vals)
+	{
+		// the network was resized since this batch was loaded, so replace the buffer with one of the new size
+		Darknet::free_data(d);
+		d = {0};
+
+		std::lock_guard lock(prefetcher.mutex);
+		if (prefetcher.thread.joinable())
+		{
+			prefetcher.available.push_back(make_batch_buffer(prefetcher.args));
+		}
+	}
+	prefetcher.buffer_available.notify_one();
+
+	return;
+}
+
+
+void Darknet::stop_batch_prefetch()
+{
+	TAT(TATPARMS);
+
+	if (prefetcher.thread.joinable())
+	{
+		if (true)
+		{
+			std::lock_guard lock(prefetcher.mutex);
+			prefetcher.must_stop = true;
+		}
+		prefetcher.buffer_available.notify_all();
+		prefetcher.thread.join();
+	}
+
+	for (auto & d : prefetcher.ready)
+	{
+		Darknet::free_data(d);
+	}
+	for (auto & d : prefetcher.available)
+	{
+		Darknet::free_data(d);
+	}
+	prefetcher.ready.clear();
+	prefetcher.available.clear();
+
+	return;
+}
+
+
+size_t Darknet::load_annotations(char ** paths, const int number_of_images, const int classes)
+{
+	TAT(TATPARMS);
+
+	free_annotations();
+
+	const auto timestamp = std::chrono::high_resolution_clock::now();
+
+	std::vector<std::vector<box_label>> boxes(number_of_images);
+	std::vector<std::string> errors(number_of_images);
+
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int idx = 0; idx < number_of_images; ++idx)
+	{
+		int count = 0;
+		box_label * packed = load_packed_boxes(paths[idx], count);
+		if (packed)
+		{
+			boxes[idx].assign(packed, packed + count);
+			free(packed);
+		}
+		else
+		{
+			char labelpath[4096];
+			replace_image_to_label(paths[idx], labelpath);
+			if (not parse_annotation_file(labelpath, boxes[idx]))
+			{
+				errors[idx] = "failed to open annotation file " + std::string(labelpath);
+				continue;
+			}
+		}
+
+		/* Only the checks which do not depend on augmentation are done up front:
+		 *
+		 * - class IDs outside of 0...classes-1 (fill_truth_detection() only catches IDs >= classes)
+		 * - boxes which are entirely outside of the image (correct_boxes() marks these as 999999, which is then fatal in
+		 *   fill_truth_detection())
+		 *
+		 * These are stricter than training:  fill_truth_detection() only looks at the first "max" boxes after shuffling,
+		 * so a bad box in an image with many annotations would not always have been seen.  What is NOT caught here:
+		 *
+		 * - boxes centered at exactly x=0,y=0 (also marked as 999999 by correct_boxes() and fatal in
+		 *   fill_truth_detection() when used)
+		 * - centers outside of 0...1 and widths or heights > 1 for boxes which still overlap the image, since those are
+		 *   checked by fill_truth_detection() after jitter, flip and resize have moved the boxes
+		 */
+		for (const auto & b : boxes[idx])
+		{
+			if (b.id < 0 or b.id >= classes)
+			{
+				errors[idx] = "invalid class ID #" + std::to_string(b.id) + " for " + paths[idx];
+				break;
+			}
+			if (b.x + b.w / 2.0f < 0.0f or b.y + b.h / 2.0f < 0.0f or
+				b.x - b.w / 2.0f > 1.0f or b.y - b.h / 2.0f > 1.0f)
+			{
+				errors[idx] = "invalid coordinates for class ID #" + std::to_string(b.id) + " for " + paths[idx];
+				break;
+			}
+		}
+	}
+
+	size_t number_of_errors = 0;
+	for (const auto & msg : errors)
+	{
+		if (not msg.empty())
+		{
+			number_of_errors ++;
+			if (number_of_errors <= 20)
+			{
+				Darknet::display_error_msg(msg + "\n");
+			}
+		}
+	}
+
+	if (number_of_errors)
+	{
+		darknet_fatal_error(DARKNET_LOC, "found %zu images with invalid annotations", number_of_errors);
+	}
+
+	size_t total = 0;
+	for (const auto & v : boxes)
+	{
+		total += v.size();
+	}
+
+	annotations.boxes.reserve(total);
+	annotations.offsets.reserve(number_of_images + 1);
+	annotations.lookup.reserve(number_of_images);
+	for (int idx = 0; idx < number_of_images; ++idx)
+	{
+		annotations.lookup[paths[idx]] = idx;
+		annotations.offsets.push_back(annotations.boxes.size());
+		annotations.boxes.insert(annotations.boxes.end(), boxes[idx].begin(), boxes[idx].end());
+	}
+	annotations.offsets.push_back(annotations.boxes.size());
+
+	const auto duration = std::chrono::high_resolution_clock::now() - timestamp;
+	*cfg_and_state.output
+		<< "Loaded " << total << " annotations for " << number_of_images << " images in "
+		<< Darknet::format_time(std::chrono::duration<double>(duration).count()) << "." << std::endl;
+
+	return total;
+}
+
+
+void Darknet::free_annotations()
+{
+	TAT(TATPARMS);
+
+	annotations.lookup.clear();
+	annotations.offsets.clear();
+	annotations.boxes.clear();
+	annotations.boxes.shrink_to_fit();
+
+	return;
+}
+
+
+box_label * Darknet::get_annotations(const std::string & filename, int & count)
+{
+	TAT(TATPARMS);
+
+	const auto iter = annotations.lookup.find(filename);
+	if (iter == annotations.lookup.end())
+	{
+		return nullptr;
+	}
+
+	const size_t first	= annotations.offsets[iter->second];
+	const size_t last	= annotations.offsets[iter->second + 1];
+
+	count = last - first;
+	box_label * boxes = (box_label*)xcalloc(std::max<size_t>(1, count), sizeof(box_label));
+	std::copy(annotations.boxes.begin() + first, annotations.boxes.begin() + last, boxes);
+
+	return boxes;
+}
+
+
 matrix concat_matrix(matrix m1, matrix m2)
 {
 	TAT(TATPARMS);
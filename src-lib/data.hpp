@@ -62,6 +62,86 @@ namespace Darknet
 	void load_single_image_data(load_args args);
 
 
+	/// Statistics on the image loading threads.  @see @ref Darknet::get_image_loading_stats()
+	struct ImageLoadingStats
+	{
+		size_t threads;			///< number of permanent image loading threads
+		size_t images;			///< number of images loaded
+		double idle_seconds;	///< total time the loading threads waited for work
+		double busy_seconds;	///< total time the loading threads spent loading images
+	};
+
+
+	/** Get the time spent by the image loading threads since the previous call.  This is called once per training
+	 * iteration to report whether the loading threads are keeping up.
+	 *
+	 * @since 2026-10-17
+	 */
+	ImageLoadingStats get_image_loading_stats();
+
+
+	/** Start loading training batches on a secondary thread, up to @p depth batches ahead of the batch currently used
+	 * for training.  The batch buffers are allocated once and re-used, and the loading threads write the images
+	 * directly into the rows of those buffers.  If the prefetcher is already running with different image dimensions,
+	 * batch size, or number of threads, then the batches already loaded are discarded and loading starts again.
+	 *
+	 * @p first_batch_number is the training iteration which will use the next batch.  The batches are numbered from
+	 * there for @ref Darknet::AugmentationRNG, so the augmentation of each iteration does not depend on how many batches
+	 * were discarded when loading starts again.
+	 *
+	 * The depth is set with @p "[net] prefetch" in the configuration file.
+	 *
+	 * @see @ref get_prefetched_batch()
+	 * @see @ref release_prefetched_batch()
+	 * @see @ref stop_batch_prefetch()
+	 *
+	 * @since 2026-10-17
+	 */
+	void start_batch_prefetch(load_args args, const int depth, const uint64_t first_batch_number);
+
+
+	/** Get the next batch loaded by @ref start_batch_prefetch().  This blocks until a batch is available.  The batch
+	 * must be given back with @ref release_prefetched_batch() once training is done with it, and must not be freed.
+	 *
+	 * @since 2026-10-17
+	 */
+	data get_prefetched_batch();
+
+
+	/// Give a batch obtained with @ref get_prefetched_batch() back to the prefetcher so the buffer can be re-used.  @since 2026-10-17
+	void release_prefetched_batch(data & d);
+
+
+	/// Stop the thread started by @ref start_batch_prefetch() and free all of the batch buffers.  @since 2026-10-17
+	void stop_batch_prefetch();
+
+
+	/** Parse the annotations for all of the training images.  This is called once at the start of training, and the
+	 * files are parsed in parallel.  Any problem with the annotations is reported immediately instead of stopping the
+	 * training session later when the image is first used.  Boxes from the packed training file are used when one is
+	 * open (see @ref open_training_pack()).
+	 *
+	 * @returns The total number of annotations.
+	 *
+	 * @since 2026-10-17
+	 */
+	size_t load_annotations(char ** paths, const int number_of_images, const int classes);
+
+
+	/// Free the annotations loaded by @ref load_annotations().  @since 2026-10-17
+	void free_annotations();
+
+
+	/** Get a copy of the annotations loaded by @ref load_annotations() for the given image.  The boxes are the same as
+	 * what @ref read_boxes() would have returned, and must be freed by the caller.
+	 *
+	 * @returns @p nullptr if the annotations for this image have not been loaded.
+	 *
+	 * @since 2026-10-17
+	 */
+	box_label * get_annotations(const std::string & filename, int & count);
+
+
 	/// Frees the "data buffer" used to load images.
 	void free_data(data & d);
 }
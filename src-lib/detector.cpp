@@ -141,7 +141,6 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 		<< std::endl;
 
 	data train;
-	data buffer;
 
 	Darknet::Layer l = net.layers[net.n - 1];
 	for (int k = 0; k < net.n; ++k)
@@ -158,7 +157,18 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 
 	int classes = l.classes;
 
-	list *plist = get_paths(train_images);
+	// if the images were packed with "darknet detector pack" then we get everything from the packed file
+	const char *train_pack = option_find_str_quiet(options, "train_pack", nullptr);
+	list *plist = nullptr;
+	if (train_pack)
+	{
+		Darknet::open_training_pack(train_pack);
+		plist = Darknet::get_training_pack_paths();
+	}
+	else
+	{
+		plist = get_paths(train_images);
+	}
 	int train_images_num = plist->size;
 	if (train_images_num == 0)
 	{
@@ -171,6 +181,9 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 
 	char **paths = (char **)list_to_array(plist);
 
+	// parse all of the annotations once, instead of every time an image is loaded
+	Darknet::load_annotations(paths, train_images_num, classes);
+
 	const int calc_map_for_each = fmax(100, train_images_num / (net.batch * net.subdivisions));  // calculate mAP for each epoch (used to be every 4 epochs)
 	*cfg_and_state.output << "mAP calculations will be every " << calc_map_for_each << " iterations" << std::endl;
 
@@ -208,7 +221,6 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 	args.truth_size = l.truth_size;
 	net.num_boxes = args.num_boxes;
 	net.train_images_num = train_images_num;
-	args.d = &buffer;
 	args.type = DETECTION_DATA; // this is the only place in the code where this type is used
 	args.threads = 64;    // 16 or 64 -- see several lines below where this is set to 6 * GPUs
 
@@ -262,7 +274,33 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 			<< std::endl;
 	}
 
-	std::thread load_thread = std::thread(Darknet::run_image_loading_control_thread, args);
+	/* With "random=1" the network may later be resized to something larger, so the image cache and the reduced decoding
+	 * both use the largest size the network can reach (same calculation as the resize done in the training loop below)
+	 * to avoid up-sampling the images.
+	 */
+	int max_w = net.w;
+	int max_h = net.h;
+	if (l.random)
+	{
+		const float rand_coef = (l.random != 1.0f ? l.random : 1.4f);
+		max_w = std::max(max_w, static_cast<int>(roundl(rand_coef * net.w / net.resize_step + 1) * net.resize_step));
+		max_h = std::max(max_h, static_cast<int>(roundl(rand_coef * net.h / net.resize_step + 1) * net.resize_step));
+	}
+
+	// "image_cache_max_side" is relative to the largest network size, e.g. 2.0 keeps twice the width and height
+	Darknet::configure_image_cache(net.image_cache_size_limit, std::round(net.image_cache_max_side * std::max(max_w, max_h)));
+
+	// large JPEG images can be decoded at a reduced size as long as there are enough pixels left for the jitter crop
+	if (net.reduced_decoding)
+	{
+		Darknet::configure_reduced_decoding(std::round(max_w * (1.0f + l.jitter)), std::round(max_h * (1.0f + l.jitter)));
+	}
+
+	// choose (and report) the augmentation seed before the loading threads start to use it
+	Darknet::get_augmentation_seed();
+
+	// the images are loaded on secondary threads, several batches ahead of the batch used for training
+	Darknet::start_batch_prefetch(args, net.prefetch, get_current_iteration(net));
 
 	int count = 0;
 
@@ -345,11 +383,7 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 				<< ", " << dim_w << "x" << dim_h
 				<< std::endl;
 
-			load_thread.join();
-			train = buffer;
-			Darknet::free_data(train);
-
-			load_thread = std::thread(Darknet::run_image_loading_control_thread, args);
+			Darknet::start_batch_prefetch(args, net.prefetch, get_current_iteration(net));
 
 			for (int k = 0; k < ngpus; ++k)
 			{
@@ -359,8 +393,7 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 		} // random=1
 
 		double time = what_time_is_it_now();
-		load_thread.join();
-		train = buffer;
+		train = Darknet::get_prefetched_batch();
 		if (net.track)
 		{
 			net.sequential_subdivisions = get_current_seq_subdivisions(net);
@@ -369,13 +402,22 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 				<< "sequential_subdivisions=" << net.sequential_subdivisions
 				<< ", sequence=" << get_sequence_value(net)
 				<< std::endl;
+			// the batch for this iteration has already been taken, so loading resumes with the next iteration
+			Darknet::start_batch_prefetch(args, net.prefetch, get_current_iteration(net) + 1);
 		}
-		load_thread = std::thread(Darknet::run_image_loading_control_thread, args);
 
 		const double load_time = (what_time_is_it_now() - time);
 		if (cfg_and_state.is_verbose)
 		{
-			*cfg_and_state.output << "loaded " << args.n << " images in " << Darknet::format_time(load_time) << std::endl;
+			// "stalled" is how long training waited for the images, "idle" is how long the loading threads waited for work
+			const auto stats = Darknet::get_image_loading_stats();
+			const double total_seconds = stats.idle_seconds + stats.busy_seconds;
+			*cfg_and_state.output
+				<< "loaded " << args.n << " images, training stalled " << Darknet::format_time(load_time)
+				<< ", " << stats.threads << " loading threads busy " << Darknet::format_time(stats.busy_seconds)
+				<< " and idle " << Darknet::format_time(stats.idle_seconds)
+				<< " (" << static_cast<int>(std::round(total_seconds > 0.0 ? 100.0 * stats.busy_seconds / total_seconds : 0.0)) << "% busy)"
+				<< std::endl;
 		}
 		if (load_time > 0.1 && avg_loss > 0.0f)
 		{
@@ -456,8 +498,17 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 			<< ", " << Darknet::format_time(what_time_is_it_now() - time)
 			<< ", " << iteration * imgs
 			<< " images, time remaining="
-			<< Darknet::format_time_remaining(seconds_remaining)
-			<< std::endl;
+			<< Darknet::format_time_remaining(seconds_remaining);
+
+		const auto cache_stats = Darknet::get_image_cache_stats();
+		if (cache_stats.enabled)
+		{
+			*cfg_and_state.output
+				<< ", cache hits=" << cache_stats.hits
+				<< " misses=" << cache_stats.misses
+				<< " (" << cache_stats.images << " images, " << size_to_IEC_string(cache_stats.bytes) << ")";
+		}
+		*cfg_and_state.output << std::endl;
 
 		// This is where we decide if we have to do the mAP% calculations.
 		if (calc_map && (iteration >= next_map_calc || iteration == net.max_batches))
@@ -482,10 +533,7 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 					args.n = imgs;
 					*cfg_and_state.output << init_w << " x " << init_h << " (batch=" << init_b << ")" << std::endl;
 				}
-				load_thread.join();
-				Darknet::free_data(train);
-				train = buffer;
-				load_thread = std::thread(Darknet::run_image_loading_control_thread, args);
+				Darknet::start_batch_prefetch(args, net.prefetch, get_current_iteration(net));
 
 				for (int k = 0; k < ngpus; ++k)
 				{
@@ -558,7 +606,7 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 				*cfg_and_state.output << "EMA weights are saved to " << buff << std::endl;
 			}
 		}
-		Darknet::free_data(train);
+		Darknet::release_prefetched_batch(train);
 
 	} // end of training loop
 
@@ -602,10 +650,12 @@ void train_detector_internal(const bool break_after_burn_in, std::string & multi
 	}
 
 	// free memory
-	load_thread.join();
-	Darknet::free_data(buffer);
-
+	Darknet::stop_batch_prefetch();
 	Darknet::stop_image_loading_threads();
+	Darknet::configure_image_cache(0, 0);
+	Darknet::configure_reduced_decoding(0, 0);
+	Darknet::free_annotations();
+	Darknet::close_training_pack();
 
 	free((void*)base);
 	free(paths);
@@ -1019,14 +1069,7 @@ void validate_detector(char *datacfg, char *cfgfile, char *weightfile, const cha
 			Darknet::Detection * dets = get_network_boxes(&net, w, h, thresh, .5, map, 0, &nboxes, letter_box);
 			if (nms)
 			{
-				if (l.nms_kind == DEFAULT_NMS)
-				{
-					do_nms_sort(dets, nboxes, l.classes, nms);
-				}
-				else
-				{
-					diounms_sort(dets, nboxes, l.classes, nms, l.nms_kind, l.beta_nms);
-				}
+				do_nms_fused(dets, nboxes, l.classes, nms, l.nms_kind, l.beta_nms);
 			}
 
 			if (coco)
@@ -1139,7 +1182,7 @@ void validate_detector_recall(char *datacfg, char *cfgfile, char *weightfile)
 		int nboxes = 0;
 		int letterbox = 0;
 		Darknet::Detection * dets = get_network_boxes(&net, sized.w, sized.h, thresh, .5, 0, 1, &nboxes, letterbox);
-		if (nms) do_nms_obj(dets, nboxes, 1, nms);
+		if (nms) do_nms_fused(dets, nboxes, 1, nms, OBJECTNESS_NMS, 0.0f);
 
 		char labelpath[4096];
 		replace_image_to_label(path, labelpath);
@@ -1371,14 +1414,7 @@ float validate_detector_map(const char * datacfg, const char * cfgfile, const ch
 			}
 			if (nms)
 			{
-				if (l.nms_kind == DEFAULT_NMS)
-				{
-					do_nms_sort(dets, nboxes, l.classes, nms);
-				}
-				else
-				{
-					diounms_sort(dets, nboxes, l.classes, nms, l.nms_kind, l.beta_nms);
-				}
+				do_nms_fused(dets, nboxes, l.classes, nms, l.nms_kind, l.beta_nms);
 			}
 
 			char labelpath[4096];
@@ -2160,14 +2196,7 @@ void test_detector(const char *datacfg, const char *cfgfile, const char *weightf
 		Darknet::Detection * dets = get_network_boxes(&net, im.w, im.h, thresh, hier_thresh, 0, 1, &nboxes, letter_box);
 		if (nms)
 		{
-			if (l.nms_kind == DEFAULT_NMS)
-			{
-				do_nms_sort(dets, nboxes, l.classes, nms);
-			}
-			else
-			{
-				diounms_sort(dets, nboxes, l.classes, nms, l.nms_kind, l.beta_nms);
-			}
+			do_nms_fused(dets, nboxes, l.classes, nms, l.nms_kind, l.beta_nms);
 		}
 
 		// Load the image explicitly asking for 3 color channels
@@ -2338,6 +2367,8 @@ void run_detector(int argc, char **argv)
 	else if (cfg_and_state.function == "valid"		) { validate_detector(datacfg, cfg, weights, outfile); }
 	else if (cfg_and_state.function == "recall"		) { validate_detector_recall(datacfg, cfg, weights); }
 	else if (cfg_and_state.function == "map"		) { validate_detector_map(datacfg, cfg, weights, thresh, iou_thresh, map_points, letter_box, NULL); }
+	else if (cfg_and_state.function == "pack"		) { Darknet::pack_training_images(datacfg); }
+	else if (cfg_and_state.function == "quantize"	) { Darknet::quantize_network(datacfg, cfg, weights, thresh, iou_thresh); }
 	else if (cfg_and_state.function == "calcanchors")
 	{
 		const int show				= cfg_and_state.is_set	("show"			) ? 1 : 0;
@@ -382,6 +382,7 @@ static int HW_AVX512BW;   //  AVX512 Byte + Word
 static int HW_AVX512DQ;   //  AVX512 Doubleword + Quadword
 static int HW_AVX512IFMA; //  AVX512 Integer 52-bit Fused Multiply-Add
 static int HW_AVX512VBMI; //  AVX512 Vector Byte Manipulation Instructions
+static int HW_AVX512VNNI; //  AVX512 Vector Neural Network Instructions
 
 // https://stackoverflow.com/questions/6121792/how-to-check-if-a-cpu-supports-the-sse3-instruction-set
 void check_cpu_features(void)
@@ -432,6 +433,7 @@ void check_cpu_features(void)
 		HW_AVX512DQ = (info[1] & ((uint32_t)1 << 17)) != 0;
 		HW_AVX512IFMA = (info[1] & ((uint32_t)1 << 21)) != 0;
 		HW_AVX512VBMI = (info[2] & ((uint32_t)1 << 1)) != 0;
+		HW_AVX512VNNI = (info[2] & ((uint32_t)1 << 11)) != 0;
 	}
 	if (nExIds >= 0x80000001) {
 		cpuid(info, 0x80000001);
@@ -489,6 +491,60 @@ int is_fma_avx2()
 	return result;
 }
 
+int is_avx512()
+{
+	TAT(TATPARMS);
+
+	static int result = -1;
+
+	if (result == -1)
+	{
+		check_cpu_features();
+		result = HW_AVX512F && HW_FMA3;
+
+		if (result)
+		{
+			// the CPU may support AVX-512, but the OS must also save the opmask and ZMM registers (XCR0 bits 5, 6, and 7)
+			#if defined(_MSC_VER)
+			const uint64_t xcr0 = _xgetbv(0);
+			#else
+			uint32_t eax = 0;
+			uint32_t edx = 0;
+			__asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			const uint64_t xcr0 = (static_cast<uint64_t>(edx) << 32) | eax;
+			#endif
+			result = ((xcr0 & 0xe6) == 0xe6);
+		}
+
+		if (result == 1)
+		{
+			*cfg_and_state.output << "AVX-512 detected." << std::endl;
+		}
+	}
+
+	return result;
+}
+
+int is_avx512_vnni()
+{
+	TAT(TATPARMS);
+
+	static int result = -1;
+
+	if (result == -1)
+	{
+		check_cpu_features();
+		result = is_avx512() && HW_AVX512BW && HW_AVX512VNNI;
+
+		if (result == 1)
+		{
+			*cfg_and_state.output << "AVX-512 VNNI detected." << std::endl;
+		}
+	}
+
+	return result;
+}
+
 // https://software.intel.com/sites/landingpage/IntrinsicsGuide
 void gemm_nn(int M, int N, int K, float ALPHA,
 	float *A, int lda,
@@ -1699,6 +1755,18 @@ int is_fma_avx2()
 	return 0;
 }
 
+int is_avx512()
+{
+	TAT(TATPARMS);
+	return 0;
+}
+
+int is_avx512_vnni()
+{
+	TAT(TATPARMS);
+	return 0;
+}
+
 void gemm_nn(int M, int N, int K, float ALPHA,
 	float *A, int lda,
 	float *B, int ldb,
@@ -2391,6 +2459,45 @@ void gemm_cpu(int TA, int TB, int M, int N, int K, float ALPHA,
 	}
 
 	is_avx();   // initialize static variable
+	if (gemm_packed_is_supported() && static_cast<int64_t>(M) * N * K >= GEMM_PACKED_MIN_FLOPS)
+	{
+		gemm_packed(TA, TB, M, N, K, ALPHA, A, lda, B, ldb, C, ldc);
+	}
+	else
+	{
+		gemm_cpu_unpacked(TA, TB, M, N, K, ALPHA, A, lda, B, ldb, C, ldc);
+	}
+}
+
+
+void gemm_cpu_fused(int TA, int TB, int M, int N, int K, float ALPHA,
+		float *A, int lda,
+		float *B, int ldb,
+		float *C, int ldc,
+		const GemmEpilogue & epilogue)
+{
+	TAT(TATPARMS);
+
+	is_avx();   // initialize static variable
+	if (gemm_packed_is_supported() && static_cast<int64_t>(M) * N * K >= GEMM_PACKED_MIN_FLOPS)
+	{
+		gemm_packed(TA, TB, M, N, K, ALPHA, A, lda, B, ldb, C, ldc, true, &epilogue);
+	}
+	else
+	{
+		gemm_cpu_unpacked(TA, TB, M, N, K, ALPHA, A, lda, B, ldb, C, ldc);
+		apply_gemm_epilogue(epilogue, 0, 0, M, N, C, ldc);
+	}
+}
+
+
+void gemm_cpu_unpacked(int TA, int TB, int M, int N, int K, float ALPHA,
+		float *A, int lda,
+		float *B, int ldb,
+		float *C, int ldc)
+{
+	TAT(TATPARMS);
+
 	if (is_fma_avx2() && !TA && !TB)
 	{
 		gemm_nn_fast(M, N, K, ALPHA, A, lda, B, ldb, C, ldc);
@@ -2645,4 +2752,5 @@ void init_cpu()
 
 	is_avx();
 	is_fma_avx2();
+	is_avx512();
 }
@@ -33,6 +33,12 @@ static inline unsigned char get_bit(unsigned char const*const src, size_t index)
 int is_avx();
 int is_fma_avx2();
 
+/// Whether the CPU and the OS both support AVX-512F.  @since 2026-10-17
+int is_avx512();
+
+/// Whether the CPU and the OS both support AVX-512 VNNI, used by @ref gemm_int8().  @since 2026-10-17
+int is_avx512_vnni();
+
 void float_to_bit(float *src, unsigned char *dst, size_t size);
 
 void transpose_block_SSE4x4(float *A, float *B, const int n, const int m,
@@ -107,6 +113,100 @@ void gemm_cpu(int TA, int TB, int M, int N, int K, float ALPHA,
         float BETA,
         float *C, int ldc);
 
+/** The original multiplication used by @ref gemm_cpu() prior to @ref gemm_packed().  It is still used for very small
+ * matrices, and is the baseline in @ref Darknet::benchmark_gemm().
+ *
+ * @since 2026-10-17
+ */
+void gemm_cpu_unpacked(int TA, int TB, int M, int N, int K, float ALPHA,
+        float *A, int lda,
+        float *B, int ldb,
+        float *C, int ldc);
+
+/** Bias and activation applied to each tile of C as soon as it has been fully accumulated, while the tile is still in the
+ * L1 cache.  This replaces the separate passes over the output of a convolutional layer made by @ref add_bias() and
+ * @ref activate_array().  Unlike @ref activate_array_swish() and @ref activate_array_mish(), the value before the
+ * activation is not kept since it is only needed for training.
+ *
+ * @see @ref gemm_epilogue_supports()
+ *
+ * @since 2026-10-17
+ */
+struct GemmEpilogue
+{
+	const float * bias;				///< one value per row of C, or @p nullptr
+	ACTIVATION activation;
+	bool bias_per_column = false;	///< when the output is stored as NHWC, there is one bias per column of C instead of per row
+};
+
+/// Whether @ref GemmEpilogue can apply this activation.  @since 2026-10-17
+bool gemm_epilogue_supports(const ACTIVATION activation);
+
+/** Apply the bias and activation to @p rows rows and @p cols columns of C.  The first value is at row @p m and column
+ * @p n of the matrix, which is used to find the bias.
+ *
+ * @since 2026-10-17
+ */
+void apply_gemm_epilogue(const GemmEpilogue & epilogue, const int m, const int n, const int rows, const int cols, float * C, const int ldc);
+
+/** Same as @ref gemm_cpu() with @p "BETA = 1", followed by the given @ref GemmEpilogue.  When @ref gemm_packed() is used
+ * the epilogue is applied to each tile, otherwise it is applied once the whole matrix has been multiplied.
+ *
+ * @since 2026-10-17
+ */
+void gemm_cpu_fused(int TA, int TB, int M, int N, int K, float ALPHA,
+        float *A, int lda,
+        float *B, int ldb,
+        float *C, int ldc,
+        const GemmEpilogue & epilogue);
+
+/** Smaller matrix multiplications are not worth the cost of packing the matrices, so @ref gemm_cpu() only calls
+ * @ref gemm_packed() when @p "M * N * K" is at least this large.
+ */
+#define GEMM_PACKED_MIN_FLOPS (32 * 32 * 32)
+
+/// Whether @ref gemm_packed() can be used on this CPU.  Requires AVX2 and FMA.  @since 2026-10-17
+bool gemm_packed_is_supported();
+
+/** Cache-blocked matrix multiplication, computing @p "C += ALPHA * op(A) * op(B)".  The matrices are copied into
+ * contiguous panels sized for the L1, L2, and L3 caches (same as GotoBLAS and BLIS) and then multiplied with a
+ * register-tiled micro-kernel.  The micro-kernel uses AVX-512 when available, otherwise AVX2 and FMA.  Work is split
+ * between the OpenMP threads.
+ *
+ * @p allow_avx512 can be set to @p false to force the AVX2 micro-kernel, which is mostly useful when benchmarking.
+ * When @p epilogue is set, it is applied to each tile of C once the last block of @p K has been accumulated.
+ *
+ * @see @ref gemm_packed_is_supported()
+ * @see @ref Darknet::benchmark_gemm()
+ *
+ * @since 2026-10-17
+ */
+void gemm_packed(int TA, int TB, int M, int N, int K, float ALPHA,
+        const float *A, int lda,
+        const float *B, int ldb,
+        float *C, int ldc,
+        const bool allow_avx512 = true,
+        const GemmEpilogue * epilogue = nullptr);
+
+/** Quantized matrix multiplication, computing @p "C = (A * quantize(B)) * A_scales[m] * B_scale".  @p A contains
+ * 8-bit weights with one scale per row, and @p B is quantized to 8 bits using @p B_scale while it is being packed.  The
+ * products are accumulated in 32-bit integers, using AVX-512 VNNI when available, otherwise AVX2.  Work is split
+ * between the OpenMP threads the same way as @ref gemm_packed().
+ *
+ * @p lda must be a multiple of 4, and each row of @p A must be padded with zeros from @p K up to that multiple of 4.
+ * @p A_sums is the sum of each row of @p A, which is needed to remove the offset applied to @p B by the VNNI
+ * instructions.  When @p epilogue is set, it is applied to each tile of C as it is written.
+ *
+ * @see @ref Darknet::quantize_network()
+ *
+ * @since 2026-10-17
+ */
+void gemm_int8(int M, int N, int K,
+        const int8_t *A, int lda, const int32_t *A_sums, const float *A_scales,
+        const float *B, int ldb, float B_scale,
+        float *C, int ldc,
+        const GemmEpilogue * epilogue = nullptr);
+
 #ifdef DARKNET_GPU
 void gemm_ongpu(int TA, int TB, int M, int N, int K, float ALPHA,
         float *A_gpu, int lda,
@@ -0,0 +1,514 @@
+/** @file
+ * 8-bit integer matrix multiplication for the CPU.  See @ref gemm_int8().
+ *
+ * The weights (A) are quantized once when the network is loaded, with one scale per filter.  The input (B) is quantized
+ * with a single scale for the whole layer while it is being packed into panels of @p nr columns.  Products are summed
+ * in 32-bit integers and only converted back to float when the tile of C is written:
+ *
+ * ~~~~.txt
+ *     C[m,n] = (sum over k of Aq[m,k] * Bq[k,n]) * A_scales[m] * B_scale
+ * ~~~~
+ *
+ * The AVX-512 VNNI micro-kernel multiplies unsigned bytes by signed bytes, so B is stored as @p "Bq + 128" and
+ * @p "128 * sum(Aq[m])" is subtracted from each row at the end.  The AVX2 micro-kernel widens both matrices to 16 bits
+ * and uses @p vpmaddwd, which unlike @p vpmaddubsw cannot saturate when two large products are added together.
+ */
+
+#include "gemm.hpp"
+
+#ifdef DARKNET_OPENMP
+#include <omp.h>
+#endif
+
+#if (defined(__AVX__) && defined(__x86_64__)) || (defined(_WIN64) && !defined(__MINGW32__) && !defined(_M_ARM64))
+#define DARKNET_GEMM_INT8
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+/// The AVX2 and AVX-512 VNNI micro-kernels are compiled for those instructions even when the rest of %Darknet is not.
+#define DARKNET_TARGET(x) __attribute__((target(x)))
+#else
+#define DARKNET_TARGET(x)
+#endif
+#endif
+
+
+namespace
+{
+	/// Columns of C computed by the micro-kernels.  This is also the width of the packed panels of B.
+	static const int nr = 16;
+
+	/// Rows of C computed by the AVX-512 VNNI micro-kernel.
+	static const int mr_vnni = 8;
+
+	/// Rows of C computed by the AVX2 micro-kernel.
+	static const int mr_avx2 = 4;
+
+	/// Approximate size of the packed columns of B, which is meant to stay in L2 while all the rows of A go through.
+	static const size_t packed_b_bytes = 512 * 1024;
+
+
+	enum class EInt8Kernel
+	{
+		kScalar,
+		kAVX2,
+		kVNNI,
+	};
+
+
+	/// Quantize a single value of B.
+	static inline int8_t quantize(const float x, const float inv_scale)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		const float v = std::clamp(x * inv_scale, -127.0f, 127.0f);
+
+		return static_cast<int8_t>(std::lrint(v));
+	}
+
+
+	/** Simple reference used when the CPU has neither AVX2 nor AVX-512 VNNI.  Each thread quantizes the columns
+	 * @p "[n0, n1)" of B and then accumulates one row of C at a time.
+	 */
+	static void gemm_int8_block_scalar(const int m0, const int m1, const int n0, const int n1, const int K, const int8_t * A, const int lda, const float * A_scales, const float * B, const int ldb, const float B_scale, float * C, const int ldc, const GemmEpilogue * epilogue)
+	{
+		TAT(TATPARMS);
+
+		thread_local std::vector<int8_t> quantized;
+		thread_local std::vector<int32_t> accumulator;
+
+		const int cols = n1 - n0;
+		const float inv_scale = 1.0f / B_scale;
+
+		quantized.resize(static_cast<size_t>(K) * cols);
+		accumulator.resize(cols);
+
+		for (int k = 0; k < K; ++k)
+		{
+			for (int n = 0; n < cols; ++n)
+			{
+				quantized[static_cast<size_t>(k) * cols + n] = quantize(B[static_cast<size_t>(k) * ldb + n0 + n], inv_scale);
+			}
+		}
+
+		for (int m = m0; m < m1; ++m)
+		{
+			std::fill(accumulator.begin(), accumulator.end(), 0);
+			for (int k = 0; k < K; ++k)
+			{
+				const int32_t a = A[static_cast<size_t>(m) * lda + k];
+				const int8_t * b = quantized.data() + static_cast<size_t>(k) * cols;
+				for (int n = 0; n < cols; ++n)
+				{
+					accumulator[n] += a * b[n];
+				}
+			}
+
+			const float scale = A_scales[m] * B_scale;
+			float * c = C + static_cast<size_t>(m) * ldc + n0;
+			for (int n = 0; n < cols; ++n)
+			{
+				c[n] = static_cast<float>(accumulator[n]) * scale;
+			}
+
+			if (epilogue)
+			{
+				apply_gemm_epilogue(*epilogue, m, n0, 1, cols, c, ldc);
+			}
+		}
+
+		return;
+	}
+
+
+#ifdef DARKNET_GEMM_INT8
+	/// Read 4 bytes of A as a single 32-bit value which can then be broadcast.
+	static inline int32_t load_quad(const int8_t * a)
+	{
+		int32_t value;
+		std::memcpy(&value, a, sizeof(value));
+
+		return value;
+	}
+
+
+	/// Quantize the first @p cols values of a row of B, and return them as 16 signed bytes.  Missing columns are zero.
+	DARKNET_TARGET("avx2")
+	static inline __m128i quantize_16(const float * src, const int cols, const __m256 inv_scale)
+	{
+		float tmp[nr];
+		if (cols < nr)
+		{
+			std::fill(tmp, tmp + nr, 0.0f);
+			std::memcpy(tmp, src, cols * sizeof(float));
+			src = tmp;
+		}
+
+		const __m256 lower = _mm256_set1_ps(-127.0f);
+		const __m256 upper = _mm256_set1_ps(127.0f);
+		const __m256 x0 = _mm256_min_ps(upper, _mm256_max_ps(lower, _mm256_mul_ps(_mm256_loadu_ps(src + 0), inv_scale)));
+		const __m256 x1 = _mm256_min_ps(upper, _mm256_max_ps(lower, _mm256_mul_ps(_mm256_loadu_ps(src + 8), inv_scale)));
+
+		// the packs work within each 128-bit lane, so the 64-bit blocks need to be put back in order
+		__m256i words = _mm256_packs_epi32(_mm256_cvtps_epi32(x0), _mm256_cvtps_epi32(x1));
+		words = _mm256_permute4x64_epi64(words, 0xd8);
+
+		return _mm_packs_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+	}
+
+
+	/** Quantize the columns @p "[j0, j0+nc)" of B into panels of @p nr columns for the VNNI micro-kernel.  Every
+	 * 32-bit value holds 4 consecutive rows of the same column, offset by 128 so they can be treated as unsigned.
+	 */
+	DARKNET_TARGET("avx2,avx512f,avx512bw,avx512vnni")
+	static void pack_b_vnni(const float * B, const int ldb, const int K, const int Kp, const int j0, const int nc, const float inv_scale, uint8_t * dst)
+	{
+		const __m256 inv = _mm256_set1_ps(inv_scale);
+		const __m128i offset = _mm_set1_epi8(static_cast<char>(0x80));
+
+		for (int jr = 0; jr < nc; jr += nr)
+		{
+			const int cols = std::min(nr, nc - jr);
+			for (int k = 0; k < Kp; k += 4)
+			{
+				__m128i r[4];
+				for (int i = 0; i < 4; ++i)
+				{
+					r[i] = (k + i < K) ? quantize_16(B + static_cast<size_t>(k + i) * ldb + j0 + jr, cols, inv) : _mm_setzero_si128();
+				}
+
+				const __m128i r01_lo = _mm_unpacklo_epi8(r[0], r[1]);
+				const __m128i r01_hi = _mm_unpackhi_epi8(r[0], r[1]);
+				const __m128i r23_lo = _mm_unpacklo_epi8(r[2], r[3]);
+				const __m128i r23_hi = _mm_unpackhi_epi8(r[2], r[3]);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0 ), _mm_xor_si128(offset, _mm_unpacklo_epi16(r01_lo, r23_lo)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_xor_si128(offset, _mm_unpackhi_epi16(r01_lo, r23_lo)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_xor_si128(offset, _mm_unpacklo_epi16(r01_hi, r23_hi)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), _mm_xor_si128(offset, _mm_unpackhi_epi16(r01_hi, r23_hi)));
+				dst += 4 * nr;
+			}
+		}
+
+		return;
+	}
+
+
+	/** Quantize the columns @p "[j0, j0+nc)" of B into panels of @p nr columns for the AVX2 micro-kernel.  Every
+	 * 32-bit value holds 2 consecutive rows of the same column as 16-bit integers.
+	 */
+	DARKNET_TARGET("avx2")
+	static void pack_b_avx2(const float * B, const int ldb, const int K, const int Kp, const int j0, const int nc, const float inv_scale, int16_t * dst)
+	{
+		const __m256 inv = _mm256_set1_ps(inv_scale);
+
+		for (int jr = 0; jr < nc; jr += nr)
+		{
+			const int cols = std::min(nr, nc - jr);
+			for (int k = 0; k < Kp; k += 2)
+			{
+				const __m128i r0 = (k + 0 < K) ? quantize_16(B + static_cast<size_t>(k + 0) * ldb + j0 + jr, cols, inv) : _mm_setzero_si128();
+				const __m128i r1 = (k + 1 < K) ? quantize_16(B + static_cast<size_t>(k + 1) * ldb + j0 + jr, cols, inv) : _mm_setzero_si128();
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 0 ), _mm256_cvtepi8_epi16(_mm_unpacklo_epi8(r0, r1)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 16), _mm256_cvtepi8_epi16(_mm_unpackhi_epi8(r0, r1)));
+				dst += 2 * nr;
+			}
+		}
+
+		return;
+	}
+
+
+	/** Copy @p mr_avx2 rows of A as pairs of 16-bit integers, so the micro-kernel can broadcast 2 rows of the filter at
+	 * once.  Rows past the end of A are set to zero.
+	 */
+	static void pack_a_avx2(const int8_t * A, const int lda, const int i0, const int rows, const int Kp, int32_t * dst)
+	{
+		for (int p = 0; p < Kp / 2; ++p)
+		{
+			for (int r = 0; r < mr_avx2; ++r)
+			{
+				int32_t value = 0;
+				if (r < rows)
+				{
+					const int8_t * a = A + static_cast<size_t>(i0 + r) * lda + 2 * p;
+					value = static_cast<int32_t>(static_cast<uint16_t>(static_cast<int16_t>(a[0])) | (static_cast<uint32_t>(static_cast<uint16_t>(static_cast<int16_t>(a[1]))) << 16));
+				}
+				*dst++ = value;
+			}
+		}
+
+		return;
+	}
+
+
+	/// 8x16 micro-kernel:  8 ZMM accumulators, each one 16 columns for 1 row of C.
+	DARKNET_TARGET("avx2,avx512f,avx512bw,avx512vnni")
+	static void kernel_vnni_8x16(const int quads, const int8_t * const * a, const uint8_t * b, const int rows, const int cols, const int32_t * sums, const float * scales, float * c, const int ldc)
+	{
+		__m512i c0 = _mm512_setzero_si512();
+		__m512i c1 = _mm512_setzero_si512();
+		__m512i c2 = _mm512_setzero_si512();
+		__m512i c3 = _mm512_setzero_si512();
+		__m512i c4 = _mm512_setzero_si512();
+		__m512i c5 = _mm512_setzero_si512();
+		__m512i c6 = _mm512_setzero_si512();
+		__m512i c7 = _mm512_setzero_si512();
+
+		for (int q = 0; q < quads; ++q)
+		{
+			const __m512i b0 = _mm512_loadu_si512(b);
+			const int offset = 4 * q;
+
+			c0 = _mm512_dpbusd_epi32(c0, b0, _mm512_set1_epi32(load_quad(a[0] + offset)));
+			c1 = _mm512_dpbusd_epi32(c1, b0, _mm512_set1_epi32(load_quad(a[1] + offset)));
+			c2 = _mm512_dpbusd_epi32(c2, b0, _mm512_set1_epi32(load_quad(a[2] + offset)));
+			c3 = _mm512_dpbusd_epi32(c3, b0, _mm512_set1_epi32(load_quad(a[3] + offset)));
+			c4 = _mm512_dpbusd_epi32(c4, b0, _mm512_set1_epi32(load_quad(a[4] + offset)));
+			c5 = _mm512_dpbusd_epi32(c5, b0, _mm512_set1_epi32(load_quad(a[5] + offset)));
+			c6 = _mm512_dpbusd_epi32(c6, b0, _mm512_set1_epi32(load_quad(a[6] + offset)));
+			c7 = _mm512_dpbusd_epi32(c7, b0, _mm512_set1_epi32(load_quad(a[7] + offset)));
+
+			b += 4 * nr;
+		}
+
+		const __m512i acc[mr_vnni] = {c0, c1, c2, c3, c4, c5, c6, c7};
+		const __mmask16 mask = (cols == nr) ? 0xffff : static_cast<__mmask16>((1u << cols) - 1);
+
+		for (int r = 0; r < rows; ++r)
+		{
+			// remove the offset of 128 which was added to every value of B
+			const __m512i v = _mm512_sub_epi32(acc[r], _mm512_set1_epi32(128 * sums[r]));
+			_mm512_mask_storeu_ps(c + static_cast<size_t>(r) * ldc, mask, _mm512_mul_ps(_mm512_cvtepi32_ps(v), _mm512_set1_ps(scales[r])));
+		}
+
+		return;
+	}
+
+
+	/// 4x16 micro-kernel:  8 YMM accumulators, each one 8 columns for 1 row of C.
+	DARKNET_TARGET("avx2")
+	static void kernel_avx2_4x16(const int pairs, const int32_t * a, const int16_t * b, const int rows, const int cols, const float * scales, float * c, const int ldc)
+	{
+		__m256i c00 = _mm256_setzero_si256();	__m256i c01 = _mm256_setzero_si256();
+		__m256i c10 = _mm256_setzero_si256();	__m256i c11 = _mm256_setzero_si256();
+		__m256i c20 = _mm256_setzero_si256();	__m256i c21 = _mm256_setzero_si256();
+		__m256i c30 = _mm256_setzero_si256();	__m256i c31 = _mm256_setzero_si256();
+
+		for (int p = 0; p < pairs; ++p)
+		{
+			const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 0 ));
+			const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 16));
+
+			__m256i a0 = _mm256_set1_epi32(a[0]);
+			c00 = _mm256_add_epi32(c00, _mm256_madd_epi16(a0, b0));
+			c01 = _mm256_add_epi32(c01, _mm256_madd_epi16(a0, b1));
+			a0 = _mm256_set1_epi32(a[1]);
+			c10 = _mm256_add_epi32(c10, _mm256_madd_epi16(a0, b0));
+			c11 = _mm256_add_epi32(c11, _mm256_madd_epi16(a0, b1));
+			a0 = _mm256_set1_epi32(a[2]);
+			c20 = _mm256_add_epi32(c20, _mm256_madd_epi16(a0, b0));
+			c21 = _mm256_add_epi32(c21, _mm256_madd_epi16(a0, b1));
+			a0 = _mm256_set1_epi32(a[3]);
+			c30 = _mm256_add_epi32(c30, _mm256_madd_epi16(a0, b0));
+			c31 = _mm256_add_epi32(c31, _mm256_madd_epi16(a0, b1));
+
+			a += mr_avx2;
+			b += 2 * nr;
+		}
+
+		const __m256i acc[mr_avx2][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}};
+
+		for (int r = 0; r < rows; ++r)
+		{
+			const __m256 scale = _mm256_set1_ps(scales[r]);
+			float * dst = c + static_cast<size_t>(r) * ldc;
+
+			float tmp[nr];
+			float * out = (cols == nr) ? dst : tmp;
+			_mm256_storeu_ps(out + 0, _mm256_mul_ps(_mm256_cvtepi32_ps(acc[r][0]), scale));
+			_mm256_storeu_ps(out + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(acc[r][1]), scale));
+			if (out == tmp)
+			{
+				std::memcpy(dst, tmp, cols * sizeof(float));
+			}
+		}
+
+		return;
+	}
+
+
+	/// Multiply the rows @p "[m0, m1)" and columns @p "[n0, n1)" of C.  This is the work done by a single thread.
+	static void gemm_int8_block(const EInt8Kernel kernel, const int m0, const int m1, const int n0, const int n1, const int K, const int8_t * A, const int lda, const int32_t * A_sums, const float * A_scales, const float * B, const int ldb, const float B_scale, float * C, const int ldc, const GemmEpilogue * epilogue)
+	{
+		// every thread has its own packing buffers which are re-used from one call to the next
+		thread_local std::vector<uint8_t> packed_b_vnni;
+		thread_local std::vector<int16_t> packed_b_avx2;
+		thread_local std::vector<int32_t> packed_a_avx2;
+
+		const int Kp = (K + 3) / 4 * 4;
+		const size_t bytes_per_column = static_cast<size_t>(Kp) * (kernel == EInt8Kernel::kVNNI ? 1 : 2);
+		const int max_nc = std::max(nr, static_cast<int>(packed_b_bytes / bytes_per_column) / nr * nr);
+		const float inv_scale = 1.0f / B_scale;
+
+		if (kernel == EInt8Kernel::kVNNI)
+		{
+			packed_b_vnni.resize(static_cast<size_t>(max_nc + nr) * Kp);
+		}
+		else
+		{
+			packed_b_avx2.resize(static_cast<size_t>(max_nc + nr) * Kp);
+			packed_a_avx2.resize(static_cast<size_t>(mr_avx2) * Kp / 2);
+		}
+
+		for (int jc = n0; jc < n1; jc += max_nc)
+		{
+			const int nc = std::min(max_nc, n1 - jc);
+
+			if (kernel == EInt8Kernel::kVNNI)
+			{
+				pack_b_vnni(B, ldb, K, Kp, jc, nc, inv_scale, packed_b_vnni.data());
+
+				for (int ir = m0; ir < m1; ir += mr_vnni)
+				{
+					const int rows = std::min(mr_vnni, m1 - ir);
+
+					// rows past the end of A re-use the last row, but are never written to C
+					const int8_t * a[mr_vnni];
+					float scales[mr_vnni];
+					for (int r = 0; r < mr_vnni; ++r)
+					{
+						const int row = ir + std::min(r, rows - 1);
+						a[r] = A + static_cast<size_t>(row) * lda;
+						scales[r] = A_scales[row] * B_scale;
+					}
+
+					for (int jr = 0; jr < nc; jr += nr)
+					{
+						const int cols = std::min(nr, nc - jr);
+						const uint8_t * b = packed_b_vnni.data() + static_cast<size_t>(jr) * Kp;
+						float * c = C + static_cast<size_t>(ir) * ldc + jc + jr;
+						kernel_vnni_8x16(Kp / 4, a, b, rows, cols, A_sums + ir, scales, c, ldc);
+						if (epilogue)
+						{
+							apply_gemm_epilogue(*epilogue, ir, jc + jr, rows, cols, c, ldc);
+						}
+					}
+				}
+			}
+			else
+			{
+				pack_b_avx2(B, ldb, K, Kp, jc, nc, inv_scale, packed_b_avx2.data());
+
+				for (int ir = m0; ir < m1; ir += mr_avx2)
+				{
+					const int rows = std::min(mr_avx2, m1 - ir);
+					pack_a_avx2(A, lda, ir, rows, Kp, packed_a_avx2.data());
+
+					float scales[mr_avx2];
+					for (int r = 0; r < rows; ++r)
+					{
+						scales[r] = A_scales[ir + r] * B_scale;
+					}
+
+					for (int jr = 0; jr < nc; jr += nr)
+					{
+						const int cols = std::min(nr, nc - jr);
+						const int16_t * b = packed_b_avx2.data() + static_cast<size_t>(jr) * Kp;
+						float * c = C + static_cast<size_t>(ir) * ldc + jc + jr;
+						kernel_avx2_4x16(Kp / 2, packed_a_avx2.data(), b, rows, cols, scales, c, ldc);
+						if (epilogue)
+						{
+							apply_gemm_epilogue(*epilogue, ir, jc + jr, rows, cols, c, ldc);
+						}
+					}
+				}
+			}
+		}
+
+		return;
+	}
+#endif
+}
+
+
+void gemm_int8(int M, int N, int K,
+		const int8_t *A, int lda, const int32_t *A_sums, const float *A_scales,
+		const float *B, int ldb, float B_scale,
+		float *C, int ldc,
+		const GemmEpilogue * epilogue)
+{
+	TAT(TATPARMS);
+
+	if (M <= 0 or N <= 0 or K <= 0)
+	{
+		return;
+	}
+
+	if (lda % 4 != 0 or lda < K)
+	{
+		darknet_fatal_error(DARKNET_LOC, "gemm_int8() requires the rows of A to be padded to a multiple of 4 (K=%d, lda=%d)", K, lda);
+	}
+
+	static const EInt8Kernel kernel = []()
+	{
+#ifdef DARKNET_GEMM_INT8
+		if (is_avx512_vnni() == 1)
+		{
+			return EInt8Kernel::kVNNI;
+		}
+		if (is_fma_avx2() == 1)
+		{
+			return EInt8Kernel::kAVX2;
+		}
+#endif
+		return EInt8Kernel::kScalar;
+	}();
+
+	const int mr = (kernel == EInt8Kernel::kVNNI ? mr_vnni : mr_avx2);
+
+	// same as gemm_packed():  split the columns of C between the threads whenever there are enough of them
+	#pragma omp parallel
+	{
+		int thread_id	= 0;
+		int threads		= 1;
+		#ifdef DARKNET_OPENMP
+		thread_id		= omp_get_thread_num();
+		threads			= omp_get_num_threads();
+		#endif
+
+		int m0 = 0;
+		int m1 = M;
+		int n0 = 0;
+		int n1 = N;
+		if (N >= M or N >= threads * nr * 4)
+		{
+			const int chunk = (N / threads + nr) / nr * nr;
+			n0 = std::min(N, thread_id * chunk);
+			n1 = std::min(N, n0 + chunk);
+		}
+		else
+		{
+			const int chunk = (M / threads + mr) / mr * mr;
+			m0 = std::min(M, thread_id * chunk);
+			m1 = std::min(M, m0 + chunk);
+		}
+
+		if (m0 < m1 and n0 < n1)
+		{
+#ifdef DARKNET_GEMM_INT8
+			if (kernel != EInt8Kernel::kScalar)
+			{
+				gemm_int8_block(kernel, m0, m1, n0, n1, K, A, lda, A_sums, A_scales, B, ldb, B_scale, C, ldc, epilogue);
+			}
+			else
+#endif
+			{
+				gemm_int8_block_scalar(m0, m1, n0, n1, K, A, lda, A_scales, B, ldb, B_scale, C, ldc, epilogue);
+			}
+		}
+	}
+
+	return;
+}
@@ -0,0 +1,463 @@
+/** @file
+ * Cache-blocked and register-tiled matrix multiplication for the CPU.  See @ref gemm_packed().
+ *
+ * The loops follow the usual GotoBLAS/BLIS layout:
+ *
+ * ~~~~.txt
+ *     for jc in N, step NC          <- B block is kept in L3
+ *         for pc in K, step KC      <- pack B[pc:pc+KC, jc:jc+NC] into NR-wide panels
+ *             for ic in M, step MC  <- pack A[ic:ic+MC, pc:pc+KC] into MR-tall panels, kept in L2
+ *                 for jr in NC, step NR
+ *                     for ir in MC, step MR
+ *                         micro-kernel: C[MR x NR] += A panel * B panel, with C held in registers
+ * ~~~~
+ */
+
+#include "gemm.hpp"
+
+#ifdef DARKNET_OPENMP
+#include <omp.h>
+#endif
+
+#if (defined(__AVX__) && defined(__x86_64__)) || (defined(_WIN64) && !defined(__MINGW32__) && !defined(_M_ARM64))
+#define DARKNET_GEMM_PACKED
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+/// The AVX-512 and FMA micro-kernels are compiled for those instructions even when the rest of %Darknet is not.
+#define DARKNET_TARGET(x) __attribute__((target(x)))
+#else
+#define DARKNET_TARGET(x)
+#endif
+#endif
+
+
+#ifdef DARKNET_GEMM_PACKED
+namespace
+{
+	/// Accumulate @p "C[MR x NR] += A panel * B panel" over @p k.  Both panels have already been packed.
+	using MicroKernel = void(*)(const int k, const float * a, const float * b, float * c, const int ldc);
+
+
+	/// Everything needed to run one of the micro-kernels, including the cache blocking that goes with it.
+	struct GemmKernel
+	{
+		int mr;	///< rows of C computed by the micro-kernel
+		int nr;	///< columns of C computed by the micro-kernel
+		int mc;	///< rows of A packed at once (L2)
+		int kc;	///< depth of the packed panels (L1)
+		int nc;	///< columns of B packed at once (L3)
+		MicroKernel kernel;
+	};
+
+
+	/// 6x16 micro-kernel:  12 YMM accumulators, 2 YMM for B, and 1 YMM for the broadcast of A.
+	DARKNET_TARGET("avx2,fma")
+	static void kernel_avx2_6x16(const int k, const float * a, const float * b, float * c, const int ldc)
+	{
+		__m256 c00 = _mm256_setzero_ps();	__m256 c01 = _mm256_setzero_ps();
+		__m256 c10 = _mm256_setzero_ps();	__m256 c11 = _mm256_setzero_ps();
+		__m256 c20 = _mm256_setzero_ps();	__m256 c21 = _mm256_setzero_ps();
+		__m256 c30 = _mm256_setzero_ps();	__m256 c31 = _mm256_setzero_ps();
+		__m256 c40 = _mm256_setzero_ps();	__m256 c41 = _mm256_setzero_ps();
+		__m256 c50 = _mm256_setzero_ps();	__m256 c51 = _mm256_setzero_ps();
+
+		for (int p = 0; p < k; ++p)
+		{
+			const __m256 b0 = _mm256_loadu_ps(b);
+			const __m256 b1 = _mm256_loadu_ps(b + 8);
+
+			__m256 a0 = _mm256_broadcast_ss(a + 0);
+			c00 = _mm256_fmadd_ps(a0, b0, c00);
+			c01 = _mm256_fmadd_ps(a0, b1, c01);
+			a0 = _mm256_broadcast_ss(a + 1);
+			c10 = _mm256_fmadd_ps(a0, b0, c10);
+			c11 = _mm256_fmadd_ps(a0, b1, c11);
+			a0 = _mm256_broadcast_ss(a + 2);
+			c20 = _mm256_fmadd_ps(a0, b0, c20);
+			c21 = _mm256_fmadd_ps(a0, b1, c21);
+			a0 = _mm256_broadcast_ss(a + 3);
+			c30 = _mm256_fmadd_ps(a0, b0, c30);
+			c31 = _mm256_fmadd_ps(a0, b1, c31);
+			a0 = _mm256_broadcast_ss(a + 4);
+			c40 = _mm256_fmadd_ps(a0, b0, c40);
+			c41 = _mm256_fmadd_ps(a0, b1, c41);
+			a0 = _mm256_broadcast_ss(a + 5);
+			c50 = _mm256_fmadd_ps(a0, b0, c50);
+			c51 = _mm256_fmadd_ps(a0, b1, c51);
+
+			a += 6;
+			b += 16;
+		}
+
+		float * c0 = c;
+		_mm256_storeu_ps(c0, _mm256_add_ps(_mm256_loadu_ps(c0), c00));	_mm256_storeu_ps(c0 + 8, _mm256_add_ps(_mm256_loadu_ps(c0 + 8), c01));	c0 += ldc;
+		_mm256_storeu_ps(c0, _mm256_add_ps(_mm256_loadu_ps(c0), c10));	_mm256_storeu_ps(c0 + 8, _mm256_add_ps(_mm256_loadu_ps(c0 + 8), c11));	c0 += ldc;
+		_mm256_storeu_ps(c0, _mm256_add_ps(_mm256_loadu_ps(c0), c20));	_mm256_storeu_ps(c0 + 8, _mm256_add_ps(_mm256_loadu_ps(c0 + 8), c21));	c0 += ldc;
+		_mm256_storeu_ps(c0, _mm256_add_ps(_mm256_loadu_ps(c0), c30));	_mm256_storeu_ps(c0 + 8, _mm256_add_ps(_mm256_loadu_ps(c0 + 8), c31));	c0 += ldc;
+		_mm256_storeu_ps(c0, _mm256_add_ps(_mm256_loadu_ps(c0), c40));	_mm256_storeu_ps(c0 + 8, _mm256_add_ps(_mm256_loadu_ps(c0 + 8), c41));	c0 += ldc;
+		_mm256_storeu_ps(c0, _mm256_add_ps(_mm256_loadu_ps(c0), c50));	_mm256_storeu_ps(c0 + 8, _mm256_add_ps(_mm256_loadu_ps(c0 + 8), c51));
+	}
+
+
+	/// 8x32 micro-kernel:  16 ZMM accumulators, 2 ZMM for B, and 1 ZMM for the broadcast of A.
+	DARKNET_TARGET("avx512f")
+	static void kernel_avx512_8x32(const int k, const float * a, const float * b, float * c, const int ldc)
+	{
+		// the accumulators are written out one by one since an array of __m512 is not always kept in registers
+		__m512 c00 = _mm512_setzero_ps();	__m512 c01 = _mm512_setzero_ps();
+		__m512 c10 = _mm512_setzero_ps();	__m512 c11 = _mm512_setzero_ps();
+		__m512 c20 = _mm512_setzero_ps();	__m512 c21 = _mm512_setzero_ps();
+		__m512 c30 = _mm512_setzero_ps();	__m512 c31 = _mm512_setzero_ps();
+		__m512 c40 = _mm512_setzero_ps();	__m512 c41 = _mm512_setzero_ps();
+		__m512 c50 = _mm512_setzero_ps();	__m512 c51 = _mm512_setzero_ps();
+		__m512 c60 = _mm512_setzero_ps();	__m512 c61 = _mm512_setzero_ps();
+		__m512 c70 = _mm512_setzero_ps();	__m512 c71 = _mm512_setzero_ps();
+
+		for (int p = 0; p < k; ++p)
+		{
+			const __m512 b0 = _mm512_loadu_ps(b);
+			const __m512 b1 = _mm512_loadu_ps(b + 16);
+
+			__m512 a0 = _mm512_set1_ps(a[0]);
+			c00 = _mm512_fmadd_ps(a0, b0, c00);
+			c01 = _mm512_fmadd_ps(a0, b1, c01);
+			a0 = _mm512_set1_ps(a[1]);
+			c10 = _mm512_fmadd_ps(a0, b0, c10);
+			c11 = _mm512_fmadd_ps(a0, b1, c11);
+			a0 = _mm512_set1_ps(a[2]);
+			c20 = _mm512_fmadd_ps(a0, b0, c20);
+			c21 = _mm512_fmadd_ps(a0, b1, c21);
+			a0 = _mm512_set1_ps(a[3]);
+			c30 = _mm512_fmadd_ps(a0, b0, c30);
+			c31 = _mm512_fmadd_ps(a0, b1, c31);
+			a0 = _mm512_set1_ps(a[4]);
+			c40 = _mm512_fmadd_ps(a0, b0, c40);
+			c41 = _mm512_fmadd_ps(a0, b1, c41);
+			a0 = _mm512_set1_ps(a[5]);
+			c50 = _mm512_fmadd_ps(a0, b0, c50);
+			c51 = _mm512_fmadd_ps(a0, b1, c51);
+			a0 = _mm512_set1_ps(a[6]);
+			c60 = _mm512_fmadd_ps(a0, b0, c60);
+			c61 = _mm512_fmadd_ps(a0, b1, c61);
+			a0 = _mm512_set1_ps(a[7]);
+			c70 = _mm512_fmadd_ps(a0, b0, c70);
+			c71 = _mm512_fmadd_ps(a0, b1, c71);
+
+			a += 8;
+			b += 32;
+		}
+
+		float * c0 = c;
+		_mm512_storeu_ps(c0, _mm512_add_ps(_mm512_loadu_ps(c0), c00));	_mm512_storeu_ps(c0 + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + 16), c01));	c0 += ldc;
+		_mm512_storeu_ps(c0, _mm512_add_ps(_mm512_loadu_ps(c0), c10));	_mm512_storeu_ps(c0 + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + 16), c11));	c0 += ldc;
+		_mm512_storeu_ps(c0, _mm512_add_ps(_mm512_loadu_ps(c0), c20));	_mm512_storeu_ps(c0 + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + 16), c21));	c0 += ldc;
+		_mm512_storeu_ps(c0, _mm512_add_ps(_mm512_loadu_ps(c0), c30));	_mm512_storeu_ps(c0 + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + 16), c31));	c0 += ldc;
+		_mm512_storeu_ps(c0, _mm512_add_ps(_mm512_loadu_ps(c0), c40));	_mm512_storeu_ps(c0 + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + 16), c41));	c0 += ldc;
+		_mm512_storeu_ps(c0, _mm512_add_ps(_mm512_loadu_ps(c0), c50));	_mm512_storeu_ps(c0 + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + 16), c51));	c0 += ldc;
+		_mm512_storeu_ps(c0, _mm512_add_ps(_mm512_loadu_ps(c0), c60));	_mm512_storeu_ps(c0 + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + 16), c61));	c0 += ldc;
+		_mm512_storeu_ps(c0, _mm512_add_ps(_mm512_loadu_ps(c0), c70));	_mm512_storeu_ps(c0 + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + 16), c71));
+	}
+
+
+	/** The block sizes keep one @p KC x @p NR panel of B in L1 (16 KiB or 32 KiB), the @p MC x @p KC block of A in L2,
+	 * and the @p KC x @p NC block of B in L3.
+	 */
+	static const GemmKernel avx2_kernel		= {6, 16,  72, 256, 4080, kernel_avx2_6x16};
+	static const GemmKernel avx512_kernel	= {8, 32, 128, 256, 4096, kernel_avx512_8x32};
+
+
+	/// Copy @p "ALPHA * A[i0:i0+mc, k0:k0+kc]" into panels of @p mr rows, padding the last panel with zeros.
+	static void pack_a(const int TA, const float * A, const int lda, const int i0, const int k0, const int mc, const int kc, const float ALPHA, const int mr, float * dst)
+	{
+		for (int ir = 0; ir < mc; ir += mr)
+		{
+			const int rows = std::min(mr, mc - ir);
+			for (int p = 0; p < kc; ++p)
+			{
+				for (int r = 0; r < rows; ++r)
+				{
+					const int i = i0 + ir + r;
+					const int k = k0 + p;
+					dst[r] = ALPHA * (TA ? A[k * lda + i] : A[i * lda + k]);
+				}
+				for (int r = rows; r < mr; ++r)
+				{
+					dst[r] = 0.0f;
+				}
+				dst += mr;
+			}
+		}
+	}
+
+
+	/// Copy @p "B[k0:k0+kc, j0:j0+nc]" into panels of @p nr columns, padding the last panel with zeros.
+	static void pack_b(const int TB, const float * B, const int ldb, const int k0, const int j0, const int kc, const int nc, const int nr, float * dst)
+	{
+		for (int jr = 0; jr < nc; jr += nr)
+		{
+			const int cols = std::min(nr, nc - jr);
+			for (int p = 0; p < kc; ++p)
+			{
+				const int k = k0 + p;
+				if (TB == 0)
+				{
+					// rows of B are contiguous, which is the usual case for convolutions (B is the output of im2col)
+					std::memcpy(dst, B + static_cast<size_t>(k) * ldb + j0 + jr, cols * sizeof(float));
+				}
+				else
+				{
+					for (int c = 0; c < cols; ++c)
+					{
+						dst[c] = B[static_cast<size_t>(j0 + jr + c) * ldb + k];
+					}
+				}
+				for (int c = cols; c < nr; ++c)
+				{
+					dst[c] = 0.0f;
+				}
+				dst += nr;
+			}
+		}
+	}
+
+
+	/** Add the bias to one row of C and apply a leaky, relu, or linear activation, 8 columns at a time.  @p bias points
+	 * to one value per column when @p per_column is set, otherwise to a single value used for the whole row.
+	 */
+	DARKNET_TARGET("avx2,fma")
+	static void epilogue_row_avx2(const float * bias, const bool per_column, const float slope, const int cols, float * c)
+	{
+		const __m256 s = _mm256_set1_ps(slope);
+		int col = 0;
+		for (; col + 8 <= cols; col += 8)
+		{
+			const __m256 b = per_column ? _mm256_loadu_ps(bias + col) : _mm256_set1_ps(*bias);
+			const __m256 x = _mm256_add_ps(_mm256_loadu_ps(c + col), b);
+			// max(x, slope * x) works for leaky (slope=0.1), relu (slope=0), and linear (slope=1)
+			_mm256_storeu_ps(c + col, _mm256_max_ps(x, _mm256_mul_ps(x, s)));
+		}
+		for (; col < cols; ++col)
+		{
+			const float x = c[col] + (per_column ? bias[col] : *bias);
+			c[col] = std::max(x, slope * x);
+		}
+	}
+
+
+	/// Multiply the rows @p "[m0, m1)" and columns @p "[n0, n1)" of C.  This is the work done by a single thread.
+	static void gemm_packed_block(const GemmKernel & gk, const int TA, const int TB, const int m0, const int m1, const int n0, const int n1, const int K, const float ALPHA, const float * A, const int lda, const float * B, const int ldb, float * C, const int ldc, const GemmEpilogue * epilogue)
+	{
+		// every thread has its own packing buffers which are re-used from one call to the next
+		thread_local std::vector<float> packed_a;
+		thread_local std::vector<float> packed_b;
+		thread_local std::vector<float> edge;
+
+		const int mr = gk.mr;
+		const int nr = gk.nr;
+
+		packed_a.resize(static_cast<size_t>(gk.mc + mr) * gk.kc);
+		packed_b.resize(static_cast<size_t>(gk.nc + nr) * gk.kc);
+		edge.resize(static_cast<size_t>(mr) * nr);
+
+		for (int jc = n0; jc < n1; jc += gk.nc)
+		{
+			const int nc = std::min(gk.nc, n1 - jc);
+
+			for (int pc = 0; pc < K; pc += gk.kc)
+			{
+				const int kc = std::min(gk.kc, K - pc);
+				const bool last_block = (pc + kc >= K);
+
+				pack_b(TB, B, ldb, pc, jc, kc, nc, nr, packed_b.data());
+
+				for (int ic = m0; ic < m1; ic += gk.mc)
+				{
+					const int mc = std::min(gk.mc, m1 - ic);
+
+					pack_a(TA, A, lda, ic, pc, mc, kc, ALPHA, mr, packed_a.data());
+
+					for (int jr = 0; jr < nc; jr += nr)
+					{
+						const int cols = std::min(nr, nc - jr);
+						const float * b = packed_b.data() + static_cast<size_t>(jr) * kc;
+
+						for (int ir = 0; ir < mc; ir += mr)
+						{
+							const int rows = std::min(mr, mc - ir);
+							const float * a = packed_a.data() + static_cast<size_t>(ir) * kc;
+							float * c = C + static_cast<size_t>(ic + ir) * ldc + jc + jr;
+
+							if (rows == mr and cols == nr)
+							{
+								gk.kernel(kc, a, b, c, ldc);
+							}
+							else
+							{
+								// partial tile at the edge of C
+								std::fill(edge.begin(), edge.end(), 0.0f);
+								gk.kernel(kc, a, b, edge.data(), nr);
+								for (int r = 0; r < rows; ++r)
+								{
+									for (int col = 0; col < cols; ++col)
+									{
+										c[r * ldc + col] += edge[r * nr + col];
+									}
+								}
+							}
+
+							if (epilogue and last_block)
+							{
+								// the tile is complete and still in L1, so this is the cheapest time to finish it
+								apply_gemm_epilogue(*epilogue, ic + ir, jc + jr, rows, cols, c, ldc);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+#endif
+
+
+bool gemm_packed_is_supported()
+{
+	TAT(TATPARMS);
+
+#ifdef DARKNET_GEMM_PACKED
+	static const bool supported = (is_fma_avx2() == 1);
+	return supported;
+#else
+	return false;
+#endif
+}
+
+
+bool gemm_epilogue_supports(const ACTIVATION activation)
+{
+	TAT(TATPARMS);
+
+	switch (activation)
+	{
+		case LINEAR:
+		case LEAKY:
+		case RELU:
+		case LOGISTIC:
+		case SWISH:
+		case MISH:
+		case HARD_MISH:
+			return true;
+		default:
+			return false;
+	}
+}
+
+
+void apply_gemm_epilogue(const GemmEpilogue & epilogue, const int m, const int n, const int rows, const int cols, float * C, const int ldc)
+{
+	TAT(TATPARMS);
+
+	const bool per_column = (epilogue.bias and epilogue.bias_per_column);
+
+	for (int r = 0; r < rows; ++r)
+	{
+		const float row_bias = (epilogue.bias and not per_column) ? epilogue.bias[m + r] : 0.0f;
+		const float * bias = per_column ? epilogue.bias + n : &row_bias;
+		float * c = C + static_cast<size_t>(r) * ldc;
+
+#ifdef DARKNET_GEMM_PACKED
+		if (gemm_packed_is_supported() and (epilogue.activation == LINEAR or epilogue.activation == LEAKY or epilogue.activation == RELU))
+		{
+			const float slope = (epilogue.activation == LINEAR ? 1.0f : epilogue.activation == LEAKY ? 0.1f : 0.0f);
+			epilogue_row_avx2(bias, per_column, slope, cols, c);
+			continue;
+		}
+#endif
+
+		for (int col = 0; col < cols; ++col)
+		{
+			c[col] += (per_column ? bias[col] : row_bias);
+		}
+
+		switch (epilogue.activation)
+		{
+			case LINEAR:	break;
+			case LEAKY:		for (int col = 0; col < cols; ++col) { c[col] = leaky_activate		(c[col]); } break;
+			case RELU:		for (int col = 0; col < cols; ++col) { c[col] = relu_activate		(c[col]); } break;
+			case LOGISTIC:	for (int col = 0; col < cols; ++col) { c[col] = logistic_activate	(c[col]); } break;
+			case SWISH:		for (int col = 0; col < cols; ++col) { c[col] = swish_activate		(c[col]); } break;
+			case MISH:		for (int col = 0; col < cols; ++col) { c[col] = mish_activate		(c[col]); } break;
+			case HARD_MISH:	for (int col = 0; col < cols; ++col) { c[col] = hard_mish_activate	(c[col]); } break;
+			default:
+				darknet_fatal_error(DARKNET_LOC, "activation %d is not supported by the GEMM epilogue", static_cast<int>(epilogue.activation));
+		}
+	}
+
+	return;
+}
+
+
+void gemm_packed(int TA, int TB, int M, int N, int K, float ALPHA,
+		const float *A, int lda,
+		const float *B, int ldb,
+		float *C, int ldc,
+		const bool allow_avx512,
+		const GemmEpilogue * epilogue)
+{
+	TAT(TATPARMS);
+
+	if (M <= 0 or N <= 0 or K <= 0)
+	{
+		return;
+	}
+
+#ifdef DARKNET_GEMM_PACKED
+	if (not gemm_packed_is_supported())
+	{
+		darknet_fatal_error(DARKNET_LOC, "gemm_packed() requires a CPU with AVX2 and FMA");
+	}
+
+	static const bool use_avx512 = (is_avx512() == 1);
+	const GemmKernel & gk = (use_avx512 and allow_avx512) ? avx512_kernel : avx2_kernel;
+
+	/* Split C between the threads.  Convolutions usually have few rows (filters) and many columns (output pixels), so
+	 * the columns are split whenever there are enough of them.  Each thread packs its own copy of A, which is cheap
+	 * compared to the multiplication.
+	 */
+	#pragma omp parallel
+	{
+		int thread_id	= 0;
+		int threads		= 1;
+		#ifdef DARKNET_OPENMP
+		thread_id		= omp_get_thread_num();
+		threads			= omp_get_num_threads();
+		#endif
+
+		if (N >= M or N >= threads * gk.nr * 4)
+		{
+			const int chunk = (N / threads + gk.nr) / gk.nr * gk.nr;
+			const int n0 = std::min(N, thread_id * chunk);
+			const int n1 = std::min(N, n0 + chunk);
+			if (n0 < n1)
+			{
+				gemm_packed_block(gk, TA, TB, 0, M, n0, n1, K, ALPHA, A, lda, B, ldb, C, ldc, epilogue);
+			}
+		}
+		else
+		{
+			const int chunk = (M / threads + gk.mr) / gk.mr * gk.mr;
+			const int m0 = std::min(M, thread_id * chunk);
+			const int m1 = std::min(M, m0 + chunk);
+			if (m0 < m1)
+			{
+				gemm_packed_block(gk, TA, TB, m0, m1, 0, N, K, ALPHA, A, lda, B, ldb, C, ldc, epilogue);
+			}
+		}
+	}
+#else
+	darknet_fatal_error(DARKNET_LOC, "gemm_packed() is not available on this platform");
+#endif
+
+	return;
+}
@@ -32,10 +32,157 @@
 namespace
 {
 	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// Get the OpenCV flag needed to decode an image with the given number of channels.
+	static cv::ImreadModes get_imread_flag(const std::string & filename, const int channels)
+	{
+		TAT(TATPARMS);
+
+		auto flag = cv::IMREAD_UNCHANGED;
+
+		if (channels == 1)
+		{
+			flag = cv::IMREAD_GRAYSCALE;
+		}
+		else if (channels == 3)
+		{
+			flag = cv::IMREAD_COLOR;
+		}
+		else if (channels != 0)
+		{
+			darknet_fatal_error(DARKNET_LOC, "OpenCV cannot load an image with %d channels: %s", channels, filename.c_str());
+		}
+
+		return flag;
+	}
+
+
+	/** Get the dimensions of a JPEG image from the "start of frame" header, without decoding the image.
+	 *
+	 * @returns @p false if this is not a JPEG image or if the header cannot be found.
+	 */
+	static bool get_jpeg_size(const uint8_t * data, const size_t size, int & width, int & height)
+	{
+		TAT(TATPARMS);
+
+		if (size < 4 or data[0] != 0xFF or data[1] != 0xD8)
+		{
+			return false;
+		}
+
+		size_t pos = 2;
+		while (pos + 4 <= size)
+		{
+			if (data[pos] != 0xFF)
+			{
+				return false;
+			}
+
+			const uint8_t marker = data[pos + 1];
+			if (marker == 0xFF)
+			{
+				// fill byte
+				pos ++;
+				continue;
+			}
+
+			if (marker == 0x01 or (marker >= 0xD0 and marker <= 0xD9))
+			{
+				// markers without a length
+				pos += 2;
+				continue;
+			}
+
+			// SOF0 to SOF15, but not DHT (0xC4), JPG (0xC8), or DAC (0xCC) which share the same range
+			if (marker >= 0xC0 and marker <= 0xCF and marker != 0xC4 and marker != 0xC8 and marker != 0xCC)
+			{
+				if (pos + 9 > size)
+				{
+					return false;
+				}
+
+				height	= (data[pos + 5] << 8) | data[pos + 6];
+				width	= (data[pos + 7] << 8) | data[pos + 8];
+
+				return width > 0 and height > 0;
+			}
+
+			const size_t length = (data[pos + 2] << 8) | data[pos + 3];
+			pos += 2 + length;
+		}
+
+		return false;
+	}
+
+
+	/** If the image is a JPEG which is much larger than needed, then libjpeg can decode it directly at 1/2, 1/4, or 1/8
+	 * of the size by skipping the high-frequency DCT coefficients, which is several times faster than decoding the full
+	 * image.  The reduced image is never smaller than @p min_width x @p min_height in either orientation, since the EXIF
+	 * orientation may rotate the image once it has been decoded.
+	 *
+	 * @returns the @p cv::IMREAD_REDUCED_... flag to use, or @p flag if the image should be decoded at full size.
+	 */
+	static int get_reduced_imread_flag(const void * encoded, const size_t size, const int flag, const int min_width, const int min_height)
+	{
+		TAT(TATPARMS);
+
+		if (min_width <= 0 or min_height <= 0 or (flag != cv::IMREAD_COLOR and flag != cv::IMREAD_GRAYSCALE))
+		{
+			return flag;
+		}
+
+		int width	= 0;
+		int height	= 0;
+		if (not get_jpeg_size(static_cast<const uint8_t*>(encoded), size, width, height))
+		{
+			return flag;
+		}
+
+		const int shortest_side	= std::min(width, height);
+		const int needed		= std::max(min_width, min_height);
+
+		if (shortest_side / 8 >= needed)
+		{
+			return (flag == cv::IMREAD_COLOR) ? cv::IMREAD_REDUCED_COLOR_8 : cv::IMREAD_REDUCED_GRAYSCALE_8;
+		}
+		if (shortest_side / 4 >= needed)
+		{
+			return (flag == cv::IMREAD_COLOR) ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_GRAYSCALE_4;
+		}
+		if (shortest_side / 2 >= needed)
+		{
+			return (flag == cv::IMREAD_COLOR) ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_REDUCED_GRAYSCALE_2;
+		}
+
+		return flag;
+	}
+
+
+	/// OpenCV decodes images as BGR, but Darknet expects RGB.
+	static void convert_to_rgb(cv::Mat & mat, const int channels)
+	{
+		TAT(TATPARMS);
+
+		if (mat.channels() == 3)
+		{
+			cv::cvtColor(mat, mat, cv::COLOR_BGR2RGB);
+		}
+		else if (mat.channels() == 4 and channels == 3)
+		{
+			cv::cvtColor(mat, mat, cv::COLOR_BGRA2RGB);
+		}
+		else if (mat.channels() == 4)
+		{
+			cv::cvtColor(mat, mat, cv::COLOR_BGRA2RGBA);
+		}
+
+		return;
+	}
 }
 
 
-cv::Mat load_rgb_mat_image(const std::string & filename, int channels)
+cv::Mat load_rgb_mat_image(const std::string & filename, int channels, const int min_width, const int min_height)
 {
 	TAT(TATPARMS);
 
@@ -44,19 +191,22 @@ cv::Mat load_rgb_mat_image(const std::string & filename, int channels)
 		darknet_fatal_error(DARKNET_LOC, "cannot load an image without a filename");
 	}
 
-	auto flag = cv::IMREAD_UNCHANGED;
+	const auto flag = get_imread_flag(filename, channels);
 
-	if (channels == 1)
-	{
-		flag = cv::IMREAD_GRAYSCALE;
-	}
-	else if (channels == 3)
-	{
-		flag = cv::IMREAD_COLOR;
-	}
-	else if (channels != 0)
+	if (min_width > 0 and min_height > 0 and flag != cv::IMREAD_UNCHANGED)
 	{
-		darknet_fatal_error(DARKNET_LOC, "OpenCV cannot load an image with %d channels: %s", channels, filename.c_str());
+		// read the file ourself so the size of the image can be checked before it is decoded
+		std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+		const auto size = ifs.tellg();
+		if (ifs.good() and size > 0)
+		{
+			std::vector<uint8_t> buffer(static_cast<size_t>(size));
+			ifs.seekg(0);
+			if (ifs.read(reinterpret_cast<char*>(buffer.data()), size))
+			{
+				return decode_rgb_mat_image(buffer.data(), buffer.size(), filename, channels, min_width, min_height);
+			}
+		}
 	}
 
 	cv::Mat mat = cv::imread(filename, flag);
@@ -65,19 +215,29 @@ cv::Mat load_rgb_mat_image(const std::string & filename, int channels)
 		darknet_fatal_error(DARKNET_LOC, "failed to load image file \"%s\"", filename.c_str());
 	}
 
-	if (mat.channels() == 3)
-	{
-		cv::cvtColor(mat, mat, cv::COLOR_BGR2RGB);
-	}
-	else if (mat.channels() == 4 and channels == 3)
-	{
-		cv::cvtColor(mat, mat, cv::COLOR_BGRA2RGB);
-	}
-	else if (mat.channels() == 4)
+	convert_to_rgb(mat, channels);
+
+	return mat;
+}
+
+
+cv::Mat decode_rgb_mat_image(const void * encoded, const size_t size, const std::string & filename, int channels, const int min_width, const int min_height)
+{
+	TAT(TATPARMS);
+
+	const int flag = get_reduced_imread_flag(encoded, size, get_imread_flag(filename, channels), min_width, min_height);
+
+	// wrap the encoded bytes without copying them
+	const cv::Mat buffer(1, static_cast<int>(size), CV_8UC1, const_cast<void*>(encoded));
+
+	cv::Mat mat = cv::imdecode(buffer, flag);
+	if (mat.empty())
 	{
-		cv::cvtColor(mat, mat, cv::COLOR_BGRA2RGBA);
+		darknet_fatal_error(DARKNET_LOC, "failed to decode image \"%s\"", filename.c_str());
 	}
 
+	convert_to_rgb(mat, channels);
+
 	return mat;
 }
 
@@ -285,8 +445,375 @@ void draw_detections_cv_v3(cv::Mat mat, Darknet::Detection * dets, int num, floa
 // ====================================================================
 
 
+namespace
+{
+	/// Optional blur and gaussian noise applied at the end of the augmentation.  Both work on 8-bit images.
+	static void blur_and_noise(cv::Mat & sized, int gaussian_noise, int blur, int num_boxes, int truth_size, float *truth)
+	{
+		TAT(TATPARMS);
+
+		if (blur)
+		{
+			cv::Mat dst(sized.size(), sized.type());
+			if (blur == 1)
+			{
+				cv::GaussianBlur(sized, dst, cv::Size(17, 17), 0);
+				//cv::bilateralFilter(sized, dst, 17, 75, 75);
+			}
+			else
+			{
+				int ksize = (blur / 2) * 2 + 1;
+				cv::Size kernel_size = cv::Size(ksize, ksize);
+				cv::GaussianBlur(sized, dst, kernel_size, 0);
+				//cv::medianBlur(sized, dst, ksize);
+				//cv::bilateralFilter(sized, dst, ksize, 75, 75);
+
+				// sharpen
+				//cv::Mat img_tmp;
+				//cv::GaussianBlur(dst, img_tmp, cv::Size(), 3);
+				//cv::addWeighted(dst, 1.5, img_tmp, -0.5, 0, img_tmp);
+				//dst = img_tmp;
+			}
+			//*cfg_and_state.output << " blur num_boxes = " << num_boxes << std::endl;
+
+			if (blur == 1)
+			{
+				cv::Rect r(0, 0, sized.cols, sized.rows);
+				for (int t = 0; t < num_boxes; ++t)
+				{
+					Darknet::Box b = float_to_box_stride(truth + t*truth_size, 1);
+					if (!b.x) break;
+					int left = (b.x - b.w / 2.)*sized.cols;
+					int width = b.w*sized.cols;
+					int top = (b.y - b.h / 2.)*sized.rows;
+					int height = b.h*sized.rows;
+					cv::Rect roi(left, top, width, height);
+					roi = roi & r;
+
+					sized(roi).copyTo(dst(roi));
+				}
+			}
+			dst.copyTo(sized);
+		}
+
+		if (gaussian_noise)
+		{
+			cv::Mat noise = cv::Mat(sized.size(), sized.type());
+			gaussian_noise = std::min(gaussian_noise, 127);
+			gaussian_noise = std::max(gaussian_noise, 0);
+			cv::randn(noise, 0, gaussian_noise);  //mean and variance
+			cv::Mat sized_norm = sized + noise;
+			//cv::normalize(sized_norm, sized_norm, 0.0, 255.0, cv::NORM_MINMAX, sized.type());
+			//cv::imshow("source", sized);
+			//cv::imshow("gaussian noise", sized_norm);
+			//cv::waitKey(0);
+			sized = sized_norm;
+		}
+
+		return;
+	}
+
+
+	/** Scratch buffers re-used by @ref image_data_augmentation() so the image loading threads don't need to allocate
+	 * memory for each image.
+	 */
+	struct AugmentationBuffers
+	{
+		Darknet::VInt	col0;	///< offset of the 1st source column for each output column, or -1 if outside the image
+		Darknet::VInt	col1;	///< offset of the 2nd source column for each output column, or -1 if outside the image
+		Darknet::VFloat	weight;	///< weight of the 2nd source column
+		Darknet::VFloat	rows;	///< 2 interpolated source rows and the output row, each stored as separate channels
+		cv::Mat			bytes;	///< 8-bit output, only used when blur or noise must be applied
+	};
+	static thread_local AugmentationBuffers buffers;
+
+
+	/** Convert RGB to HSV, apply the hue, saturation, and exposure adjustments, and convert back to RGB.  This is the
+	 * same as the 8-bit @p cv::COLOR_RGB2HSV and @p cv::COLOR_HSV2RGB conversions done by
+	 * @ref image_data_augmentation_opencv(), but without rounding to 8-bit values in between.  The channels are
+	 * modified in place, and the loop is written without branches so the compiler can vectorize it.
+	 */
+	static void adjust_hsv(float * rgb, const int w, const float dhue, const float dsat, const float dexp)
+	{
+		TAT(TATPARMS);
+
+		// OpenCV stores the 8-bit hue as 0...179, and the adjustment saturates at 0...255
+		const float hue_shift = std::round(179.0f * dhue);
+
+		for (int x = 0; x < w; ++x)
+		{
+			const float R = rgb[x];
+			const float G = rgb[x + w];
+			const float B = rgb[x + 2 * w];
+
+			const float v		= std::max(R, std::max(G, B));
+			const float diff	= v - std::min(R, std::min(G, B));
+			const float inv		= diff > 0.0f ? 1.0f / diff : 0.0f;
+			const float s		= v > 0.0f ? diff / v : 0.0f;
+
+			float h =	(v == R) ? (G - B) * inv :
+						(v == G) ? 2.0f + (B - R) * inv :
+						4.0f + (R - G) * inv;
+			h = h < 0.0f ? h + 6.0f : h;
+
+			// back to the 8-bit range used by OpenCV to apply the hue adjustment
+			float hue = std::min(std::max(std::round(h * 30.0f) + hue_shift, 0.0f), 255.0f) / 30.0f;
+			hue = hue >= 6.0f ? hue - 6.0f : hue;
+
+			const float sat = std::min(s * dsat, 1.0f);
+			const float val = std::min(v * dexp, 255.0f);
+
+			// the hue is never negative, so truncating is the same as std::floor() but is easier to vectorize
+			const float sector	= static_cast<float>(static_cast<int>(hue));
+			const float f		= hue - sector;
+			const float p		= val * (1.0f - sat);
+			const float q		= val * (1.0f - sat * f);
+			const float t		= val * (1.0f - sat * (1.0f - f));
+
+			rgb[x]			= ((sector == 0.0f) | (sector == 5.0f)) ? val : (sector == 1.0f) ? q : (sector == 4.0f) ? t : p;
+			rgb[x + w]		= ((sector == 1.0f) | (sector == 2.0f)) ? val : (sector == 0.0f) ? t : (sector == 3.0f) ? q : p;
+			rgb[x + 2 * w]	= ((sector == 3.0f) | (sector == 4.0f)) ? val : (sector == 2.0f) ? t : (sector == 5.0f) ? q : p;
+		}
+
+		return;
+	}
+
+
+	/** Interpolate one source row horizontally into separate channels.  Only the output columns from @p begin to @p end
+	 * have both source columns within the image, the columns on either side use the mean colour instead.
+	 */
+	static void interpolate_columns(const uint8_t * src, const int * col0, const int * col1, const float * weight, const int begin, const int end, const float * mean, const int w, const int c, float * out)
+	{
+		TAT(TATPARMS);
+
+		if (src == nullptr)
+		{
+			for (int k = 0; k < c; ++k)
+			{
+				std::fill(out + k * w, out + (k + 1) * w, mean[k]);
+			}
+			return;
+		}
+
+		for (int x = 0; x < w; ++x)
+		{
+			if (x == begin)
+			{
+				// skip over the columns which are inside the image
+				x = end - 1;
+				continue;
+			}
+
+			for (int k = 0; k < c; ++k)
+			{
+				const float p0 = col0[x] >= 0 ? src[col0[x] + k] : mean[k];
+				const float p1 = col1[x] >= 0 ? src[col1[x] + k] : mean[k];
+				out[x + k * w] = p0 + weight[x] * (p1 - p0);
+			}
+		}
+
+		if (c == 3)
+		{
+			for (int x = begin; x < end; ++x)
+			{
+				const uint8_t * p0 = src + col0[x];
+				const uint8_t * p1 = src + col1[x];
+				const float wx = weight[x];
+				out[x]			= p0[0] + wx * (p1[0] - p0[0]);
+				out[x + w]		= p0[1] + wx * (p1[1] - p0[1]);
+				out[x + 2 * w]	= p0[2] + wx * (p1[2] - p0[2]);
+			}
+		}
+		else
+		{
+			for (int x = begin; x < end; ++x)
+			{
+				const float wx = weight[x];
+				for (int k = 0; k < c; ++k)
+				{
+					const float p0 = src[col0[x] + k];
+					out[x + k * w] = p0 + wx * (src[col1[x] + k] - p0);
+				}
+			}
+		}
+
+		return;
+	}
+
+
+	/** Crop, resize, flip, and adjust the colours in a single pass over the output image.  Each output pixel is
+	 * interpolated directly from the source image (same as @p cv::INTER_LINEAR), and the parts of the crop which fall
+	 * outside of the source image get the mean colour of the image.  Source rows are interpolated horizontally once
+	 * and re-used by consecutive output rows.
+	 *
+	 * Only the part of the @p w x @p h output image within @p roi is calculated.  The results are written either as
+	 * normalized floats to @p planes (one plane per channel, same as @ref Darknet::Image, starting with the top-left
+	 * corner of @p roi), or as 8-bit values to @p bytes (which must be the size of @p roi).
+	 */
+	static void crop_resize_flip_hsv(const cv::Mat & mat, const int w, const int h,
+		const int pleft, const int ptop, const int swidth, const int sheight, const int flip,
+		const float dhue, const float dsat, const float dexp,
+		const cv::Rect & roi, float * planes, const int stride, const size_t plane_size, cv::Mat * bytes)
+	{
+		TAT(TATPARMS);
+
+		const int c			= mat.channels();
+		const int rw		= roi.width;
+		const int wc		= rw * c;
+		const bool hsv		= c >= 3 and (dsat != 1.0f or dexp != 1.0f or dhue != 0.0f);
+		const bool exposure	= c < 3 and dexp != 1.0f;
+
+		float mean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		if (pleft < 0 or ptop < 0 or pleft + swidth > mat.cols or ptop + sheight > mat.rows)
+		{
+			const cv::Scalar m = cv::mean(mat);
+			for (int k = 0; k < c and k < 4; ++k)
+			{
+				mean[k] = m[k];
+			}
+		}
+
+		auto & b = buffers;
+		b.col0	.resize(rw);
+		b.col1	.resize(rw);
+		b.weight.resize(rw);
+		b.rows	.resize(3 * static_cast<size_t>(wc));
+
+		int * col0		= b.col0.data();
+		int * col1		= b.col1.data();
+		float * weight	= b.weight.data();
+		float * above	= b.rows.data();
+		float * below	= above + wc;
+		float * row		= below + wc;
+
+		// the source columns are the same for every row
+		int begin	= rw;
+		int end		= 0;
+		const float scale_x = static_cast<float>(swidth) / w;
+		for (int x = 0; x < rw; ++x)
+		{
+			const int xo = flip ? w - 1 - (roi.x + x) : roi.x + x;
+			const float fx = (xo + 0.5f) * scale_x - 0.5f;
+			int sx = static_cast<int>(std::floor(fx));
+			float wx = fx - sx;
+			if (sx < 0)
+			{
+				sx = 0;
+				wx = 0.0f;
+			}
+			if (sx >= swidth - 1)
+			{
+				sx = swidth - 1;
+				wx = 0.0f;
+			}
+
+			const int first		= sx + pleft;
+			const int second	= std::min(sx + 1, swidth - 1) + pleft;
+			col0[x]		= (first	>= 0 and first	< mat.cols) ? first		* c : -1;
+			col1[x]		= (second	>= 0 and second	< mat.cols) ? second	* c : -1;
+			weight[x]	= wx;
+			if (col0[x] >= 0 and col1[x] >= 0)
+			{
+				begin	= std::min(begin, x);
+				end		= std::max(end, x + 1);
+			}
+		}
+
+		// rows of the source image which are currently interpolated in "above" and "below" (note that -1 is a valid row
+		// when the crop starts above the image)
+		int row_above = std::numeric_limits<int>::min();
+		int row_below = std::numeric_limits<int>::min();
+
+		const float scale_y = static_cast<float>(sheight) / h;
+		for (int y = roi.y; y < roi.y + roi.height; ++y)
+		{
+			const float fy = (y + 0.5f) * scale_y - 0.5f;
+			int sy = static_cast<int>(std::floor(fy));
+			float wy = fy - sy;
+			if (sy < 0)
+			{
+				sy = 0;
+				wy = 0.0f;
+			}
+			if (sy >= sheight - 1)
+			{
+				sy = sheight - 1;
+				wy = 0.0f;
+			}
+
+			const int first		= sy + ptop;
+			const int second	= std::min(sy + 1, sheight - 1) + ptop;
+
+			// when enlarging, consecutive output rows use the same source rows
+			if (first != row_above)
+			{
+				if (first == row_below)
+				{
+					std::swap(above, below);
+					std::swap(row_above, row_below);
+				}
+				else
+				{
+					interpolate_columns((first >= 0 and first < mat.rows) ? mat.ptr<uint8_t>(first) : nullptr, col0, col1, weight, begin, end, mean, rw, c, above);
+					row_above = first;
+				}
+			}
+			if (second != row_below)
+			{
+				interpolate_columns((second >= 0 and second < mat.rows) ? mat.ptr<uint8_t>(second) : nullptr, col0, col1, weight, begin, end, mean, rw, c, below);
+				row_below = second;
+			}
+
+			for (int idx = 0; idx < wc; ++idx)
+			{
+				row[idx] = above[idx] + wy * (below[idx] - above[idx]);
+			}
+
+			if (hsv)
+			{
+				adjust_hsv(row, rw, dhue, dsat, dexp);
+			}
+			else if (exposure)
+			{
+				for (int idx = 0; idx < wc; ++idx)
+				{
+					row[idx] = std::min(row[idx] * dexp, 255.0f);
+				}
+			}
+
+			// the values are rounded to 8-bit, same as when the augmentation was done entirely with OpenCV
+			if (planes)
+			{
+				for (int k = 0; k < c; ++k)
+				{
+					const float * in = row + k * rw;
+					float * out = planes + k * plane_size + static_cast<size_t>(y - roi.y) * stride;
+					for (int x = 0; x < rw; ++x)
+					{
+						out[x] = std::round(std::min(std::max(in[x], 0.0f), 255.0f)) * (1.0f / 255.0f);
+					}
+				}
+			}
+			else
+			{
+				uint8_t * out = bytes->ptr<uint8_t>(y - roi.y);
+				for (int x = 0; x < rw; ++x)
+				{
+					for (int k = 0; k < c; ++k)
+					{
+						out[x * c + k] = static_cast<uint8_t>(std::round(std::clamp(row[static_cast<size_t>(k) * rw + x], 0.0f, 255.0f)));
+					}
+				}
+			}
+		}
+
+		return;
+	}
+}
+
+
 /// @todo COLOR - cannot do hue in hyperspectal land
-Darknet::Image image_data_augmentation(cv::Mat mat, int w, int h,
+Darknet::Image image_data_augmentation_opencv(cv::Mat mat, int w, int h,
 	int pleft, int ptop, int swidth, int sheight, int flip,
 	float dhue, float dsat, float dexp,
 	int gaussian_noise, int blur, int num_boxes, int truth_size, float *truth)
@@ -358,77 +885,114 @@ Darknet::Image image_data_augmentation(cv::Mat mat, int w, int h,
 		//cv::imshow(window_name.str(), sized);
 		//cv::waitKey(0);
 
-		if (blur)
+		blur_and_noise(sized, gaussian_noise, blur, num_boxes, truth_size, truth);
+
+		// Mat -> image
+		out = Darknet::rgb_mat_to_rgb_image(sized);
+	}
+	catch (const std::exception & e)
+	{
+		darknet_fatal_error(DARKNET_LOC, "exception caught while augmenting image (%dx%d): %s", w, h, e.what());
+	}
+	catch (...)
+	{
+		darknet_fatal_error(DARKNET_LOC, "unknown exception while augmenting image (%dx%d)", w, h);
+	}
+
+	return out;
+}
+
+
+Darknet::Image image_data_augmentation(cv::Mat mat, int w, int h,
+	int pleft, int ptop, int swidth, int sheight, int flip,
+	float dhue, float dsat, float dexp,
+	int gaussian_noise, int blur, int num_boxes, int truth_size, float *truth)
+{
+	TAT(TATPARMS);
+
+	if (mat.depth() != CV_8U or mat.channels() > 4 or swidth <= 0 or sheight <= 0)
+	{
+		// not something the fused code can handle, so use the original OpenCV calls
+		return image_data_augmentation_opencv(mat, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, gaussian_noise, blur, num_boxes, truth_size, truth);
+	}
+
+	Darknet::Image out = make_image(w, h, mat.channels());
+
+	image_data_augmentation_into(mat, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, gaussian_noise, blur, num_boxes, truth_size, truth,
+		cv::Rect(0, 0, w, h), out.data, w, h, 0, 0);
+
+	return out;
+}
+
+
+void image_data_augmentation_into(cv::Mat mat, int w, int h,
+	int pleft, int ptop, int swidth, int sheight, int flip,
+	float dhue, float dsat, float dexp,
+	int gaussian_noise, int blur, int num_boxes, int truth_size, float *truth,
+	const cv::Rect & roi, float * dst, int dst_w, int dst_h, int dst_x, int dst_y)
+{
+	TAT(TATPARMS);
+
+	const int c					= mat.channels();
+	const size_t plane_size		= static_cast<size_t>(dst_w) * dst_h;
+	float * planes				= dst + static_cast<size_t>(dst_y) * dst_w + dst_x;
+
+	if (roi.x < 0 or roi.y < 0 or roi.width <= 0 or roi.height <= 0 or roi.x + roi.width > w or roi.y + roi.height > h or
+		dst_x < 0 or dst_y < 0 or dst_x + roi.width > dst_w or dst_y + roi.height > dst_h)
+	{
+		darknet_fatal_error(DARKNET_LOC, "invalid augmentation region: %dx%d+%d+%d of %dx%d to %d,%d of %dx%d", roi.width, roi.height, roi.x, roi.y, w, h, dst_x, dst_y, dst_w, dst_h);
+	}
+
+	if (mat.depth() != CV_8U or c > 4 or swidth <= 0 or sheight <= 0)
+	{
+		// not something the fused code can handle, so use the original OpenCV calls and copy the region we need
+		Darknet::Image tmp = image_data_augmentation_opencv(mat, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, gaussian_noise, blur, num_boxes, truth_size, truth);
+		for (int k = 0; k < tmp.c; ++k)
 		{
-			cv::Mat dst(sized.size(), sized.type());
-			if (blur == 1)
+			for (int y = 0; y < roi.height; ++y)
 			{
-				cv::GaussianBlur(sized, dst, cv::Size(17, 17), 0);
-				//cv::bilateralFilter(sized, dst, 17, 75, 75);
+				const float * in = tmp.data + (static_cast<size_t>(k) * h + roi.y + y) * w + roi.x;
+				std::copy(in, in + roi.width, planes + k * plane_size + static_cast<size_t>(y) * dst_w);
 			}
-			else
-			{
-				int ksize = (blur / 2) * 2 + 1;
-				cv::Size kernel_size = cv::Size(ksize, ksize);
-				cv::GaussianBlur(sized, dst, kernel_size, 0);
-				//cv::medianBlur(sized, dst, ksize);
-				//cv::bilateralFilter(sized, dst, ksize, 75, 75);
+		}
+		Darknet::free_image(tmp);
+		return;
+	}
 
-				// sharpen
-				//cv::Mat img_tmp;
-				//cv::GaussianBlur(dst, img_tmp, cv::Size(), 3);
-				//cv::addWeighted(dst, 1.5, img_tmp, -0.5, 0, img_tmp);
-				//dst = img_tmp;
-			}
-			//*cfg_and_state.output << " blur num_boxes = " << num_boxes << std::endl;
+	if (not blur and not gaussian_noise)
+	{
+		crop_resize_flip_hsv(mat, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, roi, planes, dst_w, plane_size, nullptr);
+		return;
+	}
 
-			if (blur == 1)
+	// blur and noise are applied by OpenCV on the entire 8-bit image, so we need a 2nd pass to convert to floats
+	try
+	{
+		cv::Mat & sized = buffers.bytes;
+		sized.create(h, w, mat.type());
+		crop_resize_flip_hsv(mat, w, h, pleft, ptop, swidth, sheight, flip, dhue, dsat, dexp, cv::Rect(0, 0, w, h), nullptr, 0, 0, &sized);
+
+		blur_and_noise(sized, gaussian_noise, blur, num_boxes, truth_size, truth);
+
+		for (int y = 0; y < roi.height; ++y)
+		{
+			const uint8_t * in = sized.ptr<uint8_t>(roi.y + y) + roi.x * c;
+			for (int k = 0; k < c; ++k)
 			{
-				cv::Rect r(0, 0, sized.cols, sized.rows);
-				for (int t = 0; t < num_boxes; ++t)
+				float * out = planes + k * plane_size + static_cast<size_t>(y) * dst_w;
+				for (int x = 0; x < roi.width; ++x)
 				{
-					Darknet::Box b = float_to_box_stride(truth + t*truth_size, 1);
-					if (!b.x) break;
-					int left = (b.x - b.w / 2.)*sized.cols;
-					int width = b.w*sized.cols;
-					int top = (b.y - b.h / 2.)*sized.rows;
-					int height = b.h*sized.rows;
-					cv::Rect roi(left, top, width, height);
-					roi = roi & r;
-
-					sized(roi).copyTo(dst(roi));
+					out[x] = in[x * c + k] * (1.0f / 255.0f);
 				}
 			}
-			dst.copyTo(sized);
 		}
-
-		if (gaussian_noise)
-		{
-			cv::Mat noise = cv::Mat(sized.size(), sized.type());
-			gaussian_noise = std::min(gaussian_noise, 127);
-			gaussian_noise = std::max(gaussian_noise, 0);
-			cv::randn(noise, 0, gaussian_noise);  //mean and variance
-			cv::Mat sized_norm = sized + noise;
-			//cv::normalize(sized_norm, sized_norm, 0.0, 255.0, cv::NORM_MINMAX, sized.type());
-			//cv::imshow("source", sized);
-			//cv::imshow("gaussian noise", sized_norm);
-			//cv::waitKey(0);
-			sized = sized_norm;
-		}
-
-		// Mat -> image
-		out = Darknet::rgb_mat_to_rgb_image(sized);
 	}
 	catch (const std::exception & e)
 	{
 		darknet_fatal_error(DARKNET_LOC, "exception caught while augmenting image (%dx%d): %s", w, h, e.what());
 	}
-	catch (...)
-	{
-		darknet_fatal_error(DARKNET_LOC, "unknown exception while augmenting image (%dx%d)", w, h);
-	}
 
-	return out;
+	return;
 }
 
 
@@ -6,9 +6,20 @@
 /** Load the given image using OpenCV.  Automatically converts the image from the usual OpenCV BGR format to RGB for
  * use in Darknet.
  *
+ * If @p min_width and @p min_height are set and the image is a JPEG at least twice that size, then the image is decoded
+ * at a reduced size (1/2, 1/4, or 1/8) which is much faster.  Since the reduced image has the same aspect ratio,
+ * normalized coordinates such as the annotations used for training are not affected.
+ *
  * @see @ref Darknet::load_image()
  */
-cv::Mat load_rgb_mat_image(const std::string & filename, int flag);
+cv::Mat load_rgb_mat_image(const std::string & filename, int flag, const int min_width = 0, const int min_height = 0);
+
+/** Same as @ref load_rgb_mat_image() but the image is decoded from memory instead of being read from disk.  The
+ * filename is only used in error messages.
+ *
+ * @since 2026-10-17
+ */
+cv::Mat decode_rgb_mat_image(const void * encoded, const size_t size, const std::string & filename, int channels, const int min_width = 0, const int min_height = 0);
 
 void show_image_cv(Darknet::Image p, const char *name);
 
@@ -16,11 +27,42 @@ void show_image_cv(Darknet::Image p, const char *name);
 void draw_detections_cv_v3(cv::Mat show_img, Darknet::Detection *dets, int num, float thresh, char **names, int classes, int ext_output);
 
 // Data augmentation
+
+/** Crop, resize, flip, and adjust the hue/saturation/exposure of a training image in a single pass, writing the
+ * results directly as normalized floats.  Blur and gaussian noise, when requested, are still applied by OpenCV.
+ *
+ * @see @ref image_data_augmentation_opencv()
+ * @see @ref Darknet::benchmark_augmentation()
+ */
 Darknet::Image image_data_augmentation(cv::Mat mat, int w, int h,
     int pleft, int ptop, int swidth, int sheight, int flip,
     float dhue, float dsat, float dexp,
     int gaussian_noise, int blur, int num_boxes, int truth_size, float *truth);
 
+/** Same as @ref image_data_augmentation(), but only the region @p roi of the augmented @p w x @p h image is calculated,
+ * and it is written directly to @p dst at @p dst_x, @p dst_y.  The destination is an image of @p dst_w x @p dst_h with
+ * one plane per channel, such as a row in the training batch.  This is how mosaic augmentation places each of the 4
+ * images into the output without creating temporary images.
+ *
+ * @since 2026-10-17
+ */
+void image_data_augmentation_into(cv::Mat mat, int w, int h,
+    int pleft, int ptop, int swidth, int sheight, int flip,
+    float dhue, float dsat, float dexp,
+    int gaussian_noise, int blur, int num_boxes, int truth_size, float *truth,
+    const cv::Rect & roi, float * dst, int dst_w, int dst_h, int dst_x, int dst_y);
+
+/** The original data augmentation which calls OpenCV for every step (crop, resize, flip, HSV conversion, etc).  This
+ * is still used for images which @ref image_data_augmentation() cannot handle, and is the baseline in
+ * @ref Darknet::benchmark_augmentation().
+ *
+ * @since 2026-10-17
+ */
+Darknet::Image image_data_augmentation_opencv(cv::Mat mat, int w, int h,
+    int pleft, int ptop, int swidth, int sheight, int flip,
+    float dhue, float dsat, float dexp,
+    int gaussian_noise, int blur, int num_boxes, int truth_size, float *truth);
+
 // blend two images with (alpha and beta)
 void blend_images_cv(Darknet::Image new_img, float alpha, Darknet::Image old_img, float beta);
 
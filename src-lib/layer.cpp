@@ -58,6 +58,19 @@ namespace
 		return;
 	}
 
+	void static inline free_and_clear(int8_t* & ptr)
+	{
+		TAT(TATPARMS);
+
+		if (ptr)
+		{
+			free(ptr);
+			ptr = nullptr;
+		}
+
+		return;
+	}
+
 	void static inline free_and_clear(char* & ptr)
 	{
 		TAT(TATPARMS);
@@ -85,6 +98,46 @@ namespace
 		return;
 	}
 
+	/** Call @p fn with each of the parameters which a network replica shares with the original layer.
+	 *
+	 * @see @ref Darknet::share_layer_parameters()
+	 */
+	template <typename F>
+	static inline void for_each_shared_parameter(Darknet::Layer & replica, const Darknet::Layer & original, F && fn)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		fn(replica.weights,				original.weights);
+		fn(replica.biases,				original.biases);
+		fn(replica.scales,				original.scales);
+		fn(replica.rolling_mean,		original.rolling_mean);
+		fn(replica.rolling_variance,	original.rolling_variance);
+		fn(replica.winograd_weights,	original.winograd_weights);
+		fn(replica.int8_weights,		original.int8_weights);
+		fn(replica.int8_weight_scales,	original.int8_weight_scales);
+		fn(replica.int8_weight_sums,	original.int8_weight_sums);
+		fn(replica.nhwc_weights,		original.nhwc_weights);
+
+		return;
+	}
+
+	#ifdef DARKNET_GPU
+	/// Same as @ref for_each_shared_parameter(), but for the copies of the parameters stored on the GPU.
+	template <typename F>
+	static inline void for_each_shared_gpu_parameter(Darknet::Layer & replica, const Darknet::Layer & original, F && fn)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		fn(replica.weights_gpu,				original.weights_gpu);
+		fn(replica.biases_gpu,				original.biases_gpu);
+		fn(replica.scales_gpu,				original.scales_gpu);
+		fn(replica.rolling_mean_gpu,		original.rolling_mean_gpu);
+		fn(replica.rolling_variance_gpu,	original.rolling_variance_gpu);
+
+		return;
+	}
+	#endif
+
 	#ifdef DARKNET_GPU
 	void static inline cuda_free_and_clear(float* & ptr)
 	{
@@ -102,6 +155,67 @@ namespace
 }
 
 
+void Darknet::share_layer_parameters(Darknet::Layer & replica, const Darknet::Layer & original)
+{
+	TAT(TATPARMS);
+
+	// layers with "share_layer" never owned their parameters
+	const bool owned = (replica.share_layer == nullptr);
+
+	for_each_shared_parameter(replica, original,
+		[owned](auto * & dst, auto * const src)
+		{
+			if (owned and dst != nullptr and dst != src)
+			{
+				free(dst);
+			}
+			dst = src;
+		});
+
+	#ifdef DARKNET_GPU
+	for_each_shared_gpu_parameter(replica, original,
+		[owned](float * & dst, float * const src)
+		{
+			if (owned and dst != nullptr and dst != src)
+			{
+				cuda_free(dst);
+			}
+			dst = src;
+		});
+	#endif
+
+	// these go with the transformed weights
+	replica.conv_algorithm		= original.conv_algorithm;
+	replica.int8_input_scale	= original.int8_input_scale;
+	replica.input_layout		= original.input_layout;
+	replica.output_layout		= original.output_layout;
+
+	return;
+}
+
+
+void Darknet::unshare_layer_parameters(Darknet::Layer & replica, const Darknet::Layer & original)
+{
+	TAT(TATPARMS);
+
+	const auto forget = [](auto * & dst, auto * const src)
+	{
+		if (dst == src)
+		{
+			dst = nullptr;
+		}
+	};
+
+	for_each_shared_parameter(replica, original, forget);
+
+	#ifdef DARKNET_GPU
+	for_each_shared_gpu_parameter(replica, original, forget);
+	#endif
+
+	return;
+}
+
+
 void free_layer(Darknet::Layer & l)
 {
 	TAT(TATPARMS);
@@ -184,6 +298,11 @@ void free_layer_custom(Darknet::Layer & l, int keep_cudnn_desc)
 	if (l.weights)						free_and_clear(l.weights);
 	if (l.weight_updates)				free_and_clear(l.weight_updates);
 	if (l.align_bit_weights)			free_and_clear(l.align_bit_weights);
+	if (l.winograd_weights)				free_and_clear(l.winograd_weights);
+	if (l.int8_weights)					free_and_clear(l.int8_weights);
+	if (l.int8_weight_scales)			free_and_clear(l.int8_weight_scales);
+	if (l.int8_weight_sums)				free_and_clear(l.int8_weight_sums);
+	if (l.nhwc_weights)					free_and_clear(l.nhwc_weights);
 	if (l.mean_arr)						free_and_clear(l.mean_arr);
 
 #ifdef DARKNET_GPU
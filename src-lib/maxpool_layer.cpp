@@ -4,6 +4,55 @@
 namespace
 {
 	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// Same as @ref forward_maxpool_layer() but for layers which use NHWC.  @see @ref Darknet::convert_network_to_nhwc()
+	static void forward_maxpool_layer_nhwc(Darknet::Layer & l, const float * input)
+	{
+		TAT(TATPARMS);
+
+		const int c = l.c;
+		const int w_offset = -l.pad / 2;
+		const int h_offset = -l.pad / 2;
+
+		for (int b = 0; b < l.batch; ++b)
+		{
+			#pragma omp parallel for
+			for (int i = 0; i < l.out_h; ++i)
+			{
+				for (int j = 0; j < l.out_w; ++j)
+				{
+					// all of the channels for a pixel are contiguous, so the maximum is found for all of them at once
+					float * out = l.output + ((static_cast<size_t>(b) * l.out_h + i) * l.out_w + j) * c;
+					std::fill(out, out + c, -FLT_MAX);
+
+					for (int n = 0; n < l.size; ++n)
+					{
+						const int cur_h = h_offset + i * l.stride_y + n;
+						if (cur_h < 0 or cur_h >= l.h)
+						{
+							continue;
+						}
+						for (int m = 0; m < l.size; ++m)
+						{
+							const int cur_w = w_offset + j * l.stride_x + m;
+							if (cur_w < 0 or cur_w >= l.w)
+							{
+								continue;
+							}
+							const float * in = input + ((static_cast<size_t>(b) * l.h + cur_h) * l.w + cur_w) * c;
+							for (int k = 0; k < c; ++k)
+							{
+								out[k] = std::max(out[k], in[k]);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return;
+	}
 }
 
 Darknet::Image get_maxpool_image(Darknet::Layer & l)
@@ -256,6 +305,12 @@ void forward_maxpool_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
 
+	if (l.output_layout == Darknet::ETensorLayout::kNHWC)
+	{
+		forward_maxpool_layer_nhwc(l, state.input);
+		return;
+	}
+
 	if (l.maxpool_depth)
 	{
 		int b, i, j, k, g;
@@ -1,5 +1,44 @@
 #include "darknet_internal.hpp"
 
+
+namespace
+{
+	/** Same as @ref forward_route_layer() but for layers which use NHWC.  The channels of the inputs are interleaved,
+	 * so each pixel is copied separately.  @see @ref Darknet::convert_network_to_nhwc()
+	 */
+	static void forward_route_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state)
+	{
+		TAT(TATPARMS);
+
+		const int pixels = l.out_w * l.out_h;
+
+		int offset = 0;
+		for (int i = 0; i < l.n; ++i)
+		{
+			const Darknet::Layer & input_layer = state.net.layers[l.input_layers[i]];
+			const int input_c = l.input_sizes[i] / pixels;
+			const int part_c = input_c / l.groups;
+
+			for (int b = 0; b < l.batch; ++b)
+			{
+				const float * src = input_layer.output + static_cast<size_t>(b) * l.input_sizes[i] + part_c * l.group_id;
+				float * dst = l.output + static_cast<size_t>(b) * l.outputs + offset;
+
+				#pragma omp parallel for
+				for (int p = 0; p < pixels; ++p)
+				{
+					std::memcpy(dst + static_cast<size_t>(p) * l.out_c, src + static_cast<size_t>(p) * input_c, part_c * sizeof(float));
+				}
+			}
+
+			offset += part_c;
+		}
+
+		return;
+	}
+}
+
+
 Darknet::Layer make_route_layer(int batch, int n, int *input_layers, int *input_sizes, int groups, int group_id)
 {
 	TAT(TATPARMS);
@@ -83,6 +122,12 @@ void forward_route_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
 
+	if (l.output_layout == Darknet::ETensorLayout::kNHWC)
+	{
+		forward_route_layer_nhwc(l, state);
+		return;
+	}
+
 	int i, j;
 	int offset = 0;
 	for(i = 0; i < l.n; ++i){
@@ -91,8 +136,15 @@ void forward_route_layer(Darknet::Layer & l, Darknet::NetworkState state)
 		int input_size = l.input_sizes[i];
 		int part_input_size = input_size / l.groups;
 		for(j = 0; j < l.batch; ++j){
+			float *src = input + j*input_size + part_input_size*l.group_id;
+			float *dst = l.output + offset + j*l.outputs;
+			if (src == dst)
+			{
+				// the input layer already wrote its output in place; see plan_activation_memory()
+				continue;
+			}
 			//copy_cpu(input_size, input + j*input_size, 1, l.output + offset + j*l.outputs, 1);
-			copy_cpu(part_input_size, input + j*input_size + part_input_size*l.group_id, 1, l.output + offset + j*l.outputs, 1);
+			copy_cpu(part_input_size, src, 1, dst, 1);
 		}
 		//offset += input_size;
 		offset += part_input_size;
@@ -1,5 +1,38 @@
 #include "darknet_internal.hpp"
 
+
+namespace
+{
+	/// Same as @ref forward_upsample_layer() but for layers which use NHWC.  @see @ref Darknet::convert_network_to_nhwc()
+	static void forward_upsample_layer_nhwc(Darknet::Layer & l, const float * input)
+	{
+		TAT(TATPARMS);
+
+		const int c = l.c;
+
+		for (int b = 0; b < l.batch; ++b)
+		{
+			#pragma omp parallel for
+			for (int j = 0; j < l.out_h; ++j)
+			{
+				for (int i = 0; i < l.out_w; ++i)
+				{
+					// the channels of each pixel are contiguous in both the input and the output
+					const float * in = input + ((static_cast<size_t>(b) * l.h + j / l.stride) * l.w + i / l.stride) * c;
+					float * out = l.output + ((static_cast<size_t>(b) * l.out_h + j) * l.out_w + i) * c;
+					for (int k = 0; k < c; ++k)
+					{
+						out[k] = l.scale * in[k];
+					}
+				}
+			}
+		}
+
+		return;
+	}
+}
+
+
 Darknet::Layer make_upsample_layer(int batch, int w, int h, int c, int stride)
 {
 	TAT(TATPARMS);
@@ -73,6 +106,12 @@ void forward_upsample_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
 
+	if (l.output_layout == Darknet::ETensorLayout::kNHWC)
+	{
+		forward_upsample_layer_nhwc(l, state.input);
+		return;
+	}
+
 	fill_cpu(l.outputs*l.batch, 0, l.output, 1);
 	if(l.reverse){
 		upsample_cpu(l.output, l.out_w, l.out_h, l.c, l.batch, l.stride, 0, l.scale, state.input);
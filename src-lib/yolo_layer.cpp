@@ -348,6 +348,95 @@ namespace
 		return batch * l.outputs + n * l.w * l.h * (4 + l.classes + 1) + entry * l.w * l.h + loc;
 	}
 
+
+	/// Apply the logistic activation and scale x,y.  The raw values must already have been copied to @p l.output.
+	static void activate_yolo_output(Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+		for (int b = 0; b < l.batch; ++b)
+		{
+			for (int n = 0; n < l.n; ++n)
+			{
+				int bbox_index = yolo_entry_index(l, b, n*l.w*l.h, 0);
+				if (l.new_coords)
+				{
+					//activate_array(l.output + bbox_index, 4 * l.w*l.h, LOGISTIC);    // x,y,w,h
+				}
+				else
+				{
+					activate_array(l.output + bbox_index, 2 * l.w*l.h, LOGISTIC);        // x,y,
+					int obj_index = yolo_entry_index(l, b, n*l.w*l.h, 4);
+					activate_array(l.output + obj_index, (1 + l.classes)*l.w*l.h, LOGISTIC);
+				}
+				scal_add_cpu(2 * l.w*l.h, l.scale_x_y, -0.5*(l.scale_x_y - 1), l.output + bbox_index, 1);    // scale x,y
+			}
+		}
+
+		return;
+	}
+
+
+	/** Inference only needs the objectness to find the few cells with an object.  Only the objectness plane is written
+	 * to @p l.output, and everything else is activated as needed from the input by @ref get_yolo_detections_v3().
+	 */
+	static void forward_yolo_layer_lazy(Darknet::Layer & l, const Darknet::NetworkState & state)
+	{
+		TAT(TATPARMS);
+
+		l.lazy_input = state.input;
+
+		const int plane_size = l.w * l.h;
+		for (int b = 0; b < l.batch; ++b)
+		{
+			for (int n = 0; n < l.n; ++n)
+			{
+				const int obj_index	= yolo_entry_index(l, b, n * plane_size, 4);
+				const float * src	= state.input + obj_index;
+				float * dst			= l.output + obj_index;
+
+				if (l.new_coords)
+				{
+					std::copy(src, src + plane_size, dst);
+				}
+				else
+				{
+					for (int i = 0; i < plane_size; ++i)
+					{
+						dst[i] = logistic_activate(src[i]);
+					}
+				}
+			}
+		}
+
+		return;
+	}
+
+
+	/// Same as @ref activate_yolo_output() but only for the box at @p box_index in the raw input of a lazy layer.
+	static inline void activate_lazy_yolo_box(const Darknet::Layer & l, const int box_index, const int stride, float xywh[4])
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		const float beta = -0.5*(l.scale_x_y - 1);
+
+		for (int k = 0; k < 4; ++k)
+		{
+			xywh[k] = l.lazy_input[box_index + k * stride];
+		}
+
+		if (not l.new_coords)
+		{
+			xywh[0] = logistic_activate(xywh[0]);
+			xywh[1] = logistic_activate(xywh[1]);
+		}
+
+		xywh[0] = xywh[0] * l.scale_x_y + beta;
+		xywh[1] = xywh[1] * l.scale_x_y + beta;
+
+		return;
+	}
+
 } // anonymous namespace
 
 
@@ -463,6 +552,7 @@ void resize_yolo_layer(Darknet::Layer * l, int w, int h)
 
 	l->w = w;
 	l->h = h;
+	l->lazy_input = nullptr;
 
 	l->outputs = h*w*l->n*(l->classes + 4 + 1);
 	l->inputs = l->outputs;
@@ -819,27 +909,20 @@ void forward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
 
-	memcpy(l.output, state.input, l.outputs * l.batch * sizeof(float));
-
 #ifndef DARKNET_GPU
-	for (int b = 0; b < l.batch; ++b)
+	if (!state.train and state.net.details and state.net.details->lazy_yolo_output)
 	{
-		for (int n = 0; n < l.n; ++n)
-		{
-			int bbox_index = yolo_entry_index(l, b, n*l.w*l.h, 0);
-			if (l.new_coords)
-			{
-				//activate_array(l.output + bbox_index, 4 * l.w*l.h, LOGISTIC);    // x,y,w,h
-			}
-			else
-			{
-				activate_array(l.output + bbox_index, 2 * l.w*l.h, LOGISTIC);        // x,y,
-				int obj_index = yolo_entry_index(l, b, n*l.w*l.h, 4);
-				activate_array(l.output + obj_index, (1 + l.classes)*l.w*l.h, LOGISTIC);
-			}
-			scal_add_cpu(2 * l.w*l.h, l.scale_x_y, -0.5*(l.scale_x_y - 1), l.output + bbox_index, 1);    // scale x,y
-		}
+		// no memcpy, no memset, and no logistic except on the objectness
+		forward_yolo_layer_lazy(l, state);
+		return;
 	}
+	l.lazy_input = nullptr;
+#endif
+
+	memcpy(l.output, state.input, l.outputs * l.batch * sizeof(float));
+
+#ifndef DARKNET_GPU
+	activate_yolo_output(l);
 #endif
 
 	// delta is zeroed
@@ -1221,6 +1304,21 @@ void correct_yolo_boxes(Darknet::Detection * dets, int n, int w, int h, int netw
 }
 
 
+void finish_lazy_yolo_output(Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	if (l.type == Darknet::ELayerType::YOLO and l.lazy_input)
+	{
+		memcpy(l.output, l.lazy_input, l.outputs * l.batch * sizeof(float));
+		l.lazy_input = nullptr;
+		activate_yolo_output(l);
+	}
+
+	return;
+}
+
+
 int yolo_num_detections(const Darknet::Layer & l, float thresh)
 {
 	TAT(TATPARMS);
@@ -1245,6 +1343,162 @@ int yolo_num_detections(const Darknet::Layer & l, float thresh)
 }
 
 
+#if (defined(__AVX__) && defined(__x86_64__)) || (defined(_WIN64) && !defined(__MINGW32__) && !defined(_M_ARM64))
+#define DARKNET_YOLO_COMPACT_AVX
+#define DARKNET_YOLO_COMPACT_SSE
+#elif defined(__SSE__) || (defined(_M_X64) && !defined(_M_ARM64))
+#define DARKNET_YOLO_COMPACT_SSE
+#endif
+
+#if defined(DARKNET_YOLO_COMPACT_AVX) || defined(DARKNET_YOLO_COMPACT_SSE)
+#include <immintrin.h>
+#include "gemm.hpp" // is_avx()
+
+namespace
+{
+	static inline int lowest_bit_set(uint32_t mask)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long idx = 0;
+		_BitScanForward(&idx, mask);
+		return static_cast<int>(idx);
+		#else
+		return __builtin_ctz(mask);
+		#endif
+	}
+
+
+	/// Append the index of each set bit in @p mask.  Most of the time the mask is zero and nothing needs to be done.
+	static inline int expand_mask(uint32_t mask, const int base, int * indexes, int count)
+	{
+		TAT_COMMENT(TATPARMS, "2026-10-17 inlined");
+
+		while (mask)
+		{
+			indexes[count ++] = base + lowest_bit_set(mask);
+			mask &= mask - 1;
+		}
+
+		return count;
+	}
+}
+#endif
+
+
+#ifdef DARKNET_YOLO_COMPACT_SSE
+static int yolo_compact_objectness_sse(const float * plane, const int size, const float thresh, int * indexes, const int offset)
+{
+	TAT(TATPARMS);
+
+	const __m128 t = _mm_set1_ps(thresh);
+
+	int count = 0;
+	int i = 0;
+
+	// 4 vectors of 4 floats at a time, combined into a single 16-bit mask
+	for (; i + 16 <= size; i += 16)
+	{
+		const uint32_t m0 = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(plane + i +  0), t));
+		const uint32_t m1 = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(plane + i +  4), t));
+		const uint32_t m2 = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(plane + i +  8), t));
+		const uint32_t m3 = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(plane + i + 12), t));
+		count = expand_mask(m0 | (m1 << 4) | (m2 << 8) | (m3 << 12), offset + i, indexes, count);
+	}
+
+	for (; i + 4 <= size; i += 4)
+	{
+		count = expand_mask(_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(plane + i), t)), offset + i, indexes, count);
+	}
+
+	for (; i < size; ++i)
+	{
+		if (plane[i] > thresh)
+		{
+			indexes[count ++] = offset + i;
+		}
+	}
+
+	return count;
+}
+#endif
+
+
+#ifdef DARKNET_YOLO_COMPACT_AVX
+static int yolo_compact_objectness_avx(const float * plane, const int size, const float thresh, int * indexes, const int offset)
+{
+	TAT(TATPARMS);
+
+	const __m256 t = _mm256_set1_ps(thresh);
+
+	int count = 0;
+	int i = 0;
+
+	// 4 vectors of 8 floats at a time, combined into a single 32-bit mask
+	for (; i + 32 <= size; i += 32)
+	{
+		const uint32_t m0 = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(plane + i +  0), t, _CMP_GT_OQ));
+		const uint32_t m1 = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(plane + i +  8), t, _CMP_GT_OQ));
+		const uint32_t m2 = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(plane + i + 16), t, _CMP_GT_OQ));
+		const uint32_t m3 = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(plane + i + 24), t, _CMP_GT_OQ));
+		count = expand_mask(m0 | (m1 << 8) | (m2 << 16) | (m3 << 24), offset + i, indexes, count);
+	}
+
+	for (; i + 8 <= size; i += 8)
+	{
+		count = expand_mask(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(plane + i), t, _CMP_GT_OQ)), offset + i, indexes, count);
+	}
+
+	for (; i < size; ++i)
+	{
+		if (plane[i] > thresh)
+		{
+			indexes[count ++] = offset + i;
+		}
+	}
+
+	return count;
+}
+#endif
+
+
+int yolo_compact_objectness_scalar(const float * plane, const int size, const float thresh, int * indexes, const int offset)
+{
+	TAT(TATPARMS);
+
+	int count = 0;
+	for (int i = 0; i < size; ++i)
+	{
+		if (plane[i] > thresh)
+		{
+			indexes[count ++] = offset + i;
+		}
+	}
+
+	return count;
+}
+
+
+int yolo_compact_objectness(const float * plane, const int size, const float thresh, int * indexes, const int offset)
+{
+	TAT(TATPARMS);
+
+	#ifdef DARKNET_YOLO_COMPACT_AVX
+	if (is_avx() == 1)
+	{
+		return yolo_compact_objectness_avx(plane, size, thresh, indexes, offset);
+	}
+	#endif
+
+	#ifdef DARKNET_YOLO_COMPACT_SSE
+	return yolo_compact_objectness_sse(plane, size, thresh, indexes, offset);
+	#else
+	return yolo_compact_objectness_scalar(plane, size, thresh, indexes, offset);
+	#endif
+}
+
+
 int yolo_num_detections_v3(Darknet::Network * net, const int index, const float thresh, Darknet::Output_Object_Cache & cache)
 {
 	TAT(TATPARMS);
@@ -1252,28 +1506,31 @@ int yolo_num_detections_v3(Darknet::Network * net, const int index, const float
 	// IMPORTANT:  note the object cache is NOT cleared here.  Because there may be multiple YOLO layers within a network,
 	// we only want to append to the cache, not overwrite previous entries from earlier YOLO layers.
 
-	int count = 0;
-
 	const Darknet::Layer & l = net->layers[index];
+	const int plane_size = l.w * l.h;
+
+	// make sure we have room for every cell of this layer in case they're all above the threshold
+	const size_t needed = cache.count + l.n * plane_size;
+	if (cache.locations.size() < needed)
+	{
+		cache.locations.resize(needed);
+	}
+
+	const size_t start = cache.count;
 
 	for (int n = 0; n < l.n; ++n)
 	{
-		for (int i = 0; i < l.w * l.h; ++i)
-		{
-			const int obj_index = yolo_entry_index(l, 0, n * l.w * l.h + i, 4);
-			if (l.output[obj_index] > thresh)
-			{
-				++count;
+		// the objectness values for each anchor are contiguous, so scan the whole W x H plane at once and remember
+		// the location of the objects so we don't have to walk through the array again
+		const int obj_index = yolo_entry_index(l, 0, n * plane_size, 4);
+		cache.count += yolo_compact_objectness(l.output + obj_index, plane_size, thresh, cache.locations.data() + cache.count, n * plane_size);
+	}
 
-				// remember the location of this object so we don't have to walk through the array again
-				Darknet::Output_Object oo;
-				oo.layer_index = index;
-				oo.n = n;
-				oo.i = i;
-				oo.obj_index = obj_index;
-				cache.push_back(oo);
-			}
-		}
+	const int count = static_cast<int>(cache.count - start);
+	if (count > 0)
+	{
+		cache.layer_index.push_back(index);
+		cache.layer_end.push_back(cache.count);
 	}
 
 	return count;
@@ -1351,39 +1608,61 @@ int get_yolo_detections_v3(Darknet::Network * net, int w, int h, int netw, int n
 	TAT(TATPARMS);
 
 	int count = 0;
+	size_t begin = 0;
 
-	for (const auto & oo : cache)
+	for (size_t idx = 0; idx < cache.layer_index.size(); ++idx)
 	{
-		const auto & i			= oo.i;
-		const auto & n			= oo.n;
-		const auto & obj_index	= oo.obj_index;
-
-		const Darknet::Layer & l = net->layers[oo.layer_index];
+		const Darknet::Layer & l = net->layers[cache.layer_index[idx]];
 		const float * predictions = l.output;
+		const int plane_size = l.w * l.h;
+		const size_t end = cache.layer_end[idx];
+
+		for (size_t pos = begin; pos < end; ++pos)
+		{
+			const int location		= cache.locations[pos];
+			const int n				= location / plane_size;
+			const int i				= location % plane_size;
+			const int row			= i / l.w;
+			const int col			= i % l.w;
+			const int obj_index		= yolo_entry_index(l, 0, location, 4);
+			const float objectness	= predictions[obj_index];
 
-		const int row			= i / l.w;
-		const int col			= i % l.w;
-		const float objectness	= predictions[obj_index];
+			const int box_index = yolo_entry_index(l, 0, location, 0);
 
-		const int box_index = yolo_entry_index(l, 0, n * l.w * l.h + i, 0);
+			if (l.lazy_input)
+			{
+				float xywh[4];
+				activate_lazy_yolo_box(l, box_index, plane_size, xywh);
+				dets[count].bbox	= get_yolo_box(xywh, l.biases, l.mask[n], 0, col, row, l.w, l.h, netw, neth, 1, l.new_coords);
+			}
+			else
+			{
+				dets[count].bbox	= get_yolo_box(predictions, l.biases, l.mask[n], box_index, col, row, l.w, l.h, netw, neth, plane_size, l.new_coords);
+			}
+			dets[count].objectness	= objectness;
+			dets[count].classes		= l.classes;
 
-		dets[count].bbox		= get_yolo_box(predictions, l.biases, l.mask[n], box_index, col, row, l.w, l.h, netw, neth, l.w * l.h, l.new_coords);
-		dets[count].objectness	= objectness;
-		dets[count].classes		= l.classes;
+			if (l.embedding_output)
+			{
+				/// @todo V3 what is this and where does it get used?
+				get_embedding(l.embedding_output, l.w, l.h, l.n * l.embedding_size, l.embedding_size, col, row, n, 0, dets[count].embeddings);
+			}
 
-		if (l.embedding_output)
-		{
-			/// @todo V3 what is this and where does it get used?
-			get_embedding(l.embedding_output, l.w, l.h, l.n * l.embedding_size, l.embedding_size, col, row, n, 0, dets[count].embeddings);
+			for (int j = 0; j < l.classes; ++j)
+			{
+				const int class_index = yolo_entry_index(l, 0, location, 4 + 1 + j);
+				float confidence = predictions[class_index];
+				if (l.lazy_input)
+				{
+					confidence = l.new_coords ? l.lazy_input[class_index] : logistic_activate(l.lazy_input[class_index]);
+				}
+				const float prob = objectness * confidence;
+				dets[count].prob[j] = (prob > thresh) ? prob : 0.0f;
+			}
+			++count;
 		}
 
-		for (int j = 0; j < l.classes; ++j)
-		{
-			const int class_index = yolo_entry_index(l, 0, n * l.w * l.h + i, 4 + 1 + j);
-			const float prob = objectness * predictions[class_index];
-			dets[count].prob[j] = (prob > thresh) ? prob : 0.0f;
-		}
-		++count;
+		begin = end;
 	}
 
 	correct_yolo_boxes(dets, count, w, h, netw, neth, relative, letter);
@@ -1546,13 +1825,16 @@ Darknet::MMats Darknet::create_yolo_heatmaps(Darknet::NetworkPtr ptr, const floa
 	// look through all the layers to find the YOLO ones
 	for (int layer_index = 0; layer_index < net->n; layer_index ++)
 	{
-		const Darknet::Layer & l = net->layers[layer_index];
+		Darknet::Layer & l = net->layers[layer_index];
 		if (l.type != Darknet::ELayerType::YOLO)
 		{
 			// not YOLO...keep looking for another layer
 			continue;
 		}
 
+		// the heatmaps need every class of every cell, not just the ones with an object
+		finish_lazy_yolo_output(l);
+
 //		Darknet::dump(l);
 
 		for (int n = 0; n < l.n; ++n) // anchors?
@@ -6,8 +6,26 @@ Darknet::Layer make_yolo_layer(int batch, int w, int h, int n, int total, int *m
 void forward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state);
 void backward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state);
 void resize_yolo_layer(Darknet::Layer *l, int w, int h);
+
+/** When @ref Darknet::NetworkDetails::lazy_yolo_output is set, @ref forward_yolo_layer() only activates the objectness,
+ * and the rest of the output is decoded on demand by @ref get_yolo_detections_v3() for the few cells with an object.  Code which needs the complete output of a
+ * @p [yolo] layer must first call this to copy and activate everything else.  Does nothing if the output is complete.
+ *
+ * @since 2026-10-17
+ */
+void finish_lazy_yolo_output(Darknet::Layer & l);
+
 int yolo_num_detections(const Darknet::Layer & l, float thresh);
 int yolo_num_detections_batch(const Darknet::Layer & l, float thresh, int batch);
+
+/** Write the index (plus @p offset) of every value in @p plane which is greater than @p thresh into @p indexes, which
+ * must have room for @p size entries.  Uses AVX or SSE when available.  @returns the number of indexes written.
+ * @see @ref yolo_num_detections_v3()
+ */
+int yolo_compact_objectness(const float * plane, const int size, const float thresh, int * indexes, const int offset);
+
+/// Same as @ref yolo_compact_objectness() but without SIMD.  Mostly used to benchmark and verify the SIMD version.
+int yolo_compact_objectness_scalar(const float * plane, const int size, const float thresh, int * indexes, const int offset);
 int get_yolo_detections(const Darknet::Layer & l, int w, int h, int netw, int neth, float thresh, int *map, int relative, Darknet::Detection *dets, int letter);
 int get_yolo_detections_batch(const Darknet::Layer & l, int w, int h, int netw, int neth, float thresh, int *map, int relative, Darknet::Detection *dets, int letter, int batch);
 void correct_yolo_boxes(Darknet::Detection *dets, int n, int w, int h, int netw, int neth, int relative, int letter);
@@ -338,7 +338,7 @@ std::vector<bbox_t> Detector::detect(image_t img, float thresh, bool use_mean)
 	int letterbox = 0;
 	float hier_thresh = 0.5;
 	Darknet::Detection * dets = get_network_boxes(&net, im.w, im.h, thresh, hier_thresh, 0, 1, &nboxes, letterbox);
-	if (nms) do_nms_sort(dets, nboxes, l.classes, nms);
+	if (nms) do_nms_fused(dets, nboxes, l.classes, nms, DEFAULT_NMS, 0.0f);
 
 	std::vector<bbox_t> bbox_vec;
 
@@ -415,7 +415,7 @@ std::vector<std::vector<bbox_t>> Detector::detectBatch(image_t img, int batch_si
 		auto dets = prediction[bi].dets;
 
 		if (make_nms && nms)
-			do_nms_sort(dets, prediction[bi].num, l.classes, nms);
+			do_nms_fused(dets, prediction[bi].num, l.classes, nms, DEFAULT_NMS, 0.0f);
 
 		for (int i = 0; i < prediction[bi].num; ++i)
 		{